@@ -81,6 +81,16 @@ class internalStorageComponent : public configComponent
 	 */
 	uint32_t getMeasurementPeriod();
 
+	/**
+	 * @brief Sampling period of a channel, in milliseconds, 0 if the channel is sampled once per measurement period
+	 */
+	uint32_t getChannelPeriod(uint8_t channel);
+
+	/**
+	 * @brief Fastest sampling period of a channel, in milliseconds, 0 if the channel is sampled at a fixed rate
+	 */
+	uint32_t getChannelFastestPeriod(uint8_t channel);
+
 	/**
 	 * @brief 
 	 */
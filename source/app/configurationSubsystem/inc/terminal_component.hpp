@@ -59,6 +59,7 @@ enum class terminalState
 	sensorConfig,	   ///< State for configuring sensors.
 	networkConfig,	   ///< State for configuring network settings.
 	streamADC,
+	storageStats, ///< State for displaying the storage I/O counters.
 
 	numStates ///< Number of states (used for validation or iteration).
 };
@@ -81,6 +82,8 @@ enum class terminalSignal
 	pressedKey_S,
 	pressedKey_F,
 	pressedKey_M,
+	pressedKey_D, ///< Signal triggered when the 'D' key is pressed.
+	pressedKey_R, ///< Signal triggered when the 'R' key is pressed.
 	pressedKey_Enter,
 	streamData,
 	NONE,
@@ -39,13 +39,13 @@
 /** @brief Filesystem wrapper instance. The implementation is selected at compile time. */
 #ifdef TARGET_MICRO
 // Use microcontroller-specific file system
-fileSysWrapper fileSystem(1);
+fileSysWrapper fileSystem(1, ioTag_t::METADATA);
 /** @brief Path to the metadata file on the target device. */
 static constexpr char* metadataPath = "metadata.txt";
 #else
 
 /** @brief Filesystem wrapper instance for host-based execution (testing/simulation). */
-fileSysWrapper fileSystem(0); // Use the non-microcontroller implementation
+fileSysWrapper fileSystem(0, ioTag_t::METADATA); // Use the non-microcontroller implementation
 /** @brief Path to the folder containing test files on the host. */
 std::string testFolderPath = "";
 #endif
@@ -202,6 +202,38 @@ uint32_t internalStorageComponent::getMeasurementPeriod()
 	return (this->_metadata->generalMeasurementPeriod) * (utilities::MS_IN_ONE_MINUTE);
 }
 
+/**
+ * @brief Gets the sampling period of a channel from the metadata.
+ *
+ * @param channel index of the channel in the measurement records.
+ * @return uint32_t The sampling period in milliseconds, 0 for channels without one.
+ */
+uint32_t internalStorageComponent::getChannelPeriod(uint8_t channel)
+{
+	if (channel >= MAX_SAMPLED_CHANNELS)
+	{
+		return 0;
+	}
+
+	return (this->_metadata->channelSamplingPeriods[channel]) * (utilities::MS_IN_ONE_SECOND);
+}
+
+/**
+ * @brief Gets the fastest sampling period of an adaptive channel from the metadata.
+ *
+ * @param channel index of the channel in the measurement records.
+ * @return uint32_t The fastest period in milliseconds, 0 for channels sampled at a fixed rate.
+ */
+uint32_t internalStorageComponent::getChannelFastestPeriod(uint8_t channel)
+{
+	if (channel >= MAX_SAMPLED_CHANNELS)
+	{
+		return 0;
+	}
+
+	return (this->_metadata->channelFastestPeriods[channel]) * (utilities::MS_IN_ONE_SECOND);
+}
+
 /**
  * @brief Gets the metadata updated flag and resets it.
  *
@@ -248,16 +280,23 @@ bool internalStorageComponent::_parseMetadataBuffer(char* buffer, loggerMetadata
 				metadata->fileCreationPeriod = static_cast<uint8_t>(std::strtoul(token, nullptr, 10));
 				break;
 			case 2: // fileTransmissionPeriod
-				metadata->fileTransmissionPeriod = static_cast<uint8_t>(std::strtoul(token, nullptr, 10));
+				metadata->fileTransmissionPeriod = static_cast<uint16_t>(std::strtoul(token, nullptr, 10));
 				break;
 			case 3: // generalMeasurementPeriod
-				metadata->generalMeasurementPeriod = static_cast<uint8_t>(std::strtoul(token, nullptr, 10));
+				metadata->generalMeasurementPeriod = static_cast<uint16_t>(std::strtoul(token, nullptr, 10));
 				break;
 			case 4: // restRequestPeriod
-				metadata->restRequestPeriod = static_cast<uint8_t>(std::strtoul(token, nullptr, 10));
+				metadata->restRequestPeriod = static_cast<uint16_t>(std::strtoul(token, nullptr, 10));
 				break;
-			default:
-				// Ignore extra fields
+			default: // channelSamplingPeriods then channelFastestPeriods, extra fields are ignored
+				if (fieldIndex - 5 < MAX_SAMPLED_CHANNELS)
+				{
+					metadata->channelSamplingPeriods[fieldIndex - 5] = static_cast<uint16_t>(std::strtoul(token, nullptr, 10));
+				}
+				else if (fieldIndex - 5 - MAX_SAMPLED_CHANNELS < MAX_SAMPLED_CHANNELS)
+				{
+					metadata->channelFastestPeriods[fieldIndex - 5 - MAX_SAMPLED_CHANNELS] = static_cast<uint16_t>(std::strtoul(token, nullptr, 10));
+				}
 				break;
 		}
 
@@ -16,7 +16,9 @@
 
 #include "terminal_component.hpp"
 #include "device_version.hpp"
+#include "ioAccounting.hpp"
 #include "loggerMetadata.hpp"
+#include "record_writer.hpp"
 #include "utilities.hpp"
 #include "virtualTimer.hpp"
 #include <charconv>
@@ -25,6 +27,23 @@
 #include <span>
 #include <system_error>
 
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+static constexpr size_t UINT8_DIGITS  = 3;
+static constexpr size_t UINT16_DIGITS = 5;
+
+/**
+ * @brief Longest metadata line stored by the S key, each field at its widest
+ *
+ * Name, file creation period, three periods in minutes and two periods per sampled channel,
+ * separated by ';', followed by "\r\n" and the null terminator.
+ */
+static constexpr size_t METADATA_LINE_SIZE = (loggerNameLenght - 1) + (1 + UINT8_DIGITS) + 3 * (1 + UINT16_DIGITS) + 2 * MAX_SAMPLED_CHANNELS * (1 + UINT16_DIGITS) + 2 + 1;
+
+static_assert(METADATA_LINE_SIZE <= METADATA_BUFFER_SIZE, "The internal storage reads the metadata line into METADATA_BUFFER_SIZE bytes");
+
 ////////////////////////////////////////////////////////////////////////
 //				      Private function prototypes
 ////////////////////////////////////////////////////////////////////////
@@ -153,6 +172,12 @@ terminalEvent terminalStateMachine::signalDispacher(terminalState state, termina
 					event			  = terminalEvent::EVENT_TRANSITION;
 				}
 				break;
+				case terminalSignal::pressedKey_D:
+				{
+					this->activeState = terminalState::storageStats;
+					event			  = terminalEvent::EVENT_TRANSITION;
+				}
+				break;
 				default:
 				{
 					event = terminalEvent::EVENT_IGNORED;
@@ -183,11 +208,23 @@ terminalEvent terminalStateMachine::signalDispacher(terminalState state, termina
 					if (systick::getTicks() - _ticks > 1000)
 					{
 						//count++;
-						float	voltage		= _sensorService.requestADCVoltage();
-						float	temperature = _sensorService.requestTemperature();
-						uint8_t humidity	= _sensorService.requestHumidity();
+						float				   voltage			   = _sensorService.requestADCVoltage();
+						std::optional<float>   temperature		   = _sensorService.requestTemperature();
+						std::optional<uint8_t> humidity			   = _sensorService.requestHumidity();
+						char				   temperatureBuff[16] = "--"; // A channel never read shows as "--"
+						char				   humidityBuff[8]	   = "--";
 
-						printf("ADC Voltage: %f | Temperature: %f | Humidity: %d\r\n", voltage, temperature, humidity);
+						if (true == temperature.has_value())
+						{
+							recordWriter(temperatureBuff).appendFixed(*temperature, 2).finish();
+						}
+
+						if (true == humidity.has_value())
+						{
+							recordWriter(humidityBuff).appendUnsigned(*humidity).finish();
+						}
+
+						printf("ADC Voltage: %f | Temperature: %s | Humidity: %s\r\n", voltage, temperatureBuff, humidityBuff);
 						printf("\033[A\033[2K");
 						this->_flagStreamDelay = false;
 					}
@@ -216,6 +253,46 @@ terminalEvent terminalStateMachine::signalDispacher(terminalState state, termina
 			}
 		}
 		break;
+		case terminalState::storageStats:
+		{
+			switch (sig)
+			{
+				case terminalSignal::ENTRY:
+				{
+					ioAccounting::printReport();
+					printf("R - reset counters\r\n");
+					printf("B - return\r\n");
+					event = terminalEvent::EVENT_HANDLED;
+				}
+				break;
+				case terminalSignal::EXIT:
+				{
+					// Clean Terminal
+					printf("\033[2J\033[H"); // ANSI escape sequence to clear the screen and reset cursor to top-left
+					event = terminalEvent::EVENT_HANDLED;
+				}
+				break;
+				case terminalSignal::pressedKey_R:
+				{
+					ioAccounting::reset();
+					printf("Storage I/O counters cleared\r\n");
+					event = terminalEvent::EVENT_HANDLED;
+				}
+				break;
+				case terminalSignal::pressedKey_B:
+				{
+					this->activeState = terminalState::initState;
+					event			  = terminalEvent::EVENT_TRANSITION;
+				}
+				break;
+				default:
+				{
+					event = terminalEvent::EVENT_IGNORED;
+				}
+				break;
+			}
+		}
+		break;
 		case terminalState::basicDeviceInfo:
 		{
 			switch (sig)
@@ -422,19 +499,47 @@ terminalEvent terminalStateMachine::signalDispacher(terminalState state, termina
 				case terminalSignal::pressedKey_S:
 				{
 					printf("Storing configuratoin in memory..\r\n");
-					std::array<char, sizeof(loggerMetadata)> buffMetadata{};
+					std::array<char, METADATA_LINE_SIZE> buffMetadata{};
+					size_t								 len  = 0;
+					bool								 fits = true;
+
+					// A field that does not fit invalidates the line, a truncated line would corrupt the stored metadata
+					auto appended = [&buffMetadata, &len, &fits](int written)
+					{
+						fits = fits && written >= 0 && static_cast<size_t>(written) < buffMetadata.size() - len;
+						len	 = (true == fits) ? len + static_cast<size_t>(written) : len;
+					};
 
 					// clang-format off
-					snprintf(buffMetadata.data(),
-							 buffMetadata.size(),
-							 "%s;%d;%d;%d;%d\r\n",
-							 _loggerMetadata->loggerName,
-							 _loggerMetadata->fileCreationPeriod,
-							 _loggerMetadata->fileTransmissionPeriod,
-							 _loggerMetadata->generalMeasurementPeriod,
-							 _loggerMetadata->restRequestPeriod);
+					appended(snprintf(buffMetadata.data(),
+									  buffMetadata.size(),
+									  "%s;%d;%d;%d;%d",
+									  _loggerMetadata->loggerName,
+									  _loggerMetadata->fileCreationPeriod,
+									  _loggerMetadata->fileTransmissionPeriod,
+									  _loggerMetadata->generalMeasurementPeriod,
+									  _loggerMetadata->restRequestPeriod));
 					// clang-format on
 
+					for (uint8_t channel = 0; channel < MAX_SAMPLED_CHANNELS; channel++)
+					{
+						appended(snprintf(buffMetadata.data() + len, buffMetadata.size() - len, ";%u", _loggerMetadata->channelSamplingPeriods[channel]));
+					}
+
+					for (uint8_t channel = 0; channel < MAX_SAMPLED_CHANNELS; channel++)
+					{
+						appended(snprintf(buffMetadata.data() + len, buffMetadata.size() - len, ";%u", _loggerMetadata->channelFastestPeriods[channel]));
+					}
+
+					appended(snprintf(buffMetadata.data() + len, buffMetadata.size() - len, "\r\n"));
+
+					if (false == fits)
+					{
+						printf("Error: configuration does not fit in %u bytes, not stored\r\n", static_cast<unsigned>(buffMetadata.size()));
+						event = terminalEvent::EVENT_HANDLED;
+						break;
+					}
+
 					std::span<char> buffMetadataSpan(buffMetadata.data(), buffMetadata.size());
 
 					// Signal mediator to comunicate with internal storage component
@@ -492,20 +597,38 @@ void terminalStateMachine::printBanner()
 
 void terminalStateMachine::printLoggerMetadata()
 {
-	char timBuff[9];
-	char dateBuff[15];
+	char		timBuff[TIME_BUFF_SIZE];
+	char		dateBuff[DATE_BUFF_SIZE];
+	char		epochBuff[21]; // Up to 20 digits, newlib nano printf has no %llu
+	uint64_t	epochMs	 = _terminalRTC.getEpochMs();
+	rtcDateTime dateTime = rtcCalendar::fromEpochMs(epochMs);
 
-	_terminalRTC.getTime(&timBuff[0], sizeof(timBuff));
-	_terminalRTC.getDate(&dateBuff[0], sizeof(dateBuff));
+	recordWriter(timBuff).appendTime(dateTime.hour, dateTime.minute, dateTime.seconds).finish();
+	recordWriter(dateBuff).appendDate(dateTime.day, dateTime.month, dateTime.year).finish();
+	recordWriter(epochBuff).appendUnsigned64(epochMs).finish();
 
 	printf("#############################\r\n");
 	printf("Device name: %s\r\n", _loggerMetadata->loggerName);
 	printf("Device time: %s\r\n", timBuff);
 	printf("Device date: %s\r\n", dateBuff);
+	printf("Device epoch: %s ms\r\n", epochBuff);
+	printf("RTC drift: %ld ppm\r\n", static_cast<long>(_terminalRTC.getDriftPpm()));
 	printf("File creation period: %c\r\n", _loggerMetadata->fileCreationPeriod);
 	printf("File transmission period: %u\r\n", _loggerMetadata->fileTransmissionPeriod);
 	printf("Measurement period: %u\r\n", _loggerMetadata->generalMeasurementPeriod);
 	printf("HTTP POST period: %u\r\n", _loggerMetadata->restRequestPeriod);
+	printf("Channel sampling periods (s):");
+	for (uint8_t channel = 0; channel < MAX_SAMPLED_CHANNELS; channel++)
+	{
+		printf(" %u", _loggerMetadata->channelSamplingPeriods[channel]);
+	}
+	printf("\r\n");
+	printf("Channel fastest periods (s):");
+	for (uint8_t channel = 0; channel < MAX_SAMPLED_CHANNELS; channel++)
+	{
+		printf(" %u", _loggerMetadata->channelFastestPeriods[channel]);
+	}
+	printf("\r\n");
 	printf("Firmware version: %c.%c.%c.%s\r\n", MAJOR, MINOR, PATCH, DEVELOPMENT);
 	printf("B - return\r\n");
 	printf("#############################\r\n");
@@ -523,6 +646,7 @@ static void printHelp()
 	printf("I - Print Device Info\r\n");
 	printf("C - Configure Device\r\n");
 	printf("S - Stream RAW measured data\r\n");
+	printf("D - Display storage I/O statistics\r\n");
 	printf("#############################\r\n");
 }
 
@@ -9,6 +9,8 @@
  Device current file transmission period (for ftp servers)
  Device last computed line period (for https servers) 
    (computed line is the text that is generated after all sensors data is aquired and contains all the data)
+ Sampling period of each measured channel, in record order
+ Fastest sampling period of each measured channel, for channels sampled faster while they change
 
  * @version 0.1
  * @date 2025-01-24
@@ -33,6 +35,7 @@
 
 constexpr uint16_t METADATA_BUFFER_SIZE = 256;
 constexpr uint16_t loggerNameLenght		= 96;
+constexpr uint8_t  MAX_SAMPLED_CHANNELS = 8;
 
 namespace loggerMetadataConstants
 {
@@ -61,6 +64,8 @@ struct loggerMetadata
 	char	 pIP[16]	  = {'\0'};
 	char	 pNetmask[16] = {'\0'};
 	char	 pGateway[16] = {'\0'};
+	uint16_t channelSamplingPeriods[MAX_SAMPLED_CHANNELS] = {0}; // Period (seconds) for sampling each channel, 0 to sample it once per measurement period
+	uint16_t channelFastestPeriods[MAX_SAMPLED_CHANNELS]  = {0}; // Shortest period (seconds) of a channel sampled faster while it changes, 0 for a fixed rate
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -18,6 +18,9 @@
 
 #include "loggerMetadata.hpp"
 #include "processing_manager.hpp"
+#include "storage_mirror.hpp"
+
+constexpr uint32_t LOGGER_FLUSH_PERIOD_MS = 5 * 60 * 1000; // Longest time a record waits in the write chunk in external only mode
 
 /**
  * @brief Creation periods of measurement files
@@ -31,6 +34,15 @@ enum class fileGenerationConf_t
 	ONE_FILE
 };
 
+/**
+ * @brief Where records are stored
+ */
+enum class storageMode_t
+{
+	EXTERNAL_ONLY, /// Records are buffered and appended to the SD card a write chunk at a time
+	MIRRORED	   /// Records are committed to internal flash and replicated to the SD card, see @ref storageMirror
+};
+
 class loggerManager : public observerInterface
 {
   public:
@@ -60,16 +72,98 @@ class loggerManager : public observerInterface
 
 	void setMailBox(const char* pDataBuff);
 
+	/**
+	 * @brief Sets the header written at the start of every new log file, e.g. the record schema
+	 *
+	 * @param pHeader null terminated header, nullptr for none
+	 */
+	void setHeader(const char* pHeader);
+
+	/**
+	 * @brief Selects where records are stored, must be called before init()
+	 */
+	void setStorageMode(storageMode_t mode);
+
+	/**
+	 * @brief Moves pending records to the external storage
+	 *
+	 * Meant to be called on every superloop iteration. In mirrored mode each call copies at
+	 * most one batch of the journal, in external only mode a partial write chunk is written
+	 * once its oldest record waited @ref LOGGER_FLUSH_PERIOD_MS, unless force is set.
+	 *
+	 * @param force write every pending record now
+	 * @return true if nothing is pending or the records were written
+	 */
+	bool replicationHandler(bool force = false);
+
+	/**
+	 * @brief Writes the records buffered in external only mode to the log file now
+	 *
+	 * @return true if nothing was buffered or the records were written
+	 */
+	bool flush();
+
+	/**
+	 * @brief Bytes stored that are not yet in the external storage
+	 *
+	 * Committed to the journal in mirrored mode, buffered in the write chunk otherwise.
+	 */
+	uint32_t getPendingReplicationBytes();
+
+	/**
+	 * @brief Write chunk size calibrated for the external storage
+	 *
+	 * The journal is replicated, or the buffered records written, in chunks of this size.
+	 *
+	 * @return chunk size in bytes
+	 */
+	uint16_t getWriteChunkSize();
+
+	/**
+	 * @brief Records dropped in mirrored mode because the journal was full
+	 *
+	 * @return dropped records since init(), 0 when not in mirrored mode
+	 */
+	uint32_t getDroppedRecords();
+
   private:
 	void _fileManagement(uint8_t confNum);
 
+	/**
+	 * @brief Makes sure the log file is open for appending.
+	 *
+	 * The file is kept open between records and flushed with sync(), so appends
+	 * do not pay for a directory lookup and a FAT chain walk every time.
+	 * A newly created file gets space reserved for the expected records.
+	 *
+	 * @param recordLen Length of the record about to be written, used to size the reservation.
+	 * @return true if the file is open, false otherwise.
+	 */
+	bool _openLogFile(size_t recordLen);
+
+	/**
+	 * @brief Expected size of a log file holding one day of records.
+	 */
+	uint32_t _expectedFileSize(size_t recordLen);
+
 #ifdef TARGET_MICRO
 	std::array<char, 256> _fileName{'\0'};
+	std::array<char, 256> _journalName{'\0'};
+	std::array<char, 256> _cursorName{'\0'};
 #endif
 	uint16_t			   _infoDataLen;
 	struct loggerMetadata* _metadata;
 	bool				   _availableData = false;
+	bool				   _fileOpen	  = false;
+	storageMode_t		   _storageMode	  = storageMode_t::EXTERNAL_ONLY;
 	const char*			   _pPath		  = nullptr;
 
+	// Records waiting for a full write chunk, external only mode
+	std::array<char, MIRROR_BATCH_SIZE> _chunkBuff;
+	size_t								_chunkLen	  = 0;
+	size_t								_recordLen	  = 0; /// Length of the last record, sizes the file preallocation
+	uint64_t							_chunkStartMs = 0; /// When the first buffered record arrived
+
 	const char* _pDataBuff = nullptr; /// Pointer to the buffer that has the sensors measurements and time measurements were taken
+	const char* _pHeader   = nullptr; /// Written when a log file is created
 };
\ No newline at end of file
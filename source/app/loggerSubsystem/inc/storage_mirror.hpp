@@ -0,0 +1,185 @@
+/**
+ * @file storage_mirror.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Mirrored storage, records are committed to internal flash and replicated to the SD card
+
+ The logger owns two storage backends, LittleFS on the internal W25Q64 flash and FatFS on the
+ SD card. In mirrored mode every record is first appended to a journal file in internal flash,
+ which is fast and always present. Journal contents are later copied in large batches to the
+ log file on the SD card.
+
+ The journal offset that has already been replicated (the cursor) is persisted in its own file,
+ so replication resumes where it stopped after a reset, a removed card or a failed write.
+ Once everything is replicated and the journal is large enough, it is truncated. While the external
+ storage is missing nothing is replicated, so the journal is capped at @ref MIRROR_JOURNAL_MAX_SIZE:
+ a full journal drops the new records, keeping the oldest unreplicated ones, and counts them until
+ replication makes room again.
+
+ Replication is at-least-once: if a batch fails midway, the whole batch is sent again.
+
+ The batch size is the write chunk used on the external storage. The best chunk differs
+ between cards, so every time the external storage is mounted the mirror looks for a
+ calibration file on it; if there is none, it writes the same amount of data to a scratch
+ file with each candidate chunk size, keeps the fastest and stores it in the calibration
+ file. A card that was already calibrated is not benchmarked again, a new card is. The
+ calibration runs in every storage mode, without the mirror the logger buffers records
+ and writes them with the same chunk.
+
+ * @version 0.1
+ * @date 2025-04-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "filesystemWrapper.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint16_t MIRROR_BATCH_SIZE		   = 2048;		  // Largest number of bytes copied to the external storage per batch
+constexpr uint32_t MIRROR_FLUSH_PERIOD_MS	   = 600000;	  // Partial batches are replicated after this time
+constexpr uint32_t MIRROR_RETRY_PERIOD_MS	   = 5000;		  // Time between attempts to reach a missing external storage
+constexpr uint32_t MIRROR_JOURNAL_COMPACT_SIZE = 64 * 1024;	  // Fully replicated journals above this size are truncated
+constexpr uint32_t MIRROR_JOURNAL_MAX_SIZE	   = 1024 * 1024; // Records that would grow the journal above this size are dropped
+
+static_assert(MIRROR_JOURNAL_MAX_SIZE >= MIRROR_JOURNAL_COMPACT_SIZE, "A full journal must be compacted once replicated");
+
+constexpr std::array<uint16_t, 3> MIRROR_CHUNK_CANDIDATES		= {512, 1024, MIRROR_BATCH_SIZE}; // Write chunk sizes tried by the calibration
+constexpr uint32_t				  MIRROR_CALIBRATION_BYTES		= 8 * 1024;						  // Bytes written with each candidate
+constexpr uint8_t				  MIRROR_CALIBRATION_MARGIN_PCT = 10;							  // A smaller chunk must be this much faster to be picked
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+class storageMirror
+{
+  public:
+	/**
+	 * @brief Construct a new storage Mirror object
+	 *
+	 * @param internalFs filesystem holding the journal and the replication cursor
+	 * @param externalFs filesystem holding the replicated log file
+	 */
+	storageMirror(fileSysWrapper& internalFs, fileSysWrapper& externalFs);
+
+	/**
+	 * @brief Sets the file paths and restores the journal size and the persisted cursor
+	 *
+	 * @param pJournalPath path of the journal in the internal storage
+	 * @param pCursorPath path of the cursor file in the internal storage
+	 * @param pExternalPath path of the log file in the external storage
+	 * @return true if the state was restored
+	 * @return false if the cursor file could not be written
+	 */
+	bool init(const char* pJournalPath, const char* pCursorPath, const char* pExternalPath);
+
+	/**
+	 * @brief Selects the write chunk size of the mounted external storage
+	 *
+	 * The size is loaded from the calibration file, or benchmarked and stored if the file is
+	 * missing or invalid, then reported to the I/O accounting. A remount in replicate()
+	 * calibrates again with the same paths.
+	 *
+	 * @param pCalibrationPath path of the file holding the write chunk size in the external storage
+	 * @param pScratchPath path of the file used to benchmark the external storage
+	 */
+	void calibrate(const char* pCalibrationPath, const char* pScratchPath);
+
+	/**
+	 * @brief Appends a record to the journal, the record is durable when this returns true
+	 *
+	 * @param pRecord record to store
+	 * @param len length of the record
+	 * @return true if the record was fully written
+	 * @return false if it failed or was dropped because the journal is full
+	 */
+	bool commit(const char* pRecord, size_t len);
+
+	/**
+	 * @brief Copies pending journal data to the external storage
+	 *
+	 * Without force, one batch is copied when a full batch is pending or when
+	 * @ref MIRROR_FLUSH_PERIOD_MS elapsed since the last replication, which keeps the
+	 * time spent per call bounded. With force, all pending data is copied.
+	 *
+	 * @param force replicate everything now
+	 * @return true if nothing failed, false if the external storage is not reachable
+	 */
+	bool replicate(bool force = false);
+
+	/**
+	 * @brief Sets the text written at the start of the log file when replication creates it
+	 *
+	 * @param pHeader null terminated header, nullptr for none
+	 */
+	void setHeader(const char* pHeader);
+
+	/**
+	 * @brief Bytes committed to the journal that are not yet in the external storage
+	 */
+	uint32_t getPendingBytes() const;
+
+	/**
+	 * @brief Write chunk size selected for the external storage
+	 */
+	uint16_t getWriteChunkSize() const;
+
+	/**
+	 * @brief Records dropped since init() because the journal was full
+	 */
+	uint32_t getDroppedRecords() const;
+
+  private:
+	fileSysWrapper& _internalFs;
+	fileSysWrapper& _externalFs;
+	const char*		_pJournalPath	  = nullptr;
+	const char*		_pCursorPath	  = nullptr;
+	const char*		_pExternalPath	  = nullptr;
+	const char*		_pCalibrationPath = nullptr;
+	const char*		_pScratchPath	  = nullptr;
+	const char*		_pHeader		  = nullptr;
+
+	uint32_t _journalSize	  = 0; /// Bytes in the journal
+	uint32_t _cursor		  = 0; /// Journal offset up to which data is replicated
+	uint32_t _droppedRecords  = 0;
+	bool	 _externalReady	  = true;
+	uint64_t _lastReplication = 0;
+	uint64_t _lastAttempt	  = 0;
+	uint16_t _writeChunkSize  = MIRROR_BATCH_SIZE; /// Bytes replicated per batch, see @ref _calibrateExternal
+
+	std::array<char, MIRROR_BATCH_SIZE> _batchBuff;
+
+	bool _replicateBatch();
+	bool _loadCursor();
+	bool _storeCursor();
+	bool _compactJournal();
+
+	/**
+	 * @brief Selects the write chunk size of the external storage and reports it
+	 */
+	void _calibrateExternal();
+
+	/**
+	 * @brief Loads the write chunk size of the external storage, benchmarking it if it was never calibrated
+	 */
+	uint16_t _selectWriteChunk();
+
+	/**
+	 * @brief Time spent writing @ref MIRROR_CALIBRATION_BYTES to the scratch file with the given chunk size
+	 *
+	 * @return elapsed time in ms, negative if the external storage failed
+	 */
+	int32_t _benchmarkChunk(uint16_t chunkSize);
+};
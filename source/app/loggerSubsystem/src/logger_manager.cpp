@@ -2,12 +2,15 @@
 #include "debug_log.hpp"
 #include "filesystemWrapper.hpp"
 #include "loggerMetadata.hpp"
+#include "storage_mirror.hpp"
+#include "utilities.hpp"
+#include "virtualTimer.hpp"
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 
 #ifndef TARGET_MICRO
-#include "utilities.hpp"
 #include <string>
 #endif
 
@@ -16,12 +19,23 @@
  */
 #ifdef TARGET_MICRO
 // Use microcontroller-specific file system
-fileSysWrapper fsHandler(2);
+fileSysWrapper fsHandler(2, ioTag_t::LOGGER);
+fileSysWrapper internalFsHandler(1, ioTag_t::LOGGER);
+static constexpr const char* calibrationPath = "chunk.cal";
+static constexpr const char* scratchPath	 = "chunk.tmp";
 #else
-fileSysWrapper fsHandler(0);
-std::string	   testFolderPath_External = "";
+fileSysWrapper fsHandler(0, ioTag_t::LOGGER);
+fileSysWrapper internalFsHandler(0, ioTag_t::LOGGER);
+std::string	   testFolderPath_External	  = "";
+std::string	   testFolderPath_Journal	  = "";
+std::string	   testFolderPath_Cursor	  = "";
+std::string	   testFolderPath_Calibration = "";
+std::string	   testFolderPath_Scratch	  = "";
 #endif
 
+/** @brief Journal in internal flash replicated to the external storage, used in mirrored mode. */
+storageMirror loggerMirror(internalFsHandler, fsHandler);
+
 void loggerManager::update()
 {
 	this->_availableData = true;
@@ -32,23 +46,70 @@ bool loggerManager::init()
 	// Check configuration
 	_metadata = getLoggerMetadata();
 
+	// The file name may have changed, buffered records go to the old one and the next record reopens it
+	flush();
+
+	if (true == this->_fileOpen)
+	{
+		fsHandler.close();
+		this->_fileOpen = false;
+	}
+
 #ifdef TARGET_MICRO
 	snprintf(_fileName.data(), _fileName.size(), "%s.txt", _metadata->loggerName);
+	snprintf(_journalName.data(), _journalName.size(), "%s.jnl", _metadata->loggerName);
+	snprintf(_cursorName.data(), _cursorName.size(), "%s.cur", _metadata->loggerName);
 	this->_pPath = _fileName.data();
 	if (fsHandler.mount() != true)
 	{
 		return false;
 	}
 #else
-	testFolderPath_External = utilities::getPathMetadata(_metadata->loggerName);
-	this->_pPath			= testFolderPath_External.c_str();
+	testFolderPath_External	   = utilities::getPathMetadata(_metadata->loggerName);
+	testFolderPath_Journal	   = utilities::getPathMetadata(std::string(_metadata->loggerName) + ".jnl");
+	testFolderPath_Cursor	   = utilities::getPathMetadata(std::string(_metadata->loggerName) + ".cur");
+	testFolderPath_Calibration = utilities::getPathMetadata("chunk.cal");
+	testFolderPath_Scratch	   = utilities::getPathMetadata("chunk.tmp");
+	this->_pPath			   = testFolderPath_External.c_str();
+#endif
+
+	// Every storage mode writes the external storage in calibrated chunks
+#ifdef TARGET_MICRO
+	loggerMirror.calibrate(calibrationPath, scratchPath);
+#else
+	loggerMirror.calibrate(testFolderPath_Calibration.c_str(), testFolderPath_Scratch.c_str());
+#endif
+
+	if (storageMode_t::MIRRORED == this->_storageMode)
+	{
+		if (internalFsHandler.mount() != true)
+		{
+			return false;
+		}
+
+#ifdef TARGET_MICRO
+		return loggerMirror.init(_journalName.data(), _cursorName.data(), this->_pPath);
+#else
+		return loggerMirror.init(testFolderPath_Journal.c_str(), testFolderPath_Cursor.c_str(), this->_pPath);
 #endif
+	}
 
 	return true;
 }
 
 void loggerManager::handler()
 {
+	if (storageMode_t::MIRRORED == this->_storageMode)
+	{
+		// Records only touch internal flash here, replicationHandler() moves them to the external storage
+		if (false == loggerMirror.commit(this->_pDataBuff, std::strlen(this->_pDataBuff)))
+		{
+			debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: unable to commit data to journal\r\n");
+		}
+
+		return;
+	}
+
 	switch (_metadata->fileCreationPeriod)
 	{
 		default:
@@ -57,36 +118,30 @@ void loggerManager::handler()
 			// clang-format on
 		case loggerMetadataConstants::CREATE_ONLY_ONE_FILE:
 		{
-			// Append data
-			size_t len = std::strlen(this->_pDataBuff);
+			// Buffer the record, the file is only written a full chunk at a time
+			const char* pRecord	  = this->_pDataBuff;
+			size_t		len		  = std::strlen(pRecord);
+			size_t		chunkSize = getWriteChunkSize();
 
-			if (true == fsHandler.open(this->_pPath, 2))
-			{
-				debug::log<true, debug::logLevel::LOG_ALL>("LoggerManager: appending data to file\r\n");
-
-				if (len != fsHandler.write(this->_pDataBuff, len))
-				{
-					debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: unable to append data to file \r\n");
-				}
+			this->_recordLen = len;
 
-				fsHandler.close();
+			if (0 == this->_chunkLen)
+			{
+				this->_chunkStartMs = systick::getTicks();
 			}
-			else
+
+			while (len > 0)
 			{
-				debug::log<true, debug::logLevel::LOG_ALL>("LoggerManager: creating file\r\n");
+				size_t copied = std::min(len, chunkSize - this->_chunkLen);
 
-				if (true == fsHandler.open(this->_pPath, 1))
-				{
-					if (len != fsHandler.write(this->_pDataBuff, len))
-					{
-						debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: unable to write data to file \r\n");
-					}
+				std::memcpy(&this->_chunkBuff[this->_chunkLen], pRecord, copied);
+				this->_chunkLen += copied;
+				pRecord			+= copied;
+				len				-= copied;
 
-					fsHandler.close();
-				}
-				else
+				if (this->_chunkLen >= chunkSize)
 				{
-					debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: file could not be opened or created\r\n");
+					flush();
 				}
 			}
 		}
@@ -110,4 +165,156 @@ bool loggerManager::getAvailableDataFlag()
 void loggerManager::setMailBox(const char* pDataBuff)
 {
 	this->_pDataBuff = pDataBuff;
+}
+
+void loggerManager::setHeader(const char* pHeader)
+{
+	this->_pHeader = pHeader;
+	loggerMirror.setHeader(pHeader);
+}
+
+void loggerManager::setStorageMode(storageMode_t mode)
+{
+	// The mirror opens the external log file on its own
+	flush();
+
+	if (true == this->_fileOpen)
+	{
+		fsHandler.close();
+		this->_fileOpen = false;
+	}
+
+	this->_storageMode = mode;
+}
+
+bool loggerManager::replicationHandler(bool force)
+{
+	if (storageMode_t::MIRRORED != this->_storageMode)
+	{
+		// A partial chunk is not kept in memory indefinitely
+		if (0 != this->_chunkLen && (true == force || (systick::getTicks() - this->_chunkStartMs) >= LOGGER_FLUSH_PERIOD_MS))
+		{
+			return flush();
+		}
+
+		return true;
+	}
+
+	return loggerMirror.replicate(force);
+}
+
+bool loggerManager::flush()
+{
+	if (0 == this->_chunkLen)
+	{
+		return true;
+	}
+
+	// A chunk that fails is dropped, like a single record was before buffering
+	size_t len		= this->_chunkLen;
+	this->_chunkLen = 0;
+
+	if (false == _openLogFile(this->_recordLen))
+	{
+		debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: file could not be opened or created\r\n");
+		return false;
+	}
+
+	debug::log<true, debug::logLevel::LOG_ALL>("LoggerManager: appending data to file\r\n");
+
+	bool status = (static_cast<int>(len) == fsHandler.write(this->_chunkBuff.data(), len));
+
+	if (false == status)
+	{
+		debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: unable to append data to file \r\n");
+	}
+
+	if (false == fsHandler.sync())
+	{
+		// Drop the handle, the next chunk reopens the file
+		debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: unable to sync file \r\n");
+		fsHandler.close();
+		this->_fileOpen = false;
+		return false;
+	}
+
+	return status;
+}
+
+uint32_t loggerManager::getPendingReplicationBytes()
+{
+	if (storageMode_t::MIRRORED != this->_storageMode)
+	{
+		return static_cast<uint32_t>(this->_chunkLen);
+	}
+
+	return loggerMirror.getPendingBytes();
+}
+
+uint16_t loggerManager::getWriteChunkSize()
+{
+	return loggerMirror.getWriteChunkSize();
+}
+
+uint32_t loggerManager::getDroppedRecords()
+{
+	if (storageMode_t::MIRRORED != this->_storageMode)
+	{
+		return 0;
+	}
+
+	return loggerMirror.getDroppedRecords();
+}
+
+bool loggerManager::_openLogFile(size_t recordLen)
+{
+	if (true == this->_fileOpen)
+	{
+		return true;
+	}
+
+	// Appending also creates missing files, new files are created explicitly to be preallocated
+	if (true == fsHandler.exists(this->_pPath))
+	{
+		if (false == fsHandler.open(this->_pPath, 2))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		debug::log<true, debug::logLevel::LOG_ALL>("LoggerManager: creating file\r\n");
+
+		if (false == fsHandler.open(this->_pPath, 3))
+		{
+			return false;
+		}
+
+		if (false == fsHandler.preallocate(_expectedFileSize(recordLen)))
+		{
+			debug::log<true, debug::logLevel::LOG_WARNING>("LoggerManager: unable to preallocate file\r\n");
+		}
+	}
+
+	this->_fileOpen = true;
+
+	// A file left empty, e.g. by a failed header write, still gets the header
+	if (nullptr != this->_pHeader && 0 == fsHandler.size())
+	{
+		size_t headerLen = std::strlen(this->_pHeader);
+
+		if (static_cast<int>(headerLen) != fsHandler.write(this->_pHeader, headerLen))
+		{
+			debug::log<true, debug::logLevel::LOG_ERROR>("LoggerManager: unable to write file header\r\n");
+		}
+	}
+
+	return true;
+}
+
+uint32_t loggerManager::_expectedFileSize(size_t recordLen)
+{
+	uint32_t period = (this->_metadata->generalMeasurementPeriod > 0) ? this->_metadata->generalMeasurementPeriod : 1;
+
+	return (utilities::MINUTES_IN_ONE_DAY / period) * static_cast<uint32_t>(recordLen);
 }
\ No newline at end of file
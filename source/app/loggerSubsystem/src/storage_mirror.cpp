@@ -0,0 +1,386 @@
+/**
+ * @file storage_mirror.cpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Source file for the mirrored storage, for a better description go to the header file
+ * @version 0.1
+ * @date 2025-04-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "storage_mirror.hpp"
+#include "debug_log.hpp"
+#include "ioAccounting.hpp"
+#include "virtualTimer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////
+//					   Public methods implementation
+////////////////////////////////////////////////////////////////////////
+
+storageMirror::storageMirror(fileSysWrapper& internalFs, fileSysWrapper& externalFs) : _internalFs(internalFs), _externalFs(externalFs) {}
+
+bool storageMirror::init(const char* pJournalPath, const char* pCursorPath, const char* pExternalPath)
+{
+	this->_pJournalPath	  = pJournalPath;
+	this->_pCursorPath	  = pCursorPath;
+	this->_pExternalPath  = pExternalPath;
+	this->_journalSize	  = 0;
+	this->_cursor		  = 0;
+	this->_droppedRecords = 0;
+	this->_externalReady  = true;
+
+	// A missing journal means there is nothing to replicate yet
+	if (true == this->_internalFs.open(this->_pJournalPath, 0))
+	{
+		int size = this->_internalFs.size();
+		this->_internalFs.close();
+
+		this->_journalSize = (size > 0) ? static_cast<uint32_t>(size) : 0;
+	}
+
+	if (false == _loadCursor() || this->_cursor > this->_journalSize)
+	{
+		// No cursor yet, or the journal was truncated before the cursor was reset
+		this->_cursor = 0;
+		return _storeCursor();
+	}
+
+	return true;
+}
+
+void storageMirror::calibrate(const char* pCalibrationPath, const char* pScratchPath)
+{
+	this->_pCalibrationPath = pCalibrationPath;
+	this->_pScratchPath		= pScratchPath;
+
+	// The external storage was mounted by the owner
+	_calibrateExternal();
+}
+
+bool storageMirror::commit(const char* pRecord, size_t len)
+{
+	// Unreplicated records are kept, the new ones are lost until replication compacts the journal
+	if (len > MIRROR_JOURNAL_MAX_SIZE - this->_journalSize)
+	{
+		if (0 == this->_droppedRecords++)
+		{
+			debug::log<true, debug::logLevel::LOG_WARNING>("storageMirror: journal full, dropping records until replicated\r\n");
+		}
+
+		return false;
+	}
+
+	if (false == this->_internalFs.open(this->_pJournalPath, 2))
+	{
+		debug::log<true, debug::logLevel::LOG_ERROR>("storageMirror: unable to open journal\r\n");
+		return false;
+	}
+
+	int bytesWritten = this->_internalFs.write(pRecord, len);
+
+	if (0 != this->_internalFs.close() || bytesWritten != static_cast<int>(len))
+	{
+		debug::log<true, debug::logLevel::LOG_ERROR>("storageMirror: unable to append record to journal\r\n");
+		return false;
+	}
+
+	this->_journalSize += static_cast<uint32_t>(len);
+
+	return true;
+}
+
+bool storageMirror::replicate(bool force)
+{
+	uint64_t now = systick::getTicks();
+
+	if (0 == getPendingBytes())
+	{
+		return true;
+	}
+
+	if (false == this->_externalReady)
+	{
+		if (false == force && (now - this->_lastAttempt) < MIRROR_RETRY_PERIOD_MS)
+		{
+			return false;
+		}
+
+		this->_lastAttempt = now;
+
+		if (false == this->_externalFs.mount())
+		{
+			return false;
+		}
+
+		// It may be a different card
+		if (nullptr != this->_pCalibrationPath)
+		{
+			_calibrateExternal();
+		}
+
+		this->_externalReady = true;
+	}
+
+	if (false == force && getPendingBytes() < this->_writeChunkSize && (now - this->_lastReplication) < MIRROR_FLUSH_PERIOD_MS)
+	{
+		return true;
+	}
+
+	do
+	{
+		if (false == _replicateBatch())
+		{
+			debug::log<true, debug::logLevel::LOG_WARNING>("storageMirror: external storage not available, replication delayed\r\n");
+			this->_externalReady = false;
+			this->_lastAttempt	 = now;
+			return false;
+		}
+	} while (true == force && getPendingBytes() > 0);
+
+	this->_lastReplication = now;
+
+	if (this->_cursor == this->_journalSize && this->_journalSize >= MIRROR_JOURNAL_COMPACT_SIZE)
+	{
+		_compactJournal();
+	}
+
+	return true;
+}
+
+void storageMirror::setHeader(const char* pHeader)
+{
+	this->_pHeader = pHeader;
+}
+
+uint32_t storageMirror::getPendingBytes() const
+{
+	return this->_journalSize - this->_cursor;
+}
+
+uint16_t storageMirror::getWriteChunkSize() const
+{
+	return this->_writeChunkSize;
+}
+
+uint32_t storageMirror::getDroppedRecords() const
+{
+	return this->_droppedRecords;
+}
+
+////////////////////////////////////////////////////////////////////////
+//					 Private methods implementation
+////////////////////////////////////////////////////////////////////////
+
+bool storageMirror::_replicateBatch()
+{
+	size_t chunk = std::min<size_t>(getPendingBytes(), this->_writeChunkSize);
+
+	if (false == this->_internalFs.open(this->_pJournalPath, 0))
+	{
+		return false;
+	}
+
+	int bytesRead = 0;
+
+	if (true == this->_internalFs.seek(this->_cursor))
+	{
+		bytesRead = this->_internalFs.read(this->_batchBuff.data(), chunk);
+	}
+
+	this->_internalFs.close();
+
+	if (bytesRead <= 0)
+	{
+		return false;
+	}
+
+	if (false == this->_externalFs.open(this->_pExternalPath, 2))
+	{
+		return false;
+	}
+
+	bool status = true;
+
+	// A new log file starts with the header
+	if (nullptr != this->_pHeader && 0 == this->_externalFs.size())
+	{
+		size_t headerLen = std::strlen(this->_pHeader);
+		status			 = (static_cast<int>(headerLen) == this->_externalFs.write(this->_pHeader, headerLen));
+	}
+
+	status = status && (bytesRead == this->_externalFs.write(this->_batchBuff.data(), static_cast<size_t>(bytesRead)));
+	status = status && this->_externalFs.sync();
+
+	this->_externalFs.close();
+
+	if (false == status)
+	{
+		return false;
+	}
+
+	this->_cursor += static_cast<uint32_t>(bytesRead);
+
+	// If the cursor can not be stored the batch is sent again after a reset
+	_storeCursor();
+
+	return true;
+}
+
+bool storageMirror::_loadCursor()
+{
+	char cursorBuff[16] = {'\0'};
+
+	if (false == this->_internalFs.open(this->_pCursorPath, 0))
+	{
+		return false;
+	}
+
+	int bytesRead = this->_internalFs.read(cursorBuff, sizeof(cursorBuff) - 1);
+	this->_internalFs.close();
+
+	if (bytesRead <= 0)
+	{
+		return false;
+	}
+
+	this->_cursor = static_cast<uint32_t>(std::strtoul(cursorBuff, nullptr, 10));
+
+	return true;
+}
+
+bool storageMirror::_storeCursor()
+{
+	char cursorBuff[16];
+
+	int len = snprintf(cursorBuff, sizeof(cursorBuff), "%lu\n", static_cast<unsigned long>(this->_cursor));
+
+	if (false == this->_internalFs.open(this->_pCursorPath, 4))
+	{
+		return false;
+	}
+
+	int bytesWritten = this->_internalFs.write(cursorBuff, static_cast<size_t>(len));
+
+	return (0 == this->_internalFs.close()) && (bytesWritten == len);
+}
+
+bool storageMirror::_compactJournal()
+{
+	// Truncate first, a reset before the cursor is stored is detected in init()
+	if (false == this->_internalFs.open(this->_pJournalPath, 4))
+	{
+		return false;
+	}
+
+	this->_internalFs.close();
+
+	this->_journalSize = 0;
+	this->_cursor	   = 0;
+
+	return _storeCursor();
+}
+
+void storageMirror::_calibrateExternal()
+{
+	this->_writeChunkSize = _selectWriteChunk();
+	ioAccounting::setWriteChunkSize(this->_externalFs.getTag(), this->_writeChunkSize);
+}
+
+uint16_t storageMirror::_selectWriteChunk()
+{
+	char calibrationBuff[16] = {'\0'};
+
+	if (true == this->_externalFs.open(this->_pCalibrationPath, 0))
+	{
+		int bytesRead = this->_externalFs.read(calibrationBuff, sizeof(calibrationBuff) - 1);
+		this->_externalFs.close();
+
+		uint32_t storedSize = (bytesRead > 0) ? static_cast<uint32_t>(std::strtoul(calibrationBuff, nullptr, 10)) : 0;
+
+		for (uint16_t candidate : MIRROR_CHUNK_CANDIDATES)
+		{
+			if (storedSize == candidate)
+			{
+				return candidate;
+			}
+		}
+	}
+
+	debug::log<true, debug::logLevel::LOG_ALL>("storageMirror: calibrating external storage write chunk\r\n");
+
+	// Largest candidate first, a smaller chunk only wins if it is clearly faster
+	uint16_t bestChunk = MIRROR_BATCH_SIZE;
+	int32_t	 bestTime  = -1;
+
+	for (auto candidate = MIRROR_CHUNK_CANDIDATES.rbegin(); candidate != MIRROR_CHUNK_CANDIDATES.rend(); ++candidate)
+	{
+		int32_t elapsed = _benchmarkChunk(*candidate);
+
+		if (elapsed < 0)
+		{
+			debug::log<true, debug::logLevel::LOG_WARNING>("storageMirror: external storage calibration failed\r\n");
+			return MIRROR_BATCH_SIZE;
+		}
+
+		if (bestTime < 0 || (elapsed * 100) < (bestTime * (100 - MIRROR_CALIBRATION_MARGIN_PCT)))
+		{
+			bestChunk = *candidate;
+			bestTime  = elapsed;
+		}
+	}
+
+	// Leave the scratch file empty
+	if (true == this->_externalFs.open(this->_pScratchPath, 4))
+	{
+		this->_externalFs.close();
+	}
+
+	int len = snprintf(calibrationBuff, sizeof(calibrationBuff), "%u\n", static_cast<unsigned>(bestChunk));
+
+	if (true == this->_externalFs.open(this->_pCalibrationPath, 4))
+	{
+		this->_externalFs.write(calibrationBuff, static_cast<size_t>(len));
+		this->_externalFs.close();
+	}
+
+	return bestChunk;
+}
+
+int32_t storageMirror::_benchmarkChunk(uint16_t chunkSize)
+{
+	std::fill(this->_batchBuff.begin(), this->_batchBuff.begin() + chunkSize, 'x');
+
+	uint64_t start = systick::getTicks();
+
+	if (false == this->_externalFs.open(this->_pScratchPath, 4))
+	{
+		return -1;
+	}
+
+	bool status = true;
+
+	for (uint32_t written = 0; written < MIRROR_CALIBRATION_BYTES && true == status; written += chunkSize)
+	{
+		status = (chunkSize == this->_externalFs.write(this->_batchBuff.data(), chunkSize));
+	}
+
+	status = status && this->_externalFs.sync();
+
+	this->_externalFs.close();
+
+	if (false == status)
+	{
+		return -1;
+	}
+
+	return static_cast<int32_t>(systick::getTicks() - start);
+}
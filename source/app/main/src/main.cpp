@@ -65,6 +65,13 @@ static constexpr char httpServerIP[] = "http://192.168.1.100:8080/api/hello";
 
 static constexpr uint8_t CONFIG_BUFF_SIZE = 96;
 
+/** @brief Where records are stored, MIRRORED journals them in internal flash before the SD card. */
+static constexpr storageMode_t LOGGER_STORAGE_MODE = storageMode_t::EXTERNAL_ONLY;
+
+/** @brief ADS1115 inputs scanned in continuous mode, and conversions averaged per sample. */
+static constexpr std::array<uint8_t, 1> analogInputs		= {ADS1115_COMP_0_GND};
+static constexpr uint8_t				ANALOG_OVERSAMPLING = 8;
+
 ////////////////////////////////////////////////////////////////////////
 //					       Private variables
 ////////////////////////////////////////////////////////////////////////
@@ -94,15 +101,10 @@ ADC::ADS1115 loggerADC;
 // sensor::anemometerDavis	 loggerAnemometer;
 // sensor::windVaneDavis	 loggerWindVane(loggerADC);
 sensor::thermometer::AHT21 loggerThermometerHygrometer;
-// clang-format off
-processingManager myProcessingManager(rtc, 
-								   	  loggerThermometerHygrometer, 
-								      loggerThermometerHygrometer);
-sensorService loggerSensorService(loggerADC,
-								  loggerThermometerHygrometer,
-								  loggerThermometerHygrometer);
-
-// clang-format on
+// Adding a sensor to the records is adding it here, e.g. (rtc, loggerThermometerHygrometer, loggerPluviometer)
+processingManager myProcessingManager(rtc, loggerThermometerHygrometer);
+/** @brief Current sensor values for the terminal, served from the measurement sample cache. */
+sensorService loggerSensorService(loggerADC, myProcessingManager);
 /** @brief Terminal state machine for user configuration via serial interface. */
 terminalStateMachine terminalOutput(rtc, loggerSensorService);
 /** @brief Component for handling metadata storage on the internal filesystem. */
@@ -127,6 +129,10 @@ static void configurationTask();
 static void loggerTask();
 /** @brief Task to perform sensor measurements and data processing. */
 static void measurementTask();
+/** @brief Loads the sampling period of each measured channel from the metadata. */
+static void setChannelPeriods();
+/** @brief Logs the sampling period of the adaptive channels when it changes. */
+static void logEffectivePeriods();
 /** @brief Task to handle network-related activities, like sending data. */
 static void networkTask();
 
@@ -197,16 +203,20 @@ int main()
 	terminalOutput.handler(terminalSignal::ENTRY, nullptr);
 
 	myProcessingManager.init();
+	setChannelPeriods();
 	myProcessingManager.setObserver(&myLoggerManager);
 	myProcessingManager.setObserver(&loggerHttpClient);
 
+	myLoggerManager.setStorageMode(LOGGER_STORAGE_MODE);
 	myLoggerManager.init();
 	myLoggerManager.setMailBox(myProcessingManager.getSensorInfoBuff());
+	myLoggerManager.setHeader(myProcessingManager.getCsvHeader());
 
 	loggerHttpClient.setURL(httpServerIP);
-	loggerHttpClient.setMailBox(myProcessingManager.getSensorInfoBuff());
+	loggerHttpClient.setMailBox(myProcessingManager.getSensorJsonBuff());
 
 	loggerADC.init();
+	loggerADC.startScan(analogInputs, ADS1115_RATE_128SPS, ANALOG_OVERSAMPLING);
 
 	/* Super loop | TODO RTOS */
 	while (1)
@@ -267,30 +277,69 @@ void configurationTask()
 	{
 		//TODO all metadata relevant parameters
 		measurementTaskPeriod = internalStorage.getMeasurementPeriod();
+		setChannelPeriods();
 	}
 }
 
 /**
  * @brief Executes the measurement and data processing task.
- * @details When the `runMeasurementTask` flag is set, this function triggers the processing manager to take measurements, format the data, and notify observers.
+ * @details Channels with a sampling period are sampled on their own cadence on every call. When the `runMeasurementTask`
+ * flag is set, this function starts a measurement cycle. Conversions run while the superloop keeps going, once the
+ * cycle completes the record is formatted and the observers are notified.
  */
 void measurementTask()
 {
+	loggerADC.scanHandler(systick::getTicks());
+	myProcessingManager.sampleHandler(systick::getTicks());
+	logEffectivePeriods();
+
 	if (1 == runMeasurementTask)
 	{
 		debug::log<true, debug::logLevel::LOG_ALL>("Running measurement task\r\n");
 
-		myProcessingManager.takeMeasurements();
+		myProcessingManager.startMeasurements(systick::getTicks());
+
+		runMeasurementTask = 0;
+	}
+
+	if (true == myProcessingManager.measurementsReady(systick::getTicks()))
+	{
+		debug::log<true, debug::logLevel::LOG_ALL>("Measurement cycle: %lu ms\r\n", static_cast<unsigned long>(myProcessingManager.getCycleLatencyMs()));
+
 		myProcessingManager.formatData();
 		myProcessingManager.notifyObservers();
+	}
+}
 
-		runMeasurementTask = 0;
+void setChannelPeriods()
+{
+	for (uint8_t channel = 0; channel < MAX_SAMPLED_CHANNELS; channel++)
+	{
+		myProcessingManager.setChannelPeriod(channel, internalStorage.getChannelPeriod(channel));
+		myProcessingManager.setAdaptivePeriod(channel, internalStorage.getChannelFastestPeriod(channel));
+	}
+}
+
+void logEffectivePeriods()
+{
+	static std::array<uint32_t, decltype(myProcessingManager)::NUM_CHANNELS> loggedPeriods{};
+
+	for (size_t channel = 0; channel < loggedPeriods.size(); channel++)
+	{
+		uint32_t period = myProcessingManager.getEffectivePeriod(channel);
+
+		if (period != loggedPeriods[channel])
+		{
+			debug::log<true, debug::logLevel::LOG_ALL>("Channel %s sampled every %lu ms\r\n", decltype(myProcessingManager)::channels[channel].name, static_cast<unsigned long>(period));
+			loggedPeriods[channel] = period;
+		}
 	}
 }
 
 /**
  * @brief Executes the data logging task.
  * @details If the logger manager has new data available, this function calls its handler to write the data to storage.
+ * Records committed to internal flash are then replicated to the SD card in batches, or a partial write chunk is flushed.
  */
 void loggerTask()
 {
@@ -299,6 +348,8 @@ void loggerTask()
 		debug::log<true, debug::logLevel::LOG_ALL>("Running logger task\r\n");
 		myLoggerManager.handler();
 	}
+
+	myLoggerManager.replicationHandler();
 }
 
 /**
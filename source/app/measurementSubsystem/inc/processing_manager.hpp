@@ -1,21 +1,33 @@
 #pragma once
 
-// #include "anemometer.hpp"
-// #include "pluviometer.hpp"
-#include "IHygrometer.hpp"
-#include "IThermometer.hpp"
+#include "record_compression.hpp"
+#include "record_schema.hpp"
+#include "sample_cache.hpp"
+#include "sampling_scheduler.hpp"
+#include "sensorChannel.hpp"
+#include "sensorConversion.hpp"
 #include "virtualRTC.hpp"
+#include "virtualTimer.hpp"
+#include "window_statistics.hpp"
 #include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <cstdio>
 #include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
 
 #ifndef TARGET_MICRO
 #include "sensorSimulatorConsumer.hpp"
 #endif
 
-constexpr uint8_t  MAX_NUM_OBSERVERS   = 10;
-constexpr uint16_t MSRD_DATA_BUFF_SIZE = 1024;
+constexpr uint8_t  MAX_NUM_OBSERVERS	 = 10;
+constexpr uint16_t MSRD_DATA_BUFF_SIZE	 = 1024;
+constexpr uint16_t MSRD_JSON_BUFF_SIZE	 = 512;
+constexpr uint16_t MSRD_HEADER_BUFF_SIZE = 256;
 
 class observerInterface // change class name, maybe processingMngObserver or IProcessing
 {
@@ -25,41 +37,108 @@ class observerInterface // change class name, maybe processingMngObserver or IPr
 };
 
 /**
- * @brief 
- * 
- * @tparam TPluviometer 
- * @tparam TAnemometer 
+ * @brief Acquires and formats the measurements of a set of sensors fixed at compile time
+ *
+ * Each sensor declares its channels, see sensorChannel.hpp. Acquisition and formatting are
+ * expanded over the sensors with fold expressions, there is no virtual dispatch and the
+ * sensors are referenced, not copied. Records list the channels in the order the sensors
+ * are given to the constructor.
+ *
+ * Channels can be sampled faster than records are built: a channel with a sampling period
+ * is read by sampleHandler() on its own cadence, and its samples are summarized into the next
+ * record: the record carries the mean, min/max/stddev/last are available from
+ * getChannelStatistics(). Channels without a period are read once per record. A channel
+ * can be adaptive, sampled faster than its period while it changes.
+ *
+ * Acquisitions are pipelined: sensors with non blocking conversions (IMultiQuantity with
+ * startSample()/pollSample()) are triggered first, the other sensors are read while those
+ * conversions run, and the results are collected as each one completes. A record is
+ * requested with startMeasurements() and is built once measurementsReady() returns true,
+ * so a cycle takes about as long as the slowest sensor instead of the sum of all of them.
+ *
+ * Every sample is also kept in a cache with the time it was taken. getLatestSample() serves
+ * other readers, e.g. the terminal, from it, and a measurement cycle does not read again
+ * the channels with a sample younger than the TTL, see sample_cache.hpp.
+ *
+ * Records can be compressed before they reach the observers: once a channel is given a
+ * compression rule, only the records needed to rebuild the channels within their tolerance
+ * are notified, see record_compression.hpp.
+ *
+ * @tparam Sensors sensor types, e.g. processingManager<AHT21, davisPluviometer>
  */
-//template<typename TPluviometer, typename TAnemometer, typename TWindVane>
-template<typename TThermometer, typename THygrometer>
+template<typename... Sensors>
 class processingManager
 {
   public:
+	static constexpr size_t	  NUM_SENSORS  = sizeof...(Sensors);
+	static constexpr size_t	  NUM_CHANNELS = (Sensors::channels.size() + ...);
+	static constexpr uint32_t ALL_CHANNELS = (NUM_CHANNELS >= 32) ? 0xFFFFFFFFu : ((1u << NUM_CHANNELS) - 1u); /// Mask with a bit per channel
+
+	/**
+	 * @brief Channels of all sensors, in record order
+	 */
+	static constexpr std::array<sensor::channelInfo, NUM_CHANNELS> channels = []
+	{
+		std::array<sensor::channelInfo, NUM_CHANNELS> table{};
+		size_t										  index = 0;
+
+		(
+			[&]
+			{
+				for (const auto& channel : Sensors::channels)
+				{
+					table[index++] = channel;
+				}
+			}(),
+			...);
+
+		return table;
+	}();
+
+	/**
+	 * @brief Index in @ref channels of the channel with a name, -1 if there is none
+	 */
+	static constexpr int findChannel(const char* name)
+	{
+		for (size_t index = 0; index < NUM_CHANNELS; index++)
+		{
+			const char* channelName = channels[index].name;
+			size_t		character	= 0;
+
+			while ('\0' != name[character] && name[character] == channelName[character])
+			{
+				character++;
+			}
+
+			if (name[character] == channelName[character])
+			{
+				return static_cast<int>(index);
+			}
+		}
+
+		return -1;
+	}
+
+	/**
+	 * @brief Record layout of this sensor set
+	 */
+	using schema_t = schema::recordSchema<channels>;
+
 	/**
 	 * @brief constructor
 	 */
-	// clang-format off
-	processingManager(virtualRTC& rtc,
-					  TThermometer& thermometer,
-					  THygrometer& hygrometer)
-					  /*TPluviometer& pluviometer,
-					  TAnemometer& anemometer,
-					  TWindVane& windVane*/ :
-					  _loggerRTC(rtc),
-					  _thermometer(thermometer),
-					  _hygrometer(hygrometer)
-					  /*_loggerPluviometer(pluviometer), 
-					  _loggerAnemometer(anemometer), 
-					  _loggerWindVane(windVane)*/ {}
-	// clang-format on
+	processingManager(virtualRTC& rtc, Sensors&... sensors) : _loggerRTC(rtc), _sensors(sensors...)
+	{
+		schema_t::writeCsvHeader(_csvHeaderBuff);
+	}
+
 	void init(void)
 	{
 #ifndef TARGET_MICRO
 		//sensorSimulator::init();
 #endif
 		/* Init sensors */
-		_thermometer.init();
-		_hygrometer.initHygrometer();
+		std::apply([](auto&... sensor) { (sensor.init(), ...); }, _sensors);
 	}
 
 	void setObserver(observerInterface* ref)
@@ -67,63 +146,610 @@ class processingManager
 		_listOfObservers[_activeObservers++] = ref;
 	}
 
+	/**
+	 * @brief Sets the sampling period of a channel
+	 *
+	 * @param channel index in @ref channels
+	 * @param periodMs period in milliseconds, 0 to read the channel once per record
+	 */
+	void setChannelPeriod(size_t channel, uint32_t periodMs)
+	{
+		_scheduler.setPeriod(channel, periodMs);
+	}
+
+	uint32_t getChannelPeriod(size_t channel) const
+	{
+		return _scheduler.getPeriod(channel);
+	}
+
+	/**
+	 * @brief Lets a channel with a sampling period sample faster while it changes, see sampling_scheduler.hpp
+	 *
+	 * The channel is active when it moves more than ADAPTIVE_THRESHOLD_STEPS times its last
+	 * decimal within a period, e.g. 0.1 degC for a temperature written with two decimals.
+	 *
+	 * @param channel index in @ref channels, call after setChannelPeriod()
+	 * @param fastestPeriodMs shortest period in milliseconds, 0 for a fixed rate
+	 */
+	void setAdaptivePeriod(size_t channel, uint32_t fastestPeriodMs)
+	{
+		if (channel >= NUM_CHANNELS)
+		{
+			return;
+		}
+
+		setAdaptivePeriod(channel, fastestPeriodMs, ADAPTIVE_THRESHOLD_STEPS / std::pow(10.0f, static_cast<float>(channels[channel].decimals)));
+	}
+
+	/**
+	 * @brief Same with a threshold, change over a period or standard deviation in channel units
+	 */
+	void setAdaptivePeriod(size_t channel, uint32_t fastestPeriodMs, float threshold)
+	{
+		_scheduler.setAdaptive(channel, fastestPeriodMs, threshold);
+	}
+
+	/**
+	 * @brief Period a channel is sampled at now, differs from getChannelPeriod() for adaptive channels
+	 */
+	uint32_t getEffectivePeriod(size_t channel) const
+	{
+		return _scheduler.getEffectivePeriod(channel);
+	}
+
+	/**
+	 * @brief Samples the channels whose period elapsed and collects finished conversions,
+	 * meant to be called on every superloop iteration
+	 *
+	 * @param now current time in milliseconds, e.g. systick::getTicks()
+	 */
+	void sampleHandler(uint64_t now)
+	{
+		_nowMs				 = now;
+		uint32_t dueChannels = _scheduler.getDueChannels(now);
+
+		if (0 != dueChannels)
+		{
+			_startAcquisition(dueChannels, std::make_index_sequence<NUM_SENSORS>{});
+		}
+
+		_pollAcquisition(std::make_index_sequence<NUM_SENSORS>{});
+	}
+
+	/**
+	 * @brief Starts a measurement cycle, the record is built when measurementsReady() returns true
+	 *
+	 * Channels without a sampling period are acquired now, the others were sampled by sampleHandler().
+	 *
+	 * @param now current time in milliseconds, the cycle latency is measured with the same clock
+	 */
+	void startMeasurements(uint64_t now)
+	{
+		_record.timestampMs = _loggerRTC.getEpochMs();
+		_recordRequested	= true;
+		_cycleStartMs		= now;
+		_nowMs				= now;
+
+		// Unscheduled channels and channels never sampled are read now, unless another reader just did
+		uint32_t readNow = ~_scheduler.getScheduledChannels() | ~_sampledChannels;
+		readNow			&= ~_cache.getFreshChannels(now);
+		_startAcquisition(readNow & ALL_CHANNELS, std::make_index_sequence<NUM_SENSORS>{});
+	}
+
+	/**
+	 * @brief Collects finished conversions and builds the record once the cycle is complete
+	 *
+	 * @param now current time in milliseconds, same clock as startMeasurements()
+	 * @return true once per startMeasurements(), when the record is ready to be formatted
+	 */
+	bool measurementsReady(uint64_t now)
+	{
+		_nowMs = now;
+		_pollAcquisition(std::make_index_sequence<NUM_SENSORS>{});
+
+		if (false == _recordRequested || 0 != _pendingChannels)
+		{
+			return false;
+		}
+
+		_buildRecord();
+		_recordRequested = false;
+		_cycleLatencyMs	 = static_cast<uint32_t>(now - _cycleStartMs);
+
+		return true;
+	}
+
+	/**
+	 * @brief Runs a whole measurement cycle, blocking until the record is built
+	 *
+	 * Uses systick::getTicks(), the clock of sampleHandler() and of the cache readers. The
+	 * RTC only stamps the record and the samples, it may be set or disciplined while running.
+	 */
 	void takeMeasurements()
 	{
-		_loggerRTC.getTimestamp(_timestamp.data());
+		startMeasurements(systick::getTicks());
+
+		while (false == measurementsReady(systick::getTicks()))
+		{
+		}
+	}
+
+	/**
+	 * @brief Latest sample of a channel, read from the sensor only if the cached one is stale
+	 *
+	 * A non blocking conversion is waited for. The sample is added to the current record
+	 * window like any other.
+	 *
+	 * @param channel index in @ref channels
+	 * @param now current time in milliseconds, same clock as sampleHandler()
+	 * @return the sample, or the last one if the read failed, nullopt if the channel was never read
+	 */
+	std::optional<float> getLatestSample(size_t channel, uint64_t now)
+	{
+		if (channel >= NUM_CHANNELS)
+		{
+			return std::nullopt;
+		}
+
+		std::optional<float> cached = _cache.lookup(channel, now);
+
+		if (true == cached.has_value())
+		{
+			return cached;
+		}
+
+		uint32_t channelMask = (1u << channel);
+		_nowMs				 = now;
+		_startAcquisition(channelMask, std::make_index_sequence<NUM_SENSORS>{});
+
+		while (0 != (_pendingChannels & channelMask))
+		{
+			_pollAcquisition(std::make_index_sequence<NUM_SENSORS>{});
+		}
+
+		return _cache.getLatest(channel);
+	}
+
+	/**
+	 * @brief Sets how long a sample is reused, 0 to read the sensors on every request
+	 */
+	void setCacheTtl(uint32_t ttlMs)
+	{
+		_cache.setTtl(ttlMs);
+	}
 
-		// TODO all sensors
-		_temperature = _thermometer.readTemperature().value_or(255.0);
-		_humidity	 = _hygrometer.readHumidity().value_or(255);
-		// _rainInMm		= _loggerPluviometer.getRain();
-		// _windSpeedInMPS = _loggerAnemometer.getWindSpeed();
-		// _windDir		= _loggerWindVane.getWindDir();
+	const sampleCache<NUM_CHANNELS>& getCache() const
+	{
+		return _cache;
 	}
 
+	/**
+	 * @brief Time from startMeasurements() to the record being built in the last cycle
+	 */
+	uint32_t getCycleLatencyMs() const
+	{
+		return _cycleLatencyMs;
+	}
+
+	/**
+	 * @brief Converts the last measurements to text, a CSV record for the logger and a JSON object for the network
+	 *
+	 * The CSV record carries the acquisition time, the JSON object also carries the capture time of each channel.
+	 */
 	void formatData()
 	{
-		// Append measurements with time they were taken
-		// clang-format off
-		snprintf(_sensorInfoBuff.data(),
-				 _sensorInfoBuff.max_size(),
-				 "%s;%f;%d\n",
-				 _timestamp.data(),
-				 _temperature,
-				 _humidity);
-		// clang-format on
+		schema_t::writeCsvLine(_record, _sensorInfoBuff);
+		schema_t::writeJson(_record, _sensorJsonBuff);
 	}
 
+	/**
+	 * @brief Notifies the observers of the records to store, all of them unless compression is enabled
+	 *
+	 * Meant to be called after formatData(). With compression the last record may be dropped,
+	 * then the observers are not notified, or a record held back may be released with it: the
+	 * CSV buffer then carries both lines, the JSON buffer an array of both records, held first.
+	 */
 	void notifyObservers()
 	{
+		if (true == _compressionEnabled)
+		{
+			typename schema_t::record_t held;
+			uint8_t						emitted = _compression.filter(_record, held);
+
+			if (0 != (emitted & compression::EMIT_HELD))
+			{
+				size_t length = schema_t::writeCsvLine(held, _sensorInfoBuff);
+
+				if (0 != (emitted & compression::EMIT_CURRENT))
+				{
+					const std::array<typename schema_t::record_t, 2> released = {held, _record};
+
+					schema_t::writeCsvLine(_record, std::span<char>(_sensorInfoBuff).subspan(length));
+					schema_t::writeJsonArray(released, _sensorJsonBuff);
+				}
+				else
+				{
+					schema_t::writeJson(held, _sensorJsonBuff);
+				}
+			}
+
+			if (compression::EMIT_NONE == emitted)
+			{
+				return;
+			}
+		}
+
 		notify(_sensorInfoBuff.data());
 	}
 
+	/**
+	 * @brief Sets how a channel is compressed and enables the compression of the records
+	 *
+	 * Channels not configured only drop repeated values.
+	 *
+	 * @param channel index in @ref channels
+	 * @param mode dead band, the channel holds its value between records, or swinging door, it is interpolated
+	 * @param tolerance largest reconstruction error, in channel units
+	 */
+	void setCompression(size_t channel, compression::filterMode mode, float tolerance)
+	{
+		_compression.configure(channel, mode, tolerance);
+		_compressionEnabled = true;
+	}
+
+	/**
+	 * @brief Sets the longest time between records notified when compression is enabled
+	 */
+	void setCompressionMaxInterval(uint32_t maxIntervalMs)
+	{
+		_compression.setMaxInterval(maxIntervalMs);
+	}
+
+	/**
+	 * @brief Stops compressing, every record is notified again
+	 */
+	void disableCompression()
+	{
+		_compressionEnabled = false;
+		_compression.reset();
+	}
+
+	/**
+	 * @brief Compression state, e.g. getSuppressionRatio()
+	 */
+	const compression::recordFilter<NUM_CHANNELS>& getCompression() const
+	{
+		return _compression;
+	}
+
 	const char* getSensorInfoBuff()
 	{
 		return _sensorInfoBuff.data();
 	}
 
+	const char* getSensorJsonBuff()
+	{
+		return _sensorJsonBuff.data();
+	}
+
+	/**
+	 * @brief Header written at the start of CSV files, the schema hash and the column names
+	 */
+	const char* getCsvHeader()
+	{
+		return _csvHeaderBuff.data();
+	}
+
+	/**
+	 * @brief Statistics of a channel over the window of the last record
+	 *
+	 * @param channel index in @ref channels, must be lower than NUM_CHANNELS
+	 */
+	const statistics::summary& getChannelStatistics(size_t channel) const
+	{
+		return _statistics[channel];
+	}
+
+	/**
+	 * @brief Last measurements with their binary timestamps
+	 */
+	const typename schema_t::record_t& getRecord() const
+	{
+		return _record;
+	}
+
   private:
+	/**
+	 * @brief Index in the record of the first channel of each sensor
+	 */
+	static constexpr std::array<size_t, NUM_SENSORS> _channelOffsets = []
+	{
+		std::array<size_t, NUM_SENSORS> offsets{};
+		std::array<size_t, NUM_SENSORS> sizes = {Sensors::channels.size()...};
+
+		for (size_t index = 1; index < NUM_SENSORS; index++)
+		{
+			offsets[index] = offsets[index - 1] + sizes[index - 1];
+		}
+
+		return offsets;
+	}();
+
+	/**
+	 * @brief Channels of each sensor in the record, bit n is channel n
+	 */
+	static constexpr std::array<uint32_t, NUM_SENSORS> _sensorMasks = []
+	{
+		std::array<uint32_t, NUM_SENSORS> masks{};
+		std::array<size_t, NUM_SENSORS>	  sizes = {Sensors::channels.size()...};
+
+		for (size_t index = 0; index < NUM_SENSORS; index++)
+		{
+			for (size_t channel = 0; channel < sizes[index]; channel++)
+			{
+				masks[index] |= (1u << (_channelOffsets[index] + channel));
+			}
+		}
+
+		return masks;
+	}();
+
 	std::array<char, MSRD_DATA_BUFF_SIZE>			  _sensorInfoBuff;
+	std::array<char, MSRD_JSON_BUFF_SIZE>			  _sensorJsonBuff;
+	std::array<char, MSRD_HEADER_BUFF_SIZE>			  _csvHeaderBuff;
 	std::array<observerInterface*, MAX_NUM_OBSERVERS> _listOfObservers;		/// components that will be notified with processed data. e.g loggerSubsystem, networkSubsystem
 	uint8_t											  _activeObservers = 0; /// How many components are listening for notifications
 	virtualRTC&										  _loggerRTC;
-	std::array<char, 50>							  _timestamp{}; /// Used to store the time and date of when the measurements were made
-	TThermometer&									  _thermometer;
-	THygrometer&									  _hygrometer;
-	// TPluviometer&								  _loggerPluviometer;
-	// TAnemometer&									  _loggerAnemometer;
-	// TWindVane&									  _loggerWindVane;
-
-	float	_temperature;
-	uint8_t _humidity;
-	// uint16_t _rainInMm;
-	// uint16_t _windSpeedInMPS;
-	// uint16_t _windDir;
-
-	/**
-     * @brief iterates through array of listeners 
-     * 
-     * @param pStr 
+	typename schema_t::record_t						  _record{}; /// Last measurements and when they were made
+	std::tuple<Sensors&...>							  _sensors;
+	samplingScheduler<NUM_CHANNELS>					  _scheduler;
+
+	// Samples taken since the last record, per channel
+	statistics::windowStatistics<NUM_CHANNELS>	  _window;
+	std::array<statistics::summary, NUM_CHANNELS> _statistics{}; /// Summary of the window of the last record
+	std::array<uint64_t, NUM_CHANNELS>			  _firstCaptureMs{};
+	std::array<uint64_t, NUM_CHANNELS>			  _lastCaptureMs{};
+	uint32_t									  _sampledChannels = 0; /// Channels sampled at least once
+	uint32_t									  _failedChannels  = 0; /// Channels whose last read failed
+	sampleCache<NUM_CHANNELS>					  _cache;				/// Latest sample of each channel, stamped with _nowMs
+	uint64_t									  _nowMs		   = 0; /// Time given to the current call, on the caller clock
+
+	// Measurement cycle
+	std::array<uint64_t, NUM_SENSORS> _conversionStartMs{}; /// When the pending conversion of each sensor was started
+	uint32_t						  _pendingSensors  = 0; /// Sensors with a conversion in progress, bit n is sensor n
+	uint32_t						  _pendingChannels = 0; /// Channels waiting for a conversion
+	bool							  _recordRequested = false;
+	uint64_t						  _cycleStartMs	   = 0;
+	uint32_t						  _cycleLatencyMs  = 0;
+
+	// Records notified
+	compression::recordFilter<NUM_CHANNELS> _compression;
+	bool									_compressionEnabled = false;
+
+	/**
+	 * @brief Mean of the samples of each channel since the previous record
+	 *
+	 * A scheduled channel with no new sample, because its period is longer than the record
+	 * period, keeps its last value and statistics. A channel whose last read failed is NaN,
+	 * written as a missing field, so a dead sensor does not repeat its last reading.
+	 */
+	void _buildRecord()
+	{
+		for (size_t index = 0; index < NUM_CHANNELS; index++)
+		{
+			if (0 == _window.getCount(index))
+			{
+				if (0 != (_failedChannels & (1u << index)))
+				{
+					_record.values[index] = std::numeric_limits<float>::quiet_NaN();
+				}
+
+				continue;
+			}
+
+			_statistics[index]		 = _window.close(index);
+			_record.values[index]	 = _statistics[index].mean;
+			_record.captureMs[index] = _firstCaptureMs[index] + (_lastCaptureMs[index] - _firstCaptureMs[index]) / 2;
+		}
+	}
+
+	/**
+	 * @brief Triggers the non blocking conversions first, then reads the other sensors while they run
+	 */
+	template<size_t... sensorIndex>
+	void _startAcquisition(uint32_t channelMask, std::index_sequence<sensorIndex...>)
+	{
+		(_startConversion<sensorIndex>(channelMask), ...);
+		(_acquireChannels<sensorIndex>(channelMask, _channelSequence<sensorIndex>()), ...);
+	}
+
+	template<size_t... sensorIndex>
+	void _pollAcquisition(std::index_sequence<sensorIndex...>)
+	{
+		if (0 != _pendingSensors)
+		{
+			(_pollConversion<sensorIndex>(_channelSequence<sensorIndex>()), ...);
+		}
+	}
+
+	template<size_t sensorIndex>
+	static constexpr auto _channelSequence()
+	{
+		return std::make_index_sequence<std::tuple_element_t<sensorIndex, std::tuple<Sensors...>>::channels.size()>{};
+	}
+
+	template<size_t sensorIndex>
+	void _startConversion(uint32_t channelMask)
+	{
+		auto&	 sensor			= std::get<sensorIndex>(_sensors);
+		uint32_t sensorChannels = channelMask & _sensorMasks[sensorIndex];
+
+		if constexpr (requires { sensor.startSample(); })
+		{
+			if (0 == sensorChannels)
+			{
+				return;
+			}
+
+			// A conversion in progress serves the new request too
+			if (0 == (_pendingSensors & (1u << sensorIndex)))
+			{
+				if (false == sensor.startSample())
+				{
+					return; // The channels keep their last value
+				}
+
+				_conversionStartMs[sensorIndex] = _loggerRTC.getEpochMs();
+				_pendingSensors				   |= (1u << sensorIndex);
+			}
+
+			_pendingChannels |= sensorChannels;
+		}
+	}
+
+	template<size_t sensorIndex, size_t... channelIndex>
+	void _pollConversion(std::index_sequence<channelIndex...>)
+	{
+		auto& sensor = std::get<sensorIndex>(_sensors);
+
+		if constexpr (requires { sensor.pollSample(); })
+		{
+			if (0 == (_pendingSensors & (1u << sensorIndex)))
+			{
+				return;
+			}
+
+			sensor::conversionStatus status = sensor.pollSample();
+
+			if (sensor::conversionStatus::BUSY == status)
+			{
+				return;
+			}
+
+			uint32_t sensorChannels = _pendingChannels & _sensorMasks[sensorIndex];
+
+			if (sensor::conversionStatus::READY == status)
+			{
+				// The conversion happened somewhere between its start and now
+				uint64_t		 start	   = _conversionStartMs[sensorIndex];
+				uint64_t		 captureMs = start + (_loggerRTC.getEpochMs() - start) / 2;
+				constexpr size_t offset	   = _channelOffsets[sensorIndex];
+
+				(_addSample<offset + channelIndex>(sensorChannels, sensor.template readChannel<channelIndex>(), captureMs), ...);
+			}
+
+			_pendingSensors	 &= ~(1u << sensorIndex);
+			_pendingChannels &= ~sensorChannels;
+		}
+	}
+
+	/**
+	 * @brief Reads the channels of a sensor without non blocking conversions
+	 */
+	template<size_t sensorIndex, size_t... channelIndex>
+	void _acquireChannels(uint32_t channelMask, std::index_sequence<channelIndex...>)
+	{
+		auto&			 sensor = std::get<sensorIndex>(_sensors);
+		constexpr size_t offset = _channelOffsets[sensorIndex];
+
+		if (0 == (channelMask & _sensorMasks[sensorIndex]))
+		{
+			return;
+		}
+
+		if constexpr (requires { sensor.startSample(); })
+		{
+			return; // Acquired by _startConversion() and _pollConversion()
+		}
+		else if constexpr (requires { sensor.sample(); })
+		{
+			// One conversion for all the quantities of the device, its channels share the result and its time
+			uint64_t captureMs;
+			_capture([&sensor] { return sensor.sample(); }, captureMs);
+
+			(_addSample<offset + channelIndex>(channelMask, sensor.template readChannel<channelIndex>(), captureMs), ...);
+		}
+		else
+		{
+			(_acquireChannel<offset + channelIndex>(channelMask, [&sensor] { return sensor.template readChannel<channelIndex>(); }), ...);
+		}
+	}
+
+	/**
+	 * @brief Reads a channel if it is in the mask and adds the sample to its window
+	 */
+	template<size_t index, typename TRead>
+	void _acquireChannel(uint32_t channelMask, TRead read)
+	{
+		if (0 == (channelMask & (1u << index)))
+		{
+			return;
+		}
+
+		uint64_t captureMs;
+		auto	 value = _capture(read, captureMs);
+
+		_addSample<index>(channelMask, value, captureMs);
+	}
+
+	/**
+	 * @brief Adds a sample to the window of a channel if it is in the mask
+	 *
+	 * A failed read is not a sample, the window, cache and scheduler only see real values.
+	 * It is remembered so that the record shows the channel as missing.
+	 */
+	template<size_t index>
+	void _addSample(uint32_t channelMask, std::optional<float> value, uint64_t captureMs)
+	{
+		if (0 == (channelMask & (1u << index)))
+		{
+			return;
+		}
+
+		if (false == value.has_value())
+		{
+			_failedChannels |= (1u << index);
+			return;
+		}
+
+		if (0 == _window.getCount(index))
+		{
+			_firstCaptureMs[index] = captureMs;
+		}
+
+		_window.add(index, *value);
+		_cache.store(index, *value, _nowMs);
+		_scheduler.addSample(index, *value, _nowMs);
+		_lastCaptureMs[index] = captureMs;
+		_sampledChannels	 |= (1u << index);
+		_failedChannels		 &= ~(1u << index);
+	}
+
+	/**
+	 * @brief Reads a channel and stamps it with the middle of the read
+	 *
+	 * Sensor reads include the conversion time (about 80 ms for the AHT21), the sample is
+	 * taken somewhere inside it, so the midpoint is the best estimate of its time.
+	 *
+	 * @param read callable performing the read
+	 * @param captureMs receives the capture time in milliseconds since 01/01/1970
+	 */
+	template<typename TRead>
+	auto _capture(TRead read, uint64_t& captureMs)
+	{
+		uint64_t start = _loggerRTC.getEpochMs();
+		auto	 value = read();
+		uint64_t end   = _loggerRTC.getEpochMs();
+
+		captureMs = start + (end - start) / 2;
+
+		return value;
+	}
+
+	/**
+     * @brief iterates through array of listeners
+     *
+     * @param pStr
      */
 	void notify(const char* pBuff)
 	{
@@ -0,0 +1,300 @@
+/**
+ * @file record_compression.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Dead band and swinging door compression of the records sent to the observers
+
+	Most records of a slow channel repeat the previous one or lie on a line with it. The
+	filter only lets through the records needed to rebuild every channel within a tolerance,
+	so storage and uplink carry the changes instead of the sampling rate.
+
+	Each channel is compressed with one of two rules, the reconstruction differs:
+
+	- Dead band, the channel is rebuilt holding each value until the next record stored.
+	  A record is stored when the channel moved more than the tolerance from the last
+	  stored value. A tolerance of 0 only drops repeated values, it is lossless.
+	- Swinging door, the channel is rebuilt interpolating linearly between records stored.
+	  The filter keeps the range of slopes, from the last stored record, of the lines that
+	  pass within the tolerance of every record since. While the line to the new record is
+	  in that range the previous record is dropped. Otherwise the previous record is stored,
+	  the line to it was in the range when it came, and the new one starts a segment.
+
+	With both rules every record dropped is within the tolerance of its reconstruction.
+	A record is stored when any of its channels needs it, and at least once per max
+	interval, so a quiet channel still shows up in the log.
+
+	Storing the previous record means the filter may release two records at once, the one
+	held back and the current one.
+
+ * @version 0.1
+ * @date 2025-05-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "record_schema.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t COMPRESSION_MAX_INTERVAL_MS = 60 * 60 * 1000; // Default longest time without a record stored
+
+namespace compression
+{
+
+////////////////////////////////////////////////////////////////////////
+//							     Types
+////////////////////////////////////////////////////////////////////////
+
+enum class filterMode : uint8_t
+{
+	DEAD_BAND,	   /// Step reconstruction
+	SWINGING_DOOR, /// Linear reconstruction
+};
+
+/**
+ * @brief Records released by recordFilter::filter(), a combination of the flags
+ */
+enum emitFlags : uint8_t
+{
+	EMIT_NONE	 = 0,
+	EMIT_HELD	 = (1u << 0), /// The record held back, stored before the current one
+	EMIT_CURRENT = (1u << 1), /// The record given
+};
+
+struct channelFilter
+{
+	filterMode mode		 = filterMode::DEAD_BAND;
+	float	   tolerance = 0.0f; /// Largest reconstruction error, in channel units
+};
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+template<size_t numChannels>
+class recordFilter
+{
+  public:
+	using record_t = measurementRecord<numChannels>;
+
+	/**
+	 * @brief Sets the rule of a channel, by default channels are a lossless dead band
+	 *
+	 * @param channel channel index, out of range indexes are ignored
+	 * @param mode reconstruction of the channel
+	 * @param tolerance largest error allowed, in channel units
+	 */
+	void configure(size_t channel, filterMode mode, float tolerance)
+	{
+		if (channel >= numChannels)
+		{
+			return;
+		}
+
+		this->_channels[channel] = {mode, tolerance};
+	}
+
+	const channelFilter& getChannelFilter(size_t channel) const
+	{
+		return this->_channels[channel];
+	}
+
+	/**
+	 * @brief Sets the longest time between records stored, 0 stores every record
+	 */
+	void setMaxInterval(uint32_t maxIntervalMs)
+	{
+		this->_maxIntervalMs = maxIntervalMs;
+	}
+
+	/**
+	 * @brief Decides which records are stored when a new one is made
+	 *
+	 * @param record new record, timestamps increasing
+	 * @param held set to the record held back when EMIT_HELD is returned
+	 * @return emitFlags, EMIT_HELD comes before EMIT_CURRENT in time
+	 */
+	uint8_t filter(const record_t& record, record_t& held)
+	{
+		this->_offered++;
+
+		if (false == this->_hasArchive)
+		{
+			_archive(record);
+			return EMIT_CURRENT;
+		}
+
+		uint8_t emitted = EMIT_NONE;
+
+		if (true == this->_hasHeld && false == _fitsDoor(record))
+		{
+			held = this->_held;
+			_archive(this->_held);
+			emitted |= EMIT_HELD;
+		}
+
+		if (record.timestampMs - this->_archived.timestampMs >= this->_maxIntervalMs || true == _leavesDeadBand(record))
+		{
+			_archive(record);
+			return emitted | EMIT_CURRENT;
+		}
+
+		_hold(record);
+
+		return emitted;
+	}
+
+	/**
+	 * @brief Forgets the records seen, the next record is stored
+	 */
+	void reset()
+	{
+		this->_hasArchive = false;
+		this->_hasHeld	  = false;
+	}
+
+	/**
+	 * @brief Records given to filter()
+	 */
+	uint32_t getOffered() const
+	{
+		return this->_offered;
+	}
+
+	/**
+	 * @brief Records released by filter()
+	 */
+	uint32_t getStored() const
+	{
+		return this->_stored;
+	}
+
+	/**
+	 * @brief Fraction of the records dropped, 0 before any record
+	 */
+	float getSuppressionRatio() const
+	{
+		if (0 == this->_offered || this->_stored >= this->_offered)
+		{
+			return 0.0f;
+		}
+
+		return static_cast<float>(this->_offered - this->_stored) / static_cast<float>(this->_offered);
+	}
+
+  private:
+	std::array<channelFilter, numChannels> _channels{};
+	uint32_t							   _maxIntervalMs = COMPRESSION_MAX_INTERVAL_MS;
+	record_t							   _archived{}; /// Last record stored
+	record_t							   _held{};		/// Last record dropped, stored if the next one leaves the door
+	bool								   _hasArchive = false;
+	bool								   _hasHeld	   = false;
+	std::array<float, numChannels>		   _slopeLow{}; /// Swinging door, per millisecond from the last record stored
+	std::array<float, numChannels>		   _slopeHigh{};
+	uint32_t							   _offered = 0;
+	uint32_t							   _stored	= 0;
+
+	void _archive(const record_t& record)
+	{
+		this->_archived	  = record;
+		this->_hasArchive = true;
+		this->_hasHeld	  = false;
+		this->_stored++;
+	}
+
+	float _elapsedMs(const record_t& record) const
+	{
+		uint64_t elapsed = record.timestampMs - this->_archived.timestampMs;
+
+		return static_cast<float>((0 != elapsed) ? elapsed : 1);
+	}
+
+	/**
+	 * @brief True if the lines to the record pass within the tolerance of every record held since the last one stored
+	 */
+	bool _fitsDoor(const record_t& record) const
+	{
+		float elapsedMs = _elapsedMs(record);
+
+		for (size_t channel = 0; channel < numChannels; channel++)
+		{
+			if (filterMode::SWINGING_DOOR != this->_channels[channel].mode)
+			{
+				continue;
+			}
+
+			float slope = (record.values[channel] - this->_archived.values[channel]) / elapsedMs;
+
+			// Written so that a NaN leaves the door
+			if (false == (this->_slopeLow[channel] <= slope && slope <= this->_slopeHigh[channel]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool _leavesDeadBand(const record_t& record) const
+	{
+		for (size_t channel = 0; channel < numChannels; channel++)
+		{
+			if (filterMode::DEAD_BAND != this->_channels[channel].mode)
+			{
+				continue;
+			}
+
+			float change = std::fabs(record.values[channel] - this->_archived.values[channel]);
+
+			if (false == (change <= this->_channels[channel].tolerance))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Drops a record for now, narrowing the door to the lines within the tolerance of it
+	 */
+	void _hold(const record_t& record)
+	{
+		float elapsedMs = _elapsedMs(record);
+
+		for (size_t channel = 0; channel < numChannels; channel++)
+		{
+			float change = record.values[channel] - this->_archived.values[channel];
+			float low	 = (change - this->_channels[channel].tolerance) / elapsedMs;
+			float high	 = (change + this->_channels[channel].tolerance) / elapsedMs;
+
+			if (false == this->_hasHeld)
+			{
+				this->_slopeLow[channel]  = low;
+				this->_slopeHigh[channel] = high;
+			}
+			else
+			{
+				this->_slopeLow[channel]  = std::fmax(this->_slopeLow[channel], low);
+				this->_slopeHigh[channel] = std::fmin(this->_slopeHigh[channel], high);
+			}
+		}
+
+		this->_held	   = record;
+		this->_hasHeld = true;
+	}
+};
+
+} // namespace compression
@@ -0,0 +1,463 @@
+/**
+ * @file record_schema.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Record layout generated at compile time from the sensor channel declarations
+
+	A record is the acquisition time followed by one value per channel, in the order of
+	the channel table (see sensorChannel.hpp). recordSchema is instantiated on that table
+	and generates every representation of a record from it:
+
+	- CSV: "HH:MM:SS.mmm-DD/MM/YYYY;value;value\n", values with the channel decimals.
+	  A missing value, NaN in the record, is an empty field.
+	  Files start with "#schema=<hash>" and a line naming the columns and their units.
+	- Binary: packed little endian, the epoch in milliseconds as 8 bytes then each value
+	  as an integer scaled by 10^decimals in the channel type. Files start with a 10 byte
+	  header: "GLR", the schema version, the hash (4 bytes) and the record size (2 bytes).
+	- JSON: one object per record, the schema hash, the time and each value with its
+	  capture time. A missing value is null. Records released together are an array.
+
+	The hash is a 32 bit FNV-1a of the version and of every field name, unit, decimals and
+	type, so it only changes when the layout does. A reader compares it with the hash it
+	was built for and decodes with fixed offsets, no schema is parsed at run time.
+
+ * @version 0.1
+ * @date 2025-04-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "record_writer.hpp"
+#include "sensorChannel.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint8_t				  SCHEMA_VERSION		  = 1;
+constexpr std::array<uint8_t, 3>  BINARY_FILE_MAGIC		  = {'G', 'L', 'R'};
+constexpr size_t				  BINARY_FILE_HEADER_SIZE = 10; // Magic, version, hash and record size
+constexpr size_t				  BINARY_TIMESTAMP_SIZE	  = 8;
+constexpr uint8_t				  SCHEMA_HASH_DIGITS	  = 8;
+constexpr std::array<float, 7>	  SCHEMA_SCALES			  = {1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f, 100000.0f, 1000000.0f};
+constexpr std::array<uint32_t, 2> FNV1A_PARAMETERS		  = {2166136261u, 16777619u}; // Offset basis and prime
+
+////////////////////////////////////////////////////////////////////////
+//							     Types
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief One set of measurements, kept binary until a record is formatted
+ *
+ * @tparam numChannels channels of all the sensors, in the order of the channel table
+ */
+template<size_t numChannels>
+struct measurementRecord
+{
+	uint64_t						  timestampMs; /// Milliseconds since 01/01/1970 of when the acquisition started
+	std::array<float, numChannels>	  values;
+	std::array<uint64_t, numChannels> captureMs; /// When each channel was sampled
+};
+
+namespace schema
+{
+
+////////////////////////////////////////////////////////////////////////
+//						  Function definitions
+////////////////////////////////////////////////////////////////////////
+
+constexpr size_t fieldSize(sensor::fieldType type)
+{
+	switch (type)
+	{
+		case sensor::fieldType::UINT8:
+			return 1;
+		case sensor::fieldType::UINT16:
+			[[fallthrough]];
+		case sensor::fieldType::INT16:
+			return 2;
+		default:
+			return 4;
+	}
+}
+
+constexpr uint32_t hashByte(uint32_t hash, uint8_t value)
+{
+	return (hash ^ value) * FNV1A_PARAMETERS[1];
+}
+
+/**
+ * @brief Hashes a string including its terminator, so "ab","c" and "a","bc" differ
+ */
+constexpr uint32_t hashString(uint32_t hash, const char* pText)
+{
+	while ('\0' != *pText)
+	{
+		hash = hashByte(hash, static_cast<uint8_t>(*pText++));
+	}
+
+	return hashByte(hash, 0);
+}
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Serializers of the records of a channel table
+ *
+ * @tparam channels static constexpr std::array<sensor::channelInfo, N>
+ */
+template<const auto& channels>
+class recordSchema
+{
+  public:
+	static constexpr size_t NUM_CHANNELS = channels.size();
+
+	using record_t = measurementRecord<NUM_CHANNELS>;
+
+	static constexpr uint32_t HASH = []
+	{
+		uint32_t hash = hashByte(FNV1A_PARAMETERS[0], SCHEMA_VERSION);
+
+		hash = hashString(hash, "time");
+		hash = hashString(hash, "ms");
+
+		for (const auto& channel : channels)
+		{
+			hash = hashString(hash, channel.name);
+			hash = hashString(hash, channel.unit);
+			hash = hashByte(hash, channel.decimals);
+			hash = hashByte(hash, static_cast<uint8_t>(channel.type));
+		}
+
+		return hash;
+	}();
+
+	/**
+	 * @brief Offset of each value in a binary record
+	 */
+	static constexpr std::array<size_t, NUM_CHANNELS> BINARY_OFFSETS = []
+	{
+		std::array<size_t, NUM_CHANNELS> offsets{};
+		size_t							 offset = BINARY_TIMESTAMP_SIZE;
+
+		for (size_t index = 0; index < NUM_CHANNELS; index++)
+		{
+			offsets[index] = offset;
+			offset		  += fieldSize(channels[index].type);
+		}
+
+		return offsets;
+	}();
+
+	static constexpr size_t BINARY_RECORD_SIZE = BINARY_OFFSETS[NUM_CHANNELS - 1] + fieldSize(channels[NUM_CHANNELS - 1].type);
+
+	/**
+	 * @brief Writes the header of a CSV file, the schema hash and the column names
+	 *
+	 * @return size_t length written, 0 if it did not fit
+	 */
+	static size_t writeCsvHeader(std::span<char> buff)
+	{
+		recordWriter writer(buff);
+
+		writer.appendString("#schema=").appendHex(HASH, SCHEMA_HASH_DIGITS).appendChar('\n').appendString("time");
+
+		for (const auto& channel : channels)
+		{
+			writer.appendChar(';').appendString(channel.name).appendChar('[').appendString(channel.unit).appendChar(']');
+		}
+
+		writer.appendChar('\n');
+
+		return writer.finish();
+	}
+
+	/**
+	 * @brief Writes a record as a CSV line
+	 *
+	 * @return size_t length written, 0 if it did not fit
+	 */
+	static size_t writeCsvLine(const record_t& record, std::span<char> buff)
+	{
+		recordWriter writer(buff);
+
+		writer.appendTimestamp(record.timestampMs);
+
+		for (size_t index = 0; index < NUM_CHANNELS; index++)
+		{
+			writer.appendChar(';');
+
+			if (false == std::isnan(record.values[index]))
+			{
+				writer.appendFixed(record.values[index], channels[index].decimals);
+			}
+		}
+
+		writer.appendChar('\n');
+
+		return writer.finish();
+	}
+
+	/**
+	 * @brief Writes a record as a JSON object
+	 *
+	 * @return size_t length written, 0 if it did not fit
+	 */
+	static size_t writeJson(const record_t& record, std::span<char> buff)
+	{
+		recordWriter writer(buff);
+
+		_appendJson(writer, record);
+
+		return writer.finish();
+	}
+
+	/**
+	 * @brief Writes records as a JSON array of objects, in the given order
+	 *
+	 * @return size_t length written, 0 if it did not fit
+	 */
+	static size_t writeJsonArray(std::span<const record_t> records, std::span<char> buff)
+	{
+		recordWriter writer(buff);
+
+		writer.appendChar('[');
+
+		for (size_t index = 0; index < records.size(); index++)
+		{
+			if (index > 0)
+			{
+				writer.appendChar(',');
+			}
+
+			_appendJson(writer, records[index]);
+		}
+
+		writer.appendChar(']');
+
+		return writer.finish();
+	}
+
+	/**
+	 * @brief Writes the header of a binary file
+	 *
+	 * @return size_t BINARY_FILE_HEADER_SIZE, 0 if it did not fit
+	 */
+	static size_t writeBinaryHeader(std::span<uint8_t> buff)
+	{
+		if (buff.size() < BINARY_FILE_HEADER_SIZE)
+		{
+			return 0;
+		}
+
+		buff[0] = BINARY_FILE_MAGIC[0];
+		buff[1] = BINARY_FILE_MAGIC[1];
+		buff[2] = BINARY_FILE_MAGIC[2];
+		buff[3] = SCHEMA_VERSION;
+		_putLittleEndian(&buff[4], HASH, 4);
+		_putLittleEndian(&buff[8], BINARY_RECORD_SIZE, 2);
+
+		return BINARY_FILE_HEADER_SIZE;
+	}
+
+	/**
+	 * @brief true if a binary file header was written with this schema
+	 */
+	static bool checkBinaryHeader(std::span<const uint8_t> buff)
+	{
+		// clang-format off
+		return buff.size() >= BINARY_FILE_HEADER_SIZE &&
+			   BINARY_FILE_MAGIC[0] == buff[0] && BINARY_FILE_MAGIC[1] == buff[1] && BINARY_FILE_MAGIC[2] == buff[2] &&
+			   HASH == _getLittleEndian(&buff[4], 4) &&
+			   BINARY_RECORD_SIZE == _getLittleEndian(&buff[8], 2);
+		// clang-format on
+	}
+
+	/**
+	 * @brief Packs a record, capture times are not stored
+	 *
+	 * @return size_t BINARY_RECORD_SIZE, 0 if it did not fit
+	 */
+	static size_t encode(const record_t& record, std::span<uint8_t> buff)
+	{
+		if (buff.size() < BINARY_RECORD_SIZE)
+		{
+			return 0;
+		}
+
+		_putLittleEndian(&buff[0], record.timestampMs, BINARY_TIMESTAMP_SIZE);
+		_encodeValues(record, buff, std::make_index_sequence<NUM_CHANNELS>{});
+
+		return BINARY_RECORD_SIZE;
+	}
+
+	/**
+	 * @brief Unpacks a record, every capture time is set to the record time
+	 *
+	 * @return true if the buffer holds a full record
+	 */
+	static bool decode(std::span<const uint8_t> buff, record_t& record)
+	{
+		if (buff.size() < BINARY_RECORD_SIZE)
+		{
+			return false;
+		}
+
+		record.timestampMs = _getLittleEndian(&buff[0], BINARY_TIMESTAMP_SIZE);
+		_decodeValues(buff, record, std::make_index_sequence<NUM_CHANNELS>{});
+
+		return true;
+	}
+
+  private:
+	/**
+	 * @brief Appends a record as a JSON object
+	 */
+	static void _appendJson(recordWriter& writer, const record_t& record)
+	{
+		// clang-format off
+		writer.appendString("{\"schema\":\"")
+			  .appendHex(HASH, SCHEMA_HASH_DIGITS)
+			  .appendString("\",\"epochMs\":")
+			  .appendUnsigned64(record.timestampMs)
+			  .appendString(",\"time\":\"")
+			  .appendIsoTimestamp(record.timestampMs)
+			  .appendChar('"');
+		// clang-format on
+
+		for (size_t index = 0; index < NUM_CHANNELS; index++)
+		{
+			// clang-format off
+			writer.appendString(",\"")
+				  .appendString(channels[index].name)
+				  .appendString("\":");
+			// clang-format on
+
+			if (true == std::isnan(record.values[index]))
+			{
+				writer.appendString("null");
+			}
+			else
+			{
+				writer.appendFixed(record.values[index], channels[index].decimals);
+			}
+
+			// clang-format off
+			writer.appendString(",\"")
+				  .appendString(channels[index].name)
+				  .appendString("EpochMs\":")
+				  .appendUnsigned64(record.captureMs[index]);
+			// clang-format on
+		}
+
+
+		writer.appendChar('}');
+	}
+
+	static void _putLittleEndian(uint8_t* pDst, uint64_t value, size_t numBytes)
+	{
+		for (size_t index = 0; index < numBytes; index++)
+		{
+			pDst[index]	  = static_cast<uint8_t>(value);
+			value		>>= 8;
+		}
+	}
+
+	static uint64_t _getLittleEndian(const uint8_t* pSrc, size_t numBytes)
+	{
+		uint64_t value = 0;
+
+		for (size_t index = numBytes; index > 0; index--)
+		{
+			value = (value << 8) | pSrc[index - 1];
+		}
+
+		return value;
+	}
+
+	/**
+	 * @brief Converts a value to the bits stored for a channel, saturating at the limits of its type
+	 */
+	template<size_t index>
+	static uint32_t _toField(float value)
+	{
+		constexpr sensor::fieldType type = channels[index].type;
+
+		if constexpr (sensor::fieldType::FLOAT32 == type)
+		{
+			return std::bit_cast<uint32_t>(value);
+		}
+		else
+		{
+			constexpr float minValue = (sensor::fieldType::INT16 == type) ? -32768.0f : (sensor::fieldType::INT32 == type) ? -2147483648.0f : 0.0f;
+			constexpr float maxValue = (sensor::fieldType::UINT8 == type) ? 255.0f : (sensor::fieldType::UINT16 == type) ? 65535.0f : (sensor::fieldType::INT16 == type) ? 32767.0f : 2147483520.0f;
+
+			float scaled = std::round(value * SCHEMA_SCALES[channels[index].decimals]);
+
+			// NaN is stored as the largest value, the same sentinel as a failed read
+			if (true == std::isnan(scaled) || scaled > maxValue)
+			{
+				scaled = maxValue;
+			}
+			else if (scaled < minValue)
+			{
+				scaled = minValue;
+			}
+
+			return static_cast<uint32_t>(static_cast<int32_t>(scaled));
+		}
+	}
+
+	template<size_t index>
+	static float _fromField(uint32_t bits)
+	{
+		constexpr sensor::fieldType type = channels[index].type;
+
+		if constexpr (sensor::fieldType::FLOAT32 == type)
+		{
+			return std::bit_cast<float>(bits);
+		}
+		else if constexpr (sensor::fieldType::INT16 == type)
+		{
+			return static_cast<float>(static_cast<int16_t>(bits)) / SCHEMA_SCALES[channels[index].decimals];
+		}
+		else if constexpr (sensor::fieldType::INT32 == type)
+		{
+			return static_cast<float>(static_cast<int32_t>(bits)) / SCHEMA_SCALES[channels[index].decimals];
+		}
+		else
+		{
+			return static_cast<float>(bits) / SCHEMA_SCALES[channels[index].decimals];
+		}
+	}
+
+	template<size_t... index>
+	static void _encodeValues(const record_t& record, std::span<uint8_t> buff, std::index_sequence<index...>)
+	{
+		(_putLittleEndian(&buff[BINARY_OFFSETS[index]], _toField<index>(record.values[index]), fieldSize(channels[index].type)), ...);
+	}
+
+	template<size_t... index>
+	static void _decodeValues(std::span<const uint8_t> buff, record_t& record, std::index_sequence<index...>)
+	{
+		((record.values[index]	  = _fromField<index>(static_cast<uint32_t>(_getLittleEndian(&buff[BINARY_OFFSETS[index]], fieldSize(channels[index].type))))), ...);
+		((record.captureMs[index] = record.timestampMs), ...);
+	}
+};
+
+} // namespace schema
@@ -0,0 +1,160 @@
+/**
+ * @file sample_cache.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Latest sample of each channel with its time, reused while it is fresh
+
+	Several paths want the current value of a channel: the measurement cycle, the terminal
+	stream and the HTTP requests. Each sample read from a sensor is stored with its capture
+	time, and a reader within the time to live gets the stored sample instead of triggering
+	a new conversion, so a channel costs at most one physical read per TTL.
+
+ * @version 0.1
+ * @date 2025-04-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t SAMPLE_CACHE_TTL_MS = 1000; // Default time a sample is served without reading the sensor again
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+template<size_t numChannels>
+class sampleCache
+{
+	static_assert(numChannels <= 32, "Fresh channels are reported in a 32 bit mask");
+
+  public:
+	/**
+	 * @brief Sets how long a sample is served, 0 disables the cache
+	 */
+	void setTtl(uint32_t ttlMs)
+	{
+		this->_ttlMs = ttlMs;
+	}
+
+	uint32_t getTtl() const
+	{
+		return this->_ttlMs;
+	}
+
+	/**
+	 * @brief Stores the latest sample of a channel
+	 *
+	 * @param channel channel index, out of range indexes are ignored
+	 * @param value sample
+	 * @param captureMs when the sample was taken, same monotonic clock as the reads
+	 */
+	void store(size_t channel, float value, uint64_t captureMs)
+	{
+		if (channel >= numChannels)
+		{
+			return;
+		}
+
+		this->_values[channel]	  = value;
+		this->_captureMs[channel] = captureMs;
+		this->_validChannels	 |= (1u << channel);
+	}
+
+	/**
+	 * @brief Latest sample of a channel, nullopt if there is none or it is older than the TTL
+	 *
+	 * @param now current time in milliseconds
+	 */
+	std::optional<float> lookup(size_t channel, uint64_t now)
+	{
+		if (false == this->_isFresh(channel, now))
+		{
+			this->_misses++;
+			return std::nullopt;
+		}
+
+		this->_hits++;
+
+		return this->_values[channel];
+	}
+
+	/**
+	 * @brief Latest sample of a channel whatever its age, nullopt if there is none
+	 */
+	std::optional<float> getLatest(size_t channel) const
+	{
+		if (channel >= numChannels || 0 == (this->_validChannels & (1u << channel)))
+		{
+			return std::nullopt;
+		}
+
+		return this->_values[channel];
+	}
+
+	/**
+	 * @brief Mask of the channels with a fresh sample, bit n is channel n
+	 */
+	uint32_t getFreshChannels(uint64_t now) const
+	{
+		uint32_t mask = 0;
+
+		for (size_t channel = 0; channel < numChannels; channel++)
+		{
+			if (true == this->_isFresh(channel, now))
+			{
+				mask |= (1u << channel);
+			}
+		}
+
+		return mask;
+	}
+
+	/**
+	 * @brief Lookups served from the cache
+	 */
+	uint32_t getHits() const
+	{
+		return this->_hits;
+	}
+
+	/**
+	 * @brief Lookups that needed a read
+	 */
+	uint32_t getMisses() const
+	{
+		return this->_misses;
+	}
+
+  private:
+	std::array<float, numChannels>	  _values{};
+	std::array<uint64_t, numChannels> _captureMs{};
+	uint32_t						  _validChannels = 0; /// Channels stored at least once
+	uint32_t						  _ttlMs		 = SAMPLE_CACHE_TTL_MS;
+	uint32_t						  _hits			 = 0;
+	uint32_t						  _misses		 = 0;
+
+	bool _isFresh(size_t channel, uint64_t now) const
+	{
+		if (channel >= numChannels || 0 == (this->_validChannels & (1u << channel)))
+		{
+			return false;
+		}
+
+		// A sample stamped after now comes from another clock, its age is unknown
+		return (now >= this->_captureMs[channel]) && (now - this->_captureMs[channel] < this->_ttlMs);
+	}
+};
@@ -0,0 +1,260 @@
+/**
+ * @file sampling_scheduler.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Multi rate scheduler deciding which channels are sampled on each call
+
+	Every channel has its own sampling period, a channel with period 0 is not scheduled
+	and is only sampled when a record is built. getDueChannels() is meant to be polled
+	from the superloop, it returns a bit mask of the channels whose period elapsed.
+
+	Deadlines advance by whole periods so the cadence does not drift with the polling
+	jitter, but a channel that missed several deadlines is sampled once, not in a burst.
+
+	A channel can also be adaptive: its period is then the slowest one, and the scheduler,
+	given every sample with addSample(), samples faster while the channel is active. A
+	channel is active when it changed more than its threshold over the last period, or
+	when the standard deviation of its recent samples is above the threshold. The period
+	then drops to the fastest one at once, so an event is captured from its start, and
+	grows back by ADAPTIVE_DECAY_PERCENT per quiet sample. The rate of change is measured
+	over a whole period, not between two fast samples, so noise is not taken for a trend.
+
+ * @version 0.1
+ * @date 2025-04-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t ADAPTIVE_DECAY_PERCENT	= 25;	 // Period increase per quiet sample of an adaptive channel
+constexpr float	   ADAPTIVE_WINDOW			= 8.0f;	 // Samples weighting the recent variance
+constexpr float	   ADAPTIVE_THRESHOLD_STEPS	= 10.0f; // Default threshold, in steps of the last decimal of the channel
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+template<size_t numChannels>
+class samplingScheduler
+{
+	static_assert(numChannels <= 32, "Channels are reported in a 32 bit mask");
+
+  public:
+	/**
+	 * @brief Sets the sampling period of a channel at a fixed rate, the channel is due on the next poll
+	 *
+	 * @param channel channel index, out of range indexes are ignored
+	 * @param periodMs period in milliseconds, 0 to stop scheduling the channel
+	 */
+	void setPeriod(size_t channel, uint32_t periodMs)
+	{
+		if (channel >= numChannels)
+		{
+			return;
+		}
+
+		this->_periods[channel]	  = periodMs;
+		this->_effective[channel] = periodMs;
+		this->_deadlines[channel] = 0;
+		this->_adaptiveChannels	 &= ~(1u << channel);
+	}
+
+	/**
+	 * @brief Configured period of a channel, the slowest one if it is adaptive
+	 */
+	uint32_t getPeriod(size_t channel) const
+	{
+		return (channel < numChannels) ? this->_periods[channel] : 0;
+	}
+
+	/**
+	 * @brief Makes a scheduled channel adaptive, between its period and a faster one
+	 *
+	 * @param channel channel index, out of range indexes are ignored
+	 * @param fastestPeriodMs shortest period, 0 or not shorter than the period for a fixed rate
+	 * @param threshold change over a period, or standard deviation, making the channel active, in channel units
+	 */
+	void setAdaptive(size_t channel, uint32_t fastestPeriodMs, float threshold)
+	{
+		if (channel >= numChannels)
+		{
+			return;
+		}
+
+		uint32_t channelMask = (1u << channel);
+
+		this->_fastest[channel]	  = fastestPeriodMs;
+		this->_threshold[channel] = threshold;
+		this->_effective[channel] = this->_periods[channel];
+		this->_primedChannels	 &= ~channelMask;
+
+		if (0 != fastestPeriodMs && fastestPeriodMs < this->_periods[channel])
+		{
+			this->_adaptiveChannels |= channelMask;
+		}
+		else
+		{
+			this->_adaptiveChannels &= ~channelMask;
+		}
+	}
+
+	/**
+	 * @brief Period the channel is sampled at now, the configured one unless it is adaptive
+	 */
+	uint32_t getEffectivePeriod(size_t channel) const
+	{
+		return (channel < numChannels) ? this->_effective[channel] : 0;
+	}
+
+	/**
+	 * @brief Mask of the adaptive channels, bit n is channel n
+	 */
+	uint32_t getAdaptiveChannels() const
+	{
+		return this->_adaptiveChannels;
+	}
+
+	/**
+	 * @brief Adapts the period of a channel to a new sample, ignored for fixed rate channels
+	 *
+	 * @param channel channel index
+	 * @param value sample
+	 * @param now time of the sample, same clock as getDueChannels()
+	 */
+	void addSample(size_t channel, float value, uint64_t now)
+	{
+		uint32_t channelMask = (channel < numChannels) ? (1u << channel) : 0;
+
+		if (0 == (this->_adaptiveChannels & channelMask))
+		{
+			return;
+		}
+
+		if (0 == (this->_primedChannels & channelMask))
+		{
+			this->_anchorValues[channel] = value;
+			this->_anchorMs[channel]	 = now;
+			this->_means[channel]		 = value;
+			this->_variances[channel]	 = 0.0f;
+			this->_primedChannels		|= channelMask;
+			return;
+		}
+
+		// Exponentially weighted variance of the recent samples
+		float difference		   = value - this->_means[channel];
+		float increment			   = difference / ADAPTIVE_WINDOW;
+		this->_means[channel]	  += increment;
+		this->_variances[channel]  = (this->_variances[channel] + difference * increment) * (1.0f - 1.0f / ADAPTIVE_WINDOW);
+
+		float threshold = this->_threshold[channel];
+		float change	= std::fabs(value - this->_anchorValues[channel]);
+		bool  active	= (change > threshold) || (this->_variances[channel] > threshold * threshold);
+
+		// Changes are measured against a sample at most one period old
+		if (true == active || now - this->_anchorMs[channel] >= this->_periods[channel])
+		{
+			this->_anchorValues[channel] = value;
+			this->_anchorMs[channel]	 = now;
+		}
+
+		uint32_t effective = this->_effective[channel];
+
+		if (true == active)
+		{
+			effective = this->_fastest[channel];
+		}
+		else
+		{
+			uint32_t increase = effective * ADAPTIVE_DECAY_PERCENT / 100u;
+			effective		  = std::min(this->_periods[channel], effective + ((0 != increase) ? increase : 1));
+		}
+
+		// A shorter period applies now, a longer one from the next deadline
+		if (effective < this->_effective[channel])
+		{
+			this->_deadlines[channel] = std::min(this->_deadlines[channel], now + effective);
+		}
+
+		this->_effective[channel] = effective;
+	}
+
+	/**
+	 * @brief Mask of the channels with a period, bit n is channel n
+	 */
+	uint32_t getScheduledChannels() const
+	{
+		uint32_t mask = 0;
+
+		for (size_t channel = 0; channel < numChannels; channel++)
+		{
+			if (0 != this->_periods[channel])
+			{
+				mask |= (1u << channel);
+			}
+		}
+
+		return mask;
+	}
+
+	/**
+	 * @brief Channels to sample now, their deadlines are moved to the next period
+	 *
+	 * @param now current time in milliseconds
+	 * @return uint32_t mask of due channels, bit n is channel n
+	 */
+	uint32_t getDueChannels(uint64_t now)
+	{
+		uint32_t mask = 0;
+
+		for (size_t channel = 0; channel < numChannels; channel++)
+		{
+			uint32_t period = this->_effective[channel];
+
+			if (0 == period)
+			{
+				continue;
+			}
+
+			if (now >= this->_deadlines[channel])
+			{
+				mask |= (1u << channel);
+
+				// Keep the cadence unless deadlines were missed, then restart from now
+				bool onTime				  = (now - this->_deadlines[channel] < period);
+				this->_deadlines[channel] = (true == onTime) ? this->_deadlines[channel] + period : now + period;
+			}
+		}
+
+		return mask;
+	}
+
+  private:
+	std::array<uint32_t, numChannels> _periods{};	/// Sampling period of each channel in milliseconds, 0 if not scheduled
+	std::array<uint32_t, numChannels> _effective{}; /// Period in use, between the fastest and the configured one
+	std::array<uint64_t, numChannels> _deadlines{}; /// Next time each channel is due
+
+	// Adaptive channels
+	std::array<uint32_t, numChannels> _fastest{};
+	std::array<float, numChannels>	  _threshold{};
+	std::array<float, numChannels>	  _anchorValues{}; /// Sample the change over a period is measured from
+	std::array<uint64_t, numChannels> _anchorMs{};
+	std::array<float, numChannels>	  _means{};
+	std::array<float, numChannels>	  _variances{};
+	uint32_t						  _adaptiveChannels = 0;
+	uint32_t						  _primedChannels	= 0; /// Adaptive channels with a first sample
+};
@@ -0,0 +1,307 @@
+/**
+ * @file window_statistics.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Per channel statistics of the samples taken during a logging window
+
+	Samples are kept in a structure of arrays, one block of contiguous floats per channel,
+	so the reduction kernels stream over plain arrays. When a block fills up it is reduced
+	into the running moments of the window and reused, the window length is not limited by
+	the buffer size.
+
+	The kernels are vectorized where the platform allows it: AVX or SSE on the host, and
+	four independent accumulators on the Cortex-M4, whose FPU is scalar but pipelined
+	(the same unrolling the CMSIS-DSP statistics functions use).
+
+	Sums are taken on the samples minus the first sample of the window, which keeps the
+	variance accurate in single precision for channels with a large offset, e.g. pressure.
+
+ * @version 0.1
+ * @date 2025-04-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if !defined(TARGET_MICRO) && (defined(__AVX__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr size_t STATS_BLOCK_SIZE = 32; // Samples buffered per channel before being reduced
+
+namespace statistics
+{
+
+////////////////////////////////////////////////////////////////////////
+//							    Types
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Moments of a set of samples, sums are of the samples minus a shift
+ */
+struct moments
+{
+	float	 sum		= 0.0f;
+	float	 sumSquares = 0.0f;
+	float	 min		= std::numeric_limits<float>::max();
+	float	 max		= std::numeric_limits<float>::lowest();
+	uint32_t count		= 0;
+};
+
+/**
+ * @brief Statistics of a channel over a window
+ */
+struct summary
+{
+	float	 mean	= 0.0f;
+	float	 min	= 0.0f;
+	float	 max	= 0.0f;
+	float	 stddev = 0.0f; /// Population standard deviation
+	float	 last	= 0.0f;
+	uint32_t count	= 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+//							    Kernels
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Reference kernel, one sample per iteration
+ *
+ * @param samples contiguous samples
+ * @param count number of samples
+ * @param shift value subtracted before summing
+ */
+inline moments reduceScalar(const float* samples, size_t count, float shift)
+{
+	moments result;
+
+	for (size_t index = 0; index < count; index++)
+	{
+		float value	  = samples[index];
+		float shifted = value - shift;
+
+		result.sum		  += shifted;
+		result.sumSquares += shifted * shifted;
+		result.min		   = (value < result.min) ? value : result.min;
+		result.max		   = (value > result.max) ? value : result.max;
+	}
+
+	result.count = static_cast<uint32_t>(count);
+
+	return result;
+}
+
+/**
+ * @brief Vectorized kernel, same result as reduceScalar() up to the summation order
+ */
+inline moments reduce(const float* samples, size_t count, float shift)
+{
+	size_t index = 0;
+	float  lanes[4][4];
+
+#if !defined(TARGET_MICRO) && defined(__AVX__)
+	__m256 vShift	   = _mm256_set1_ps(shift);
+	__m256 vSum		   = _mm256_setzero_ps();
+	__m256 vSumSquares = _mm256_setzero_ps();
+	__m256 vMin		   = _mm256_set1_ps(std::numeric_limits<float>::max());
+	__m256 vMax		   = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+
+	for (; index + 8 <= count; index += 8)
+	{
+		__m256 value   = _mm256_loadu_ps(samples + index);
+		__m256 shifted = _mm256_sub_ps(value, vShift);
+
+		vSum		= _mm256_add_ps(vSum, shifted);
+		vSumSquares = _mm256_add_ps(vSumSquares, _mm256_mul_ps(shifted, shifted));
+		vMin		= _mm256_min_ps(vMin, value);
+		vMax		= _mm256_max_ps(vMax, value);
+	}
+
+	// Fold the two halves so the rest of the reduction is shared with SSE
+	_mm_storeu_ps(lanes[0], _mm_add_ps(_mm256_castps256_ps128(vSum), _mm256_extractf128_ps(vSum, 1)));
+	_mm_storeu_ps(lanes[1], _mm_add_ps(_mm256_castps256_ps128(vSumSquares), _mm256_extractf128_ps(vSumSquares, 1)));
+	_mm_storeu_ps(lanes[2], _mm_min_ps(_mm256_castps256_ps128(vMin), _mm256_extractf128_ps(vMin, 1)));
+	_mm_storeu_ps(lanes[3], _mm_max_ps(_mm256_castps256_ps128(vMax), _mm256_extractf128_ps(vMax, 1)));
+#elif !defined(TARGET_MICRO) && defined(__SSE2__)
+	__m128 vShift	   = _mm_set1_ps(shift);
+	__m128 vSum		   = _mm_setzero_ps();
+	__m128 vSumSquares = _mm_setzero_ps();
+	__m128 vMin		   = _mm_set1_ps(std::numeric_limits<float>::max());
+	__m128 vMax		   = _mm_set1_ps(std::numeric_limits<float>::lowest());
+
+	for (; index + 4 <= count; index += 4)
+	{
+		__m128 value   = _mm_loadu_ps(samples + index);
+		__m128 shifted = _mm_sub_ps(value, vShift);
+
+		vSum		= _mm_add_ps(vSum, shifted);
+		vSumSquares = _mm_add_ps(vSumSquares, _mm_mul_ps(shifted, shifted));
+		vMin		= _mm_min_ps(vMin, value);
+		vMax		= _mm_max_ps(vMax, value);
+	}
+
+	_mm_storeu_ps(lanes[0], vSum);
+	_mm_storeu_ps(lanes[1], vSumSquares);
+	_mm_storeu_ps(lanes[2], vMin);
+	_mm_storeu_ps(lanes[3], vMax);
+#else
+	// Four independent accumulators keep the FPU pipeline busy
+	for (size_t lane = 0; lane < 4; lane++)
+	{
+		lanes[0][lane] = 0.0f;
+		lanes[1][lane] = 0.0f;
+		lanes[2][lane] = std::numeric_limits<float>::max();
+		lanes[3][lane] = std::numeric_limits<float>::lowest();
+	}
+
+	for (; index + 4 <= count; index += 4)
+	{
+		for (size_t lane = 0; lane < 4; lane++)
+		{
+			float value	  = samples[index + lane];
+			float shifted = value - shift;
+
+			lanes[0][lane] += shifted;
+			lanes[1][lane] += shifted * shifted;
+			lanes[2][lane]	= (value < lanes[2][lane]) ? value : lanes[2][lane];
+			lanes[3][lane]	= (value > lanes[3][lane]) ? value : lanes[3][lane];
+		}
+	}
+#endif
+
+	// Remaining samples, then the lanes
+	moments result = reduceScalar(samples + index, count - index, shift);
+
+	for (size_t lane = 0; lane < 4; lane++)
+	{
+		result.sum		  += lanes[0][lane];
+		result.sumSquares += lanes[1][lane];
+		result.min		   = (lanes[2][lane] < result.min) ? lanes[2][lane] : result.min;
+		result.max		   = (lanes[3][lane] > result.max) ? lanes[3][lane] : result.max;
+	}
+
+	result.count = static_cast<uint32_t>(count);
+
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Accumulates the samples of a set of channels and summarizes them per window
+ *
+ * @tparam numChannels number of channels
+ * @tparam blockSize samples buffered per channel before being reduced
+ */
+template<size_t numChannels, size_t blockSize = STATS_BLOCK_SIZE>
+class windowStatistics
+{
+  public:
+	/**
+	 * @brief Adds a sample to the current window of a channel
+	 *
+	 * @param channel channel index, out of range indexes are ignored
+	 */
+	void add(size_t channel, float value)
+	{
+		if (channel >= numChannels)
+		{
+			return;
+		}
+
+		if (0 == this->_window[channel].count && 0 == this->_blockCount[channel])
+		{
+			this->_shift[channel] = value;
+		}
+
+		this->_samples[channel][this->_blockCount[channel]++] = value;
+		this->_last[channel]								  = value;
+
+		if (blockSize == this->_blockCount[channel])
+		{
+			this->_reduceBlock(channel);
+		}
+	}
+
+	/**
+	 * @brief Samples in the current window of a channel
+	 */
+	uint32_t getCount(size_t channel) const
+	{
+		return (channel < numChannels) ? this->_window[channel].count + static_cast<uint32_t>(this->_blockCount[channel]) : 0;
+	}
+
+	/**
+	 * @brief Summarizes the current window of a channel and starts a new one
+	 *
+	 * @return summary with count 0 if the window has no samples
+	 */
+	summary close(size_t channel)
+	{
+		summary result;
+
+		if (0 == this->getCount(channel))
+		{
+			return result;
+		}
+
+		this->_reduceBlock(channel);
+
+		const moments& window	= this->_window[channel];
+		float		   count	= static_cast<float>(window.count);
+		float		   mean		= window.sum / count;
+		float		   variance = window.sumSquares / count - mean * mean;
+
+		result.mean	  = this->_shift[channel] + mean;
+		result.min	  = window.min;
+		result.max	  = window.max;
+		result.stddev = (variance > 0.0f) ? std::sqrt(variance) : 0.0f;
+		result.last	  = this->_last[channel];
+		result.count  = window.count;
+
+		this->_window[channel] = moments{};
+
+		return result;
+	}
+
+  private:
+	std::array<std::array<float, blockSize>, numChannels> _samples{};	 /// One block of contiguous samples per channel
+	std::array<size_t, numChannels>						  _blockCount{}; /// Samples in each block
+	std::array<moments, numChannels>					  _window{};	 /// Moments of the reduced blocks of the window
+	std::array<float, numChannels>						  _shift{};		 /// First sample of the window
+	std::array<float, numChannels>						  _last{};
+
+	void _reduceBlock(size_t channel)
+	{
+		moments	 block	= reduce(this->_samples[channel].data(), this->_blockCount[channel], this->_shift[channel]);
+		moments& window = this->_window[channel];
+
+		window.sum		  += block.sum;
+		window.sumSquares += block.sumSquares;
+		window.min		   = (block.min < window.min) ? block.min : window.min;
+		window.max		   = (block.max > window.max) ? block.max : window.max;
+		window.count	  += block.count;
+
+		this->_blockCount[channel] = 0;
+	}
+};
+
+} // namespace statistics
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sensorConversion.hpp"
 #include <cstdint>
 #include <optional>
 
@@ -19,6 +20,27 @@ class IHygrometer
 	{
 		return static_cast<H*>(this)->readHumidityImpl();
 	}
+
+	/**
+	 * @brief Triggers a conversion and returns without waiting for it
+	 */
+	bool startHumidity()
+	{
+		return static_cast<H*>(this)->startConversionImpl();
+	}
+
+	conversionStatus pollHumidity()
+	{
+		return static_cast<H*>(this)->pollConversionImpl();
+	}
+
+	/**
+	 * @brief Result of the last conversion, nullopt until pollHumidity() reports READY
+	 */
+	std::optional<uint8_t> collectHumidity()
+	{
+		return static_cast<H*>(this)->collectHumidityImpl();
+	}
 };
 
 } // namespace sensor::hygrometer
\ No newline at end of file
@@ -0,0 +1,102 @@
+/**
+ * @file IMultiQuantity.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Interface for devices that measure several quantities in one conversion
+
+	A device such as the AHT21 returns temperature and humidity from the same conversion,
+	reading each quantity on its own repeats the whole conversion. sample() runs it once
+	and keeps every quantity, the channels of the device are then read from the kept
+	values. The processing manager calls sample() once per acquisition of the device.
+
+	The implementing class provides bool sampleImpl(std::array<float, N>&), filling the
+	quantities in channel order.
+
+	Devices with non blocking conversions (see sensorConversion.hpp) also provide
+	startConversionImpl(), pollConversionImpl() and collectImpl(std::array<float, N>&),
+	which enable startSample() and pollSample(). The processing manager then triggers the
+	conversion and keeps acquiring the other sensors while it runs.
+
+ * @version 0.1
+ * @date 2025-04-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include "sensorConversion.hpp"
+#include <array>
+#include <cstddef>
+#include <optional>
+
+namespace sensor
+{
+
+template<typename T, size_t numQuantities>
+class IMultiQuantity
+{
+  public:
+	/**
+	 * @brief Runs one conversion and keeps all its quantities
+	 *
+	 * @return true if the conversion succeeded
+	 */
+	bool sample()
+	{
+		_valid = static_cast<T*>(this)->sampleImpl(_quantities);
+
+		return _valid;
+	}
+
+	/**
+	 * @brief Triggers a conversion and returns without waiting for it
+	 */
+	bool startSample()
+		requires requires(T& device) { device.startConversionImpl(); }
+	{
+		return static_cast<T*>(this)->startConversionImpl();
+	}
+
+	/**
+	 * @brief Advances the conversion started by startSample(), keeps its quantities once READY
+	 */
+	conversionStatus pollSample()
+		requires requires(T& device) { device.pollConversionImpl(); }
+	{
+		conversionStatus status = static_cast<T*>(this)->pollConversionImpl();
+
+		if (conversionStatus::READY == status)
+		{
+			_valid = static_cast<T*>(this)->collectImpl(_quantities);
+		}
+		else if (conversionStatus::FAILED == status)
+		{
+			_valid = false;
+		}
+
+		return status;
+	}
+
+	/**
+	 * @brief Quantity of the last conversion, nullopt if it failed or never ran
+	 */
+	template<size_t quantity>
+	std::optional<float> getSample() const
+	{
+		static_assert(quantity < numQuantities, "Quantity out of range");
+
+		if (false == _valid)
+		{
+			return std::nullopt;
+		}
+
+		return _quantities[quantity];
+	}
+
+  private:
+	std::array<float, numQuantities> _quantities{};
+	bool							 _valid = false;
+};
+
+} // namespace sensor
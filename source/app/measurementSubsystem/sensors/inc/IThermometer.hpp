@@ -1,4 +1,5 @@
 #pragma once
+#include "sensorConversion.hpp"
 #include <optional>
 
 namespace sensor::thermometer
@@ -17,6 +18,27 @@ class IThermometer
 	{
 		return static_cast<T*>(this)->readTemperatureImpl();
 	}
+
+	/**
+	 * @brief Triggers a conversion and returns without waiting for it
+	 */
+	bool startTemperature()
+	{
+		return static_cast<T*>(this)->startConversionImpl();
+	}
+
+	conversionStatus pollTemperature()
+	{
+		return static_cast<T*>(this)->pollConversionImpl();
+	}
+
+	/**
+	 * @brief Result of the last conversion, nullopt until pollTemperature() reports READY
+	 */
+	std::optional<float> collectTemperature()
+	{
+		return static_cast<T*>(this)->collectTemperatureImpl();
+	}
 };
 
 } // namespace sensor::thermometer
\ No newline at end of file
@@ -1,8 +1,16 @@
 #pragma once
 
+#include "IMultiQuantity.hpp"
+#include "sensorChannel.hpp"
+#include "virtualCapture.hpp"
+#include "windVector.hpp"
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <virtualADC.hpp>
 
+constexpr float ANEMOMETER_MS_PER_HZ = 1.006f; // Davis cups, one pulse per turn, 1600 turns/h is 1 mph
+
 namespace sensor
 {
 
@@ -10,19 +18,72 @@ template<typename A>
 class IAnemometer
 {
   public:
-	uint16_t getWindSpeed()
+	float getWindSpeed()
 	{
 		return static_cast<A*>(this)->getWindSpeedImpl();
 	}
 };
 
-class anemometerDavis : public IAnemometer<anemometerDavis>
+/**
+ * @brief Davis cup anemometer, one pulse per turn measured by timer input capture
+ *
+ * Pulses are timestamped in hardware, see virtualCapture.hpp. update() is meant to be
+ * called from the superloop, getWindSpeed() is the speed of the last turn. The channels
+ * report the mean speed and the 3 second gust since the previous record, and start a new
+ * window, they are meant to be read once per record.
+ */
+class anemometerDavis : public IAnemometer<anemometerDavis>, public IMultiQuantity<anemometerDavis, 2>
 {
   public:
-	uint16_t getWindSpeedImpl()
+	// clang-format off
+	static constexpr std::array<channelInfo, 2> channels = {{{"windSpeed", "m/s", 1, fieldType::UINT16},
+															 {"windGust", "m/s", 1, fieldType::UINT16}}};
+	// clang-format on
+
+	bool init()
+	{
+		return captureObj.init();
+	}
+
+	template<size_t channel>
+	float readChannel()
+	{
+		return this->template getSample<channel>().value_or(0.0f);
+	}
+
+	/**
+	 * @brief Consumes the captured pulses
+	 */
+	void update()
+	{
+		captureObj.update();
+	}
+
+	/**
+	 * @brief Speed of the last turn in m/s
+	 */
+	float getWindSpeedImpl()
 	{
-		return 0; // todo
+		return ANEMOMETER_MS_PER_HZ * captureObj.getFrequency();
+	}
+
+	/**
+	 * @brief Mean speed and gust of the window, then starts a new one
+	 */
+	bool sampleImpl(std::array<float, 2>& quantities)
+	{
+		captureObj.update();
+
+		quantities[0] = ANEMOMETER_MS_PER_HZ * captureObj.getAverageFrequency();
+		quantities[1] = ANEMOMETER_MS_PER_HZ * captureObj.getGustFrequency();
+
+		captureObj.closeWindow();
+
+		return true;
 	}
+
+  private:
+	virtualDevice::virtualCapture captureObj;
 };
 
 template<typename V>
@@ -35,18 +96,86 @@ class IWindVane
 	}
 };
 
+/**
+ * @brief Davis wind vane, a potentiometer read through an ADC input
+ *
+ * getWindDir() is the instantaneous direction. For records the vane is sampled with
+ * addSample() at a high rate, e.g. with every anemometer speed, and its channels report
+ * the vector mean direction of the window and the direction of its gust, see windVector.hpp.
+ * The channels close the window, they are meant to be read once per record.
+ */
 template<typename ADC>
-class windVaneDavis : public IWindVane<windVaneDavis<ADC>>
+class windVaneDavis : public IWindVane<windVaneDavis<ADC>>, public IMultiQuantity<windVaneDavis<ADC>, 2>
 {
   public:
-	windVaneDavis(ADC& adc) : _adc(adc) {}
+	// clang-format off
+	static constexpr std::array<channelInfo, 2> channels = {{{"windDirection", "deg", 0, fieldType::UINT16},
+															 {"windGustDirection", "deg", 0, fieldType::UINT16}}};
+	// clang-format on
+
+	/**
+	 * @param adc converter reading the wiper voltage
+	 * @param input converter input the wiper is connected to
+	 */
+	windVaneDavis(ADC& adc, uint8_t input = 0) : _adc(adc), _input(input) {}
+
+	bool init()
+	{
+		return true;
+	}
+
+	template<size_t channel>
+	float readChannel()
+	{
+		return this->template getSample<channel>().value_or(0.0f);
+	}
+
 	uint16_t getWindDirImpl()
 	{
-		return 0; // todo
+		return wind::vaneDirection(_adc.readVoltage(_input));
+	}
+
+	/**
+	 * @brief Reads the direction and adds it to the window
+	 *
+	 * @param speed wind speed at the time of the reading, weights the direction, 0 if unknown
+	 */
+	void addSample(float speed)
+	{
+		_averager.add(this->getWindDir(), speed);
+	}
+
+	/**
+	 * @brief Closes the window, a window without samples gets the instantaneous direction
+	 */
+	bool sampleImpl(std::array<float, 2>& quantities)
+	{
+		if (0 == _averager.getCount())
+		{
+			this->addSample(0.0f);
+		}
+
+		_summary = _averager.close();
+
+		quantities[0] = static_cast<float>(_summary.meanDirection);
+		quantities[1] = static_cast<float>(_summary.gustDirection);
+
+		return true;
+	}
+
+	/**
+	 * @brief Wind of the last closed window, speeds are in the unit given to addSample()
+	 */
+	const windSummary& getWindSummary() const
+	{
+		return _summary;
 	}
 
   private:
-	ADC& _adc;
+	ADC&			   _adc;
+	uint8_t			   _input;
+	windVectorAverager _averager;
+	windSummary		   _summary;
 };
 
 }; // namespace sensor
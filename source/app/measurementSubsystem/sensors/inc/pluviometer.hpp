@@ -1,6 +1,10 @@
 #pragma once
 
+#include "sensorChannel.hpp"
 #include "virtualCounter.hpp"
+#include "virtualTimer.hpp"
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace sensor
@@ -10,23 +14,76 @@ template<typename P>
 class IPluviometer
 {
   public:
-	uint16_t getRain()
+	float getRain()
 	{
 		return static_cast<P*>(this)->getRainImpl();
 	}
+
+	float getRainRate(uint32_t nowMs)
+	{
+		return static_cast<P*>(this)->getRainRateImpl(nowMs);
+	}
 };
 
+/**
+ * @brief Davis tipping bucket rain gauge, one pulse per bucket tip
+ *
+ * Tips are counted by interrupt, see virtualCounter.hpp. The rain channel is the rain
+ * since the previous read, it is meant to be read once per record. The rain rate comes
+ * from the interval between the last two tips.
+ */
 class davisPluviometer : public IPluviometer<davisPluviometer>
 {
   public:
-	uint16_t getRainImpl()
+	// clang-format off
+	static constexpr std::array<channelInfo, 2> channels = {{{"rain", "mm", 1, fieldType::UINT16},
+															 {"rainRate", "mm/h", 1, fieldType::UINT16}}};
+	// clang-format on
+
+	bool init()
+	{
+		return counterObj.init();
+	}
+
+	template<size_t channel>
+	float readChannel()
+	{
+		if constexpr (0 == channel)
+		{
+			return this->getRain();
+		}
+		else
+		{
+			return this->getRainRate(static_cast<uint32_t>(systick::getTicks()));
+		}
+	}
+
+	/**
+	 * @brief Rain since the previous call, in mm
+	 */
+	float getRainImpl()
+	{
+		return pluviometerConstant * static_cast<float>(counterObj.readandResetCounter());
+	}
+
+	/**
+	 * @brief Rain rate in mm/h
+	 *
+	 * @param nowMs current time in milliseconds, same clock as the tip timestamps
+	 */
+	float getRainRateImpl(uint32_t nowMs)
+	{
+		return pluviometerConstant * counterObj.getPulseRate(nowMs);
+	}
+
+	virtualDevice::virtualCounter& getCounter()
 	{
-		return pluviometerConstant * counterObj.readandResetCounter(); // todo
+		return counterObj;
 	}
 
   private:
 	virtualDevice::virtualCounter counterObj;
-	static constexpr float		  pluviometerConstant = 0.2; // maybe this should be possible to write during run time if there's a change in the pluviometer type
+	static constexpr float		  pluviometerConstant = 0.2f; // maybe this should be possible to write during run time if there's a change in the pluviometer type
 };
 
-} // namespace sensor
\ No newline at end of file
+} // namespace sensor
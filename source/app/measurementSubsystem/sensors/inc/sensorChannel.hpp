@@ -0,0 +1,57 @@
+/**
+ * @file sensorChannel.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Compile time description of the quantities a sensor measures
+
+	A sensor used by the processing manager declares its channels with a static constexpr
+	std::array<channelInfo, N> named channels, and reads them with a member function
+	template readChannel<I>() returning a float, I being the index in channels. A sensor
+	whose reads can fail returns a std::optional<float> instead, a failed read is skipped
+	and the channel is recorded as missing. It also provides init(). The processing
+	manager generates acquisition and formatting from these declarations, so adding a
+	sensor does not change the manager.
+
+	A sensor implementing IMultiQuantity is sampled once per acquisition, its channels
+	then read the shared conversion.
+
+	The declarations are also the record schema, see record_schema.hpp. Binary records
+	store each value as an integer scaled by 10^decimals, in the declared type.
+
+ * @version 0.1
+ * @date 2025-04-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace sensor
+{
+
+/**
+ * @brief Storage type of a channel in binary records
+ */
+enum class fieldType : uint8_t
+{
+	UINT8,
+	UINT16,
+	INT16,
+	INT32,
+	FLOAT32 /// Stored unscaled
+};
+
+/**
+ * @brief One quantity measured by a sensor
+ */
+struct channelInfo
+{
+	const char* name;	  /// Field name in records, e.g. "temperature"
+	const char* unit;	  /// Unit of the value, e.g. "degC"
+	uint8_t		decimals; /// Decimals written in text records, binary values are scaled by 10^decimals
+	fieldType	type;	  /// Storage type in binary records
+};
+
+} // namespace sensor
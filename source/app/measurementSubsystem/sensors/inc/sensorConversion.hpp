@@ -0,0 +1,33 @@
+/**
+ * @file sensorConversion.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief State of a non blocking sensor conversion
+
+	Sensors with a long conversion time offer a start/poll/collect sequence instead of
+	blocking until the result is ready: start triggers the conversion and returns, poll
+	reports its state without waiting, and collect returns the result once poll reports
+	READY. A conversion not ready within the sensor timeout is reported as FAILED.
+
+ * @version 0.1
+ * @date 2025-04-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace sensor
+{
+
+enum class conversionStatus : uint8_t
+{
+	IDLE,  /// No conversion started
+	BUSY,  /// Conversion in progress
+	READY, /// Result available to collect
+	FAILED /// The conversion could not be started, read or timed out
+};
+
+} // namespace sensor
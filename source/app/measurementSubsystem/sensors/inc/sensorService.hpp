@@ -1,47 +1,75 @@
 #pragma once
 
+#include "virtualTimer.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 
 class sensorServiceInterface
 {
   public:
-	virtual float	requestADCVoltage()	 = 0;
-	virtual float	requestTemperature() = 0;
-	virtual uint8_t requestHumidity()	 = 0;
-	virtual ~sensorServiceInterface()	 = default;
+	virtual float				   requestADCVoltage()	= 0;
+	virtual std::optional<float>   requestTemperature() = 0;
+	virtual std::optional<uint8_t> requestHumidity()	= 0;
+	virtual ~sensorServiceInterface()					= default;
 };
 
-template<typename ADC, typename TThermometer, typename THygrometer>
+/**
+ * @brief Current sensor values for the configuration subsystem
+ *
+ * Temperature and humidity are taken from the processing manager sample cache, so the
+ * terminal shares the conversions of the measurement cycle instead of triggering its own,
+ * see processingManager::getLatestSample(). The ADC voltage is served by the scanner.
+ * Temperature and humidity are nullopt when the channel was never read successfully.
+ *
+ * @tparam ADC analog converter
+ * @tparam TMeasurements processingManager measuring the "temperature" and "humidity" channels
+ */
+template<typename ADC, typename TMeasurements>
 class sensorService : public sensorServiceInterface
 {
   public:
-	// clang-format off
-	sensorService(ADC& adc,
-				  TThermometer& thermometer,
-		  		  THygrometer& hygrometer) :
-				  _adc(adc),
-				  _thermometer(thermometer),
-				  _hygrometer(hygrometer) {}
-	// clang-format on
+	sensorService(ADC& adc, TMeasurements& measurements) : _adc(adc), _measurements(measurements) {}
 
 	float requestADCVoltage()
 	{
 		return _adc.readVoltage(0);
 	}
 
-	float requestTemperature()
+	std::optional<float> requestTemperature()
 	{
-		return _thermometer.readTemperature().value_or(255.0);
+		return _request<TEMPERATURE_CHANNEL>();
 	}
 
-	uint8_t requestHumidity()
+	std::optional<uint8_t> requestHumidity()
 	{
-		return _hygrometer.readHumidity().value_or(255);
+		std::optional<float> humidity = _request<HUMIDITY_CHANNEL>();
+
+		if (false == humidity.has_value())
+		{
+			return std::nullopt;
+		}
+
+		return static_cast<uint8_t>(*humidity);
 	}
 
   private:
-	ADC&		  _adc;
-	TThermometer& _thermometer;
-	THygrometer&  _hygrometer;
-};
\ No newline at end of file
+	static constexpr int TEMPERATURE_CHANNEL = TMeasurements::findChannel("temperature");
+	static constexpr int HUMIDITY_CHANNEL	 = TMeasurements::findChannel("humidity");
+
+	ADC&		   _adc;
+	TMeasurements& _measurements;
+
+	template<int channel>
+	std::optional<float> _request()
+	{
+		if constexpr (channel < 0)
+		{
+			return std::nullopt;
+		}
+		else
+		{
+			return _measurements.getLatestSample(static_cast<size_t>(channel), systick::getTicks());
+		}
+	}
+};
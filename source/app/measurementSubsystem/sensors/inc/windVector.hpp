@@ -0,0 +1,259 @@
+/**
+ * @file windVector.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Wind vane lookup tables and vector averaging of wind samples
+
+	Directions can not be averaged arithmetically, the mean of 350 and 10 degrees is north,
+	not south. Each sample is decomposed in its east and north components, the components
+	are summed over the window and the mean direction is the angle of the resulting vector.
+	Components are weighted by the wind speed so light variable winds do not dominate, and
+	the unweighted sum is kept for windows without speed, e.g. calm.
+
+	Sines and cosines come from a table generated at compile time with one entry per degree,
+	a sample costs two table reads and four multiply-adds. The only trig call is the atan2
+	computing the mean direction when the window is closed.
+
+ * @version 0.1
+ * @date 2025-04-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr float	   WIND_VANE_SUPPLY_V	= 3.3f; // Voltage across the vane potentiometer
+constexpr uint16_t WIND_VANE_OFFSET_DEG = 0;	// Direction read when the vane points north, set when mounting
+constexpr size_t   WIND_VANE_LUT_SIZE	= 256;	// Steps of the voltage to direction table
+constexpr uint16_t DEGREES_IN_CIRCLE	= 360;
+
+namespace sensor
+{
+
+////////////////////////////////////////////////////////////////////////
+//							    Tables
+////////////////////////////////////////////////////////////////////////
+
+namespace wind
+{
+
+/**
+ * @brief Sine of an angle in degrees, Taylor series usable at compile time
+ */
+constexpr double sinDegrees(uint16_t degrees)
+{
+	constexpr double pi = 3.14159265358979323846;
+
+	// Reduce to [-90, 90] degrees where the series converges quickly
+	int	   angle = degrees % DEGREES_IN_CIRCLE;
+	double sign	 = 1.0;
+
+	if (angle > 180)
+	{
+		angle -= 360;
+	}
+	if (angle > 90)
+	{
+		angle = 180 - angle;
+	}
+	else if (angle < -90)
+	{
+		angle = -180 - angle;
+	}
+	if (angle < 0)
+	{
+		angle = -angle;
+		sign  = -1.0;
+	}
+
+	double x	  = angle * pi / 180.0;
+	double term	  = x;
+	double result = x;
+
+	for (int n = 1; n < 10; n++)
+	{
+		term   *= -x * x / ((2 * n) * (2 * n + 1));
+		result += term;
+	}
+
+	return sign * result;
+}
+
+/**
+ * @brief Sine of each whole degree, the cosine is read 90 degrees ahead
+ */
+inline constexpr std::array<float, DEGREES_IN_CIRCLE> sineTable = []
+{
+	std::array<float, DEGREES_IN_CIRCLE> table{};
+
+	for (uint16_t degrees = 0; degrees < DEGREES_IN_CIRCLE; degrees++)
+	{
+		table[degrees] = static_cast<float>(sinDegrees(degrees));
+	}
+
+	return table;
+}();
+
+/**
+ * @brief Direction of each step of the vane voltage, the potentiometer is linear over the circle
+ */
+inline constexpr std::array<uint16_t, WIND_VANE_LUT_SIZE> vaneTable = []
+{
+	std::array<uint16_t, WIND_VANE_LUT_SIZE> table{};
+
+	for (size_t step = 0; step < WIND_VANE_LUT_SIZE; step++)
+	{
+		uint32_t degrees = static_cast<uint32_t>((step * DEGREES_IN_CIRCLE + WIND_VANE_LUT_SIZE / 2) / WIND_VANE_LUT_SIZE);
+		table[step]		 = static_cast<uint16_t>((degrees + WIND_VANE_OFFSET_DEG) % DEGREES_IN_CIRCLE);
+	}
+
+	return table;
+}();
+
+inline float sine(uint16_t degrees)
+{
+	return sineTable[degrees % DEGREES_IN_CIRCLE];
+}
+
+inline float cosine(uint16_t degrees)
+{
+	return sineTable[(degrees + 90u) % DEGREES_IN_CIRCLE];
+}
+
+/**
+ * @brief Direction pointed by the vane for a wiper voltage
+ *
+ * @param volts wiper voltage, clamped to [0, WIND_VANE_SUPPLY_V]
+ * @return uint16_t direction in degrees, 0 is north, clockwise
+ */
+inline uint16_t vaneDirection(float volts)
+{
+	float ratio = volts / WIND_VANE_SUPPLY_V;
+
+	ratio = (ratio < 0.0f) ? 0.0f : ((ratio > 1.0f) ? 1.0f : ratio);
+
+	return vaneTable[static_cast<size_t>(ratio * static_cast<float>(WIND_VANE_LUT_SIZE - 1) + 0.5f)];
+}
+
+} // namespace wind
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Wind over a window
+ */
+struct windSummary
+{
+	uint16_t meanDirection = 0;	   /// Degrees, 0 is north, clockwise
+	float	 vectorSpeed   = 0.0f; /// Speed of the mean wind vector
+	float	 scalarSpeed   = 0.0f; /// Mean of the speeds
+	float	 gustSpeed	   = 0.0f; /// Highest speed sampled
+	uint16_t gustDirection = 0;	   /// Direction of the highest speed
+	float	 steadiness	   = 0.0f; /// vectorSpeed / scalarSpeed, 1 for a constant direction
+	uint32_t count		   = 0;
+};
+
+/**
+ * @brief Accumulates wind samples as vectors and summarizes them per window
+ */
+class windVectorAverager
+{
+  public:
+	/**
+	 * @brief Adds a sample to the window
+	 *
+	 * @param directionDeg direction in degrees, 0 is north, clockwise
+	 * @param speed wind speed, 0 if unknown
+	 */
+	void add(uint16_t directionDeg, float speed)
+	{
+		float east	= wind::sine(directionDeg);
+		float north = wind::cosine(directionDeg);
+
+		this->_eastWeighted	 += speed * east;
+		this->_northWeighted += speed * north;
+		this->_east			 += east;
+		this->_north		 += north;
+		this->_speedSum		 += speed;
+
+		if (0 == this->_count || speed > this->_gustSpeed)
+		{
+			this->_gustSpeed	 = speed;
+			this->_gustDirection = directionDeg % DEGREES_IN_CIRCLE;
+		}
+
+		this->_count++;
+	}
+
+	uint32_t getCount() const
+	{
+		return this->_count;
+	}
+
+	/**
+	 * @brief Summarizes the window and starts a new one
+	 *
+	 * @return summary with count 0 if the window has no samples
+	 */
+	windSummary close()
+	{
+		windSummary result;
+
+		if (0 == this->_count)
+		{
+			return result;
+		}
+
+		float count = static_cast<float>(this->_count);
+
+		// Without speed, e.g. calm or no anemometer, every sample weighs the same
+		bool  weighted = (this->_speedSum > 0.0f);
+		float east	   = (true == weighted) ? this->_eastWeighted : this->_east;
+		float north	   = (true == weighted) ? this->_northWeighted : this->_north;
+		float degrees  = std::atan2(east, north) * (180.0f / 3.14159265f);
+
+		if (degrees < 0.0f)
+		{
+			degrees += static_cast<float>(DEGREES_IN_CIRCLE);
+		}
+
+		result.meanDirection = static_cast<uint16_t>(static_cast<uint16_t>(degrees + 0.5f) % DEGREES_IN_CIRCLE);
+		result.vectorSpeed	 = std::sqrt(this->_eastWeighted * this->_eastWeighted + this->_northWeighted * this->_northWeighted) / count;
+		result.scalarSpeed	 = this->_speedSum / count;
+		result.gustSpeed	 = this->_gustSpeed;
+		result.gustDirection = this->_gustDirection;
+		result.steadiness	 = (true == weighted) ? result.vectorSpeed / result.scalarSpeed : std::sqrt(east * east + north * north) / count;
+		result.count		 = this->_count;
+
+		*this = windVectorAverager{};
+
+		return result;
+	}
+
+  private:
+	float	 _eastWeighted	= 0.0f; /// Sum of speed * sin(direction)
+	float	 _northWeighted = 0.0f; /// Sum of speed * cos(direction)
+	float	 _east			= 0.0f; /// Sum of sin(direction)
+	float	 _north			= 0.0f; /// Sum of cos(direction)
+	float	 _speedSum		= 0.0f;
+	float	 _gustSpeed		= 0.0f;
+	uint16_t _gustDirection = 0;
+	uint32_t _count			= 0;
+};
+
+} // namespace sensor
@@ -0,0 +1,264 @@
+/**
+ * @file sampleRing.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Shared memory protocol between the sensor simulator producers and the firmware
+
+	The producer pushes timestamped samples into a ring in shared memory and the consumer
+	drains every sample it has not read yet. Each slot is a seqlock, so the producer never
+	waits for the consumer and the consumer never sees a sample half written. Producers may
+	be written in any language following the layout below, see sensorSimulatorProducer.py.
+
+	Layout, little endian, offsets in bytes:
+
+	Header, 64 bytes at offset 0
+	  0  uint32  magic        SAMPLE_RING_MAGIC, "GLSS"
+	  4  uint16  version      SAMPLE_RING_VERSION
+	  6  uint16  slotSize     sizeof(ringSlot), 24
+	  8  uint32  capacity     number of slots
+	  12 uint32  reserved
+	  16 uint64  writeIndex   samples published since the ring was created
+	  24 ...     reserved up to 64
+
+	Slots, capacity slots of 24 bytes from offset 64, sample n is in slot n % capacity
+	  0  uint64  sequence     2n + 1 while sample n is written, 2n + 2 once it is complete
+	  8  uint64  timestampMs  producer time of the sample
+	  16 uint32  channel      sampleChannel
+	  20 float32 value        pulses for counters, volts for analog inputs
+
+	To publish sample n the producer stores 2n + 1 in the sequence, then the fields, then
+	2n + 2, then n + 1 in writeIndex, each store visible after the previous one. Sequence
+	and writeIndex are single aligned 64 bit stores.
+
+	The consumer reads the sequence, the fields and the sequence again. The sample is kept
+	only if both reads are 2n + 2. A larger sequence means the producer lapped the consumer,
+	the samples overwritten are counted as lost and reading resumes at the oldest one left.
+
+ * @version 0.1
+ * @date 2025-04-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t SAMPLE_RING_MAGIC	   = 0x53534c47; // "GLSS" in memory
+constexpr uint16_t SAMPLE_RING_VERSION	   = 1;
+constexpr uint32_t SAMPLE_RING_CAPACITY	   = 1024;		 // Slots created by the consumer, bursts up to this are not lost
+constexpr size_t   SAMPLE_RING_HEADER_SIZE = 64;
+
+namespace sensorSimulator
+{
+
+////////////////////////////////////////////////////////////////////////
+//							     Types
+////////////////////////////////////////////////////////////////////////
+
+enum class sampleChannel : uint32_t
+{
+	RAIN		   = 0, /// Rain gauge pulses
+	WIND_SPEED	   = 1, /// Anemometer pulses
+	WIND_DIRECTION = 2, /// Wind vane volts
+};
+
+struct sample
+{
+	uint64_t	  timestampMs;
+	sampleChannel channel;
+	float		  value;
+};
+
+struct ringHeader
+{
+	uint32_t			  magic;
+	uint16_t			  version;
+	uint16_t			  slotSize;
+	uint32_t			  capacity;
+	uint32_t			  reserved;
+	std::atomic<uint64_t> writeIndex;
+};
+
+struct ringSlot
+{
+	std::atomic<uint64_t> sequence;
+	std::atomic<uint64_t> timestampMs;
+	std::atomic<uint32_t> channel;
+	std::atomic<float>	  value;
+};
+
+// Other processes access the same memory, the atomics must be plain lock free words
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<float>::is_always_lock_free);
+static_assert(sizeof(ringHeader) <= SAMPLE_RING_HEADER_SIZE && 24 == sizeof(ringSlot));
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief View of a ring in a memory region, the producer and the consumer side
+ */
+class sampleRing
+{
+  public:
+	/**
+	 * @brief Bytes needed for a ring
+	 */
+	static constexpr size_t regionSize(uint32_t capacity)
+	{
+		return SAMPLE_RING_HEADER_SIZE + capacity * sizeof(ringSlot);
+	}
+
+	/**
+	 * @brief Formats a ring in a region of regionSize(capacity) bytes, 8 byte aligned
+	 */
+	static sampleRing create(void* pRegion, uint32_t capacity)
+	{
+		ringHeader* pHeader = new (pRegion) ringHeader{SAMPLE_RING_MAGIC, SAMPLE_RING_VERSION, sizeof(ringSlot), capacity, 0, {0}};
+		ringSlot*	pSlots	= reinterpret_cast<ringSlot*>(static_cast<uint8_t*>(pRegion) + SAMPLE_RING_HEADER_SIZE);
+
+		for (uint32_t index = 0; index < capacity; index++)
+		{
+			new (&pSlots[index]) ringSlot{{0}, {0}, {0}, {0.0f}};
+		}
+
+		return sampleRing(pHeader, pSlots);
+	}
+
+	/**
+	 * @brief Opens a ring formatted by create(), e.g. by another process
+	 *
+	 * @return a ring that is not valid if the region does not hold a ring of this version
+	 */
+	static sampleRing attach(void* pRegion, size_t size)
+	{
+		ringHeader* pHeader = static_cast<ringHeader*>(pRegion);
+
+		// clang-format off
+		if (size < SAMPLE_RING_HEADER_SIZE ||
+			SAMPLE_RING_MAGIC != pHeader->magic || SAMPLE_RING_VERSION != pHeader->version ||
+			sizeof(ringSlot) != pHeader->slotSize || 0 == pHeader->capacity ||
+			size < regionSize(pHeader->capacity))
+		{
+			return sampleRing(nullptr, nullptr);
+		}
+		// clang-format on
+
+		return sampleRing(pHeader, reinterpret_cast<ringSlot*>(static_cast<uint8_t*>(pRegion) + SAMPLE_RING_HEADER_SIZE));
+	}
+
+	bool isValid() const
+	{
+		return nullptr != _pHeader;
+	}
+
+	/**
+	 * @brief Publishes a sample, overwriting the oldest one when the ring is full
+	 *
+	 * A ring has a single producer.
+	 */
+	void push(const sample& value)
+	{
+		uint64_t  index = _pHeader->writeIndex.load(std::memory_order_relaxed);
+		ringSlot& slot	= _pSlots[index % _pHeader->capacity];
+
+		slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.timestampMs.store(value.timestampMs, std::memory_order_relaxed);
+		slot.channel.store(static_cast<uint32_t>(value.channel), std::memory_order_relaxed);
+		slot.value.store(value.value, std::memory_order_relaxed);
+
+		slot.sequence.store(2 * index + 2, std::memory_order_release);
+		_pHeader->writeIndex.store(index + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Copies the samples published since the previous drain, oldest first
+	 *
+	 * Samples that do not fit in the buffer are left for the next drain.
+	 *
+	 * @return number of samples copied
+	 */
+	size_t drain(std::span<sample> buffer)
+	{
+		uint64_t writeIndex = _pHeader->writeIndex.load(std::memory_order_acquire);
+		size_t	 count		= 0;
+
+		while (_readIndex < writeIndex && count < buffer.size())
+		{
+			// Samples older than one lap are overwritten
+			if (writeIndex - _readIndex > _pHeader->capacity)
+			{
+				_lost	   += writeIndex - _pHeader->capacity - _readIndex;
+				_readIndex	= writeIndex - _pHeader->capacity;
+			}
+
+			if (true == _read(_readIndex, buffer[count]))
+			{
+				count++;
+			}
+			else
+			{
+				_lost++; // Overwritten while it was read
+			}
+
+			_readIndex++;
+		}
+
+		return count;
+	}
+
+	/**
+	 * @brief Samples overwritten before they were drained
+	 */
+	uint64_t getLost() const
+	{
+		return _lost;
+	}
+
+  private:
+	ringHeader* _pHeader;
+	ringSlot*	_pSlots;
+	uint64_t	_readIndex = 0; /// Next sample to drain
+	uint64_t	_lost	   = 0;
+
+	sampleRing(ringHeader* pHeader, ringSlot* pSlots) : _pHeader(pHeader), _pSlots(pSlots) {}
+
+	/**
+	 * @brief Reads a sample, false if the producer overwrote it
+	 */
+	bool _read(uint64_t index, sample& value) const
+	{
+		const ringSlot& slot	 = _pSlots[index % _pHeader->capacity];
+		uint64_t		complete = 2 * index + 2;
+
+		if (complete != slot.sequence.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value.timestampMs = slot.timestampMs.load(std::memory_order_relaxed);
+		value.channel	  = static_cast<sampleChannel>(slot.channel.load(std::memory_order_relaxed));
+		value.value		  = slot.value.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		return complete == slot.sequence.load(std::memory_order_relaxed);
+	}
+};
+
+} // namespace sensorSimulator
@@ -1,8 +1,9 @@
 #include "sensorSimulatorConsumer.hpp"
+#include "sampleRing.hpp"
 
+#include <array>
 #include <csignal>
 #include <cstdlib>
-#include <cstring>
 #include <fcntl.h>
 #include <iostream>
 #include <sys/mman.h>
@@ -14,11 +15,13 @@ namespace sensorSimulator
 
 constexpr const char* producerPath = "/home/renato/renato/CESE_fiuba/proyecto_final/genLogger/firmware/source/app/measurementSubsystem/sensors/sensorSimulator/sensorSimulatorProducer.py";
 constexpr const char* name		   = "sensors";
-constexpr size_t	  SIZE		   = 4096;
+constexpr size_t	  SIZE		   = sampleRing::regionSize(SAMPLE_RING_CAPACITY);
+constexpr size_t	  DRAIN_CHUNK  = 64; // Samples copied per drain call
 
-static int	 shm_fd;
-static void* ptr;
-static pid_t child_pid;
+static int		  shm_fd;
+static void*	  ptr;
+static pid_t	  child_pid;
+static sampleRing ring = sampleRing::attach(nullptr, 0);
 
 bool getMemInitFlag()
 {
@@ -59,9 +62,9 @@ void init(void)
 		exit(1);
 	}
 
-	ftruncate(shm_fd, sizeof(sensorOutput));
+	ftruncate(shm_fd, SIZE);
 
-	ptr = mmap(0, sizeof(sensorOutput), PROT_WRITE, MAP_SHARED, shm_fd, 0);
+	ptr = mmap(0, SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
 	if (ptr == MAP_FAILED)
 	{
 		perror("mmap failed");
@@ -69,6 +72,9 @@ void init(void)
 		exit(1);
 	}
 
+	// The ring is formatted before the producer starts, see sampleRing.hpp for the layout
+	ring = sampleRing::create(ptr, SAMPLE_RING_CAPACITY);
+
 	// Set up signal handler for Ctrl+C
 	signal(SIGINT, cleanup);
 
@@ -101,7 +107,10 @@ void init(void)
 
 sensorOutput readSharedMemory(void)
 {
-	sensorOutput output{};
+	static float					lastDirection = 0.0f;
+	sensorOutput					output{0, 0, lastDirection};
+	std::array<sample, DRAIN_CHUNK>	samples;
+	size_t							count;
 
 	if (!ptr)
 	{
@@ -109,8 +118,34 @@ sensorOutput readSharedMemory(void)
 		exit(1);
 	}
 
-	std::memcpy(&output, ptr, sizeof(sensorOutput));
+	while (0 != (count = ring.drain(samples)))
+	{
+		for (size_t index = 0; index < count; index++)
+		{
+			switch (samples[index].channel)
+			{
+				case sampleChannel::RAIN:
+					output.rain += static_cast<uint32_t>(samples[index].value);
+					break;
+				case sampleChannel::WIND_SPEED:
+					output.windSpeed += static_cast<uint32_t>(samples[index].value);
+					break;
+				case sampleChannel::WIND_DIRECTION:
+					output.windDirection = samples[index].value;
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+	lastDirection = output.windDirection;
 
 	return output;
 }
+
+uint64_t getLostSamples(void)
+{
+	return (true == ring.isValid()) ? ring.getLost() : 0;
+}
 } // namespace sensorSimulator
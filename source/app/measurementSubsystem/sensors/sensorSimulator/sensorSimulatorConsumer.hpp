@@ -5,21 +5,26 @@
 
 namespace sensorSimulator
 {
+/**
+ * @brief Samples received since the previous readSharedMemory()
+ */
 struct sensorOutput
 {
-	uint32_t rain;
-	uint32_t windSpeed;
-	uint32_t windDir;
+	uint32_t rain;			/// Rain gauge pulses
+	uint32_t windSpeed;		/// Anemometer pulses
+	float	 windDirection; /// Last wind vane voltage
 };
 
-// union sharedMemory
-// {
-//     sensorOutput data;
-//     std::byte sensorOutputBuff[sizeof(sensorOutput)];
-// };
-
 bool getMemInitFlag();
 void init(void);
 
+/**
+ * @brief Drains the samples pushed by the producer, see sampleRing.hpp
+ */
 sensorOutput readSharedMemory(void);
+
+/**
+ * @brief Samples the producer overwrote before they were drained
+ */
+uint64_t getLostSamples(void);
 } // namespace sensorSimulator
\ No newline at end of file
@@ -1,19 +1,47 @@
 import sys
 import time
 import random
-import ctypes
 import signal
+import struct
 from multiprocessing import shared_memory
 
-class SensorData(ctypes.Structure):
-    _fields_ = [
-        ('rain_ctr', ctypes.c_int),
-        ('windSpeed_ctr', ctypes.c_int),
-        ('windDir_adc', ctypes.c_int),
-    ]
+# Shared memory layout, see sampleRing.hpp
+RING_MAGIC = 0x53534c47
+RING_VERSION = 1
+HEADER_SIZE = 64
+SLOT_SIZE = 24
+WRITE_INDEX_OFFSET = 16
+
+CHANNEL_RAIN = 0
+CHANNEL_WIND_SPEED = 1
+CHANNEL_WIND_DIRECTION = 2
 
 running = True  # Global flag to control the simulation loop
-sensor_data = None
+ring = None
+
+class SampleRing:
+    """Producer side of the sample ring, each slot is a seqlock"""
+
+    def __init__(self, buf):
+        magic, version, slotSize, capacity = struct.unpack_from('<IHHI', buf, 0)
+        if magic != RING_MAGIC or version != RING_VERSION or slotSize != SLOT_SIZE:
+            raise RuntimeError("Shared memory does not hold a sample ring of version %d" % RING_VERSION)
+
+        self.buf = buf
+        self.capacity = capacity
+        self.index = struct.unpack_from('<Q', buf, WRITE_INDEX_OFFSET)[0]
+
+    def push(self, channel, value):
+        slot = HEADER_SIZE + (self.index % self.capacity) * SLOT_SIZE
+        timestampMs = int(time.time() * 1000)
+
+        # Odd sequence while the fields are written, the consumer drops what it reads meanwhile
+        struct.pack_into('<Q', self.buf, slot, 2 * self.index + 1)
+        struct.pack_into('<QIf', self.buf, slot + 8, timestampMs, channel, value)
+        struct.pack_into('<Q', self.buf, slot, 2 * self.index + 2)
+
+        self.index += 1
+        struct.pack_into('<Q', self.buf, WRITE_INDEX_OFFSET, self.index)
 
 def handle_exit(signum, frame):
     global running
@@ -21,16 +49,15 @@ def handle_exit(signum, frame):
     running = False
 
 def simulateTickPluviometer():
-    global sensor_data
     rainIncrement = random.randint(0, 1)
-    sensor_data.rain_ctr += rainIncrement
-    #print(f"Rain incremented by {rainIncrement}, total: {sensor_data.rain_ctr}")
+    ring.push(CHANNEL_RAIN, rainIncrement)
+    #print(f"Rain incremented by {rainIncrement}")
     time.sleep(1)
 
 def simulateTickAnemometer():
     windSpeedIncrement = random.randint(0, 1)
-    sensor_data.windSpeed_ctr += windSpeedIncrement
-    #print(f"Wind Speed incremented by {windSpeedIncrement}, total: {sensor_data.windSpeed_ctr}")
+    ring.push(CHANNEL_WIND_SPEED, windSpeedIncrement)
+    #print(f"Wind Speed incremented by {windSpeedIncrement}")
     time.sleep(1)
 
 def main():
@@ -38,7 +65,7 @@ def main():
         print("Usage: python sim_sensors.py <shared_memory_name>")
         sys.exit(1)
 
-    global sensor_data
+    global ring
 
     sharedMemoryName = sys.argv[1]
     shm = shared_memory.SharedMemory(name=sharedMemoryName)
@@ -48,15 +75,15 @@ def main():
     signal.signal(signal.SIGINT, handle_exit)
 
     try:
-        sensor_data = SensorData.from_buffer(shm.buf)
+        ring = SampleRing(shm.buf)
 
         print("Producer: Sensor simulation started. Waiting for termination signal...")
         while running:
             simulateTickPluviometer()
             simulateTickAnemometer()
-            
+
     finally:
-        del sensor_data
+        ring = None
         shm.close()
         print("Producer: Shared memory closed. Exiting.")
 
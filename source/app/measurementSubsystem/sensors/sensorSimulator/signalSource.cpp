@@ -0,0 +1,249 @@
+#include "signalSource.hpp"
+#include "rtcCalendar.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace sensorSimulator
+{
+
+////////////////////////////////////////////////////////////////////////
+//						  Function definitions
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief splitmix64 finalizer, spreads every bit of the input over the output
+ */
+static uint64_t mix(uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+
+	return value ^ (value >> 31);
+}
+
+/**
+ * @brief Uniform value in (0, 1] for a seed, a time and a stream, e.g. noise or spikes
+ */
+static float uniform(uint32_t seed, uint64_t timeMs, uint8_t stream)
+{
+	uint64_t hash = mix((static_cast<uint64_t>(seed) << 8 | stream) ^ mix(timeMs));
+
+	return static_cast<float>((hash >> 40) + 1) / static_cast<float>(1u << 24);
+}
+
+/**
+ * @brief Parses a trace time, milliseconds or the record format "HH:MM:SS.mmm-DD/MM/YYYY"
+ */
+static bool parseTime(const std::string& field, uint64_t& timeMs)
+{
+	unsigned hour, minute, seconds, millis, day, month, year;
+
+	if (7 == std::sscanf(field.c_str(), "%u:%u:%u.%u-%u/%u/%u", &hour, &minute, &seconds, &millis, &day, &month, &year))
+	{
+		uint64_t days = rtcCalendar::daysFromCivil(static_cast<uint16_t>(year), static_cast<uint8_t>(month), static_cast<uint8_t>(day));
+
+		timeMs = ((days * rtcCalendar::SECONDS_IN_ONE_DAY + hour * 3600u + minute * 60u + seconds) * 1000u) + millis;
+		return true;
+	}
+
+	char* pEnd = nullptr;
+	timeMs	   = std::strtoull(field.c_str(), &pEnd, 10);
+
+	return pEnd != field.c_str();
+}
+
+////////////////////////////////////////////////////////////////////////
+//							 Signal source
+////////////////////////////////////////////////////////////////////////
+
+void signalSource::setConstant(float value)
+{
+	this->_type	 = signalType::CONSTANT;
+	this->_value = value;
+	this->_trace.clear();
+}
+
+void signalSource::setWaveform(const waveform& shape, uint32_t seed)
+{
+	this->_type	 = signalType::WAVEFORM;
+	this->_shape = shape;
+	this->_seed	 = seed;
+	this->_trace.clear();
+}
+
+bool signalSource::setTrace(std::vector<tracePoint> points)
+{
+	if (true == points.empty())
+	{
+		return false;
+	}
+
+	this->_type	 = signalType::TRACE;
+	this->_trace = std::move(points);
+
+	// Times relative to the first point, the last one lasts as long as the one before it
+	uint64_t start = this->_trace.front().timeMs;
+	for (tracePoint& point : this->_trace)
+	{
+		point.timeMs -= start;
+	}
+
+	size_t	 last		  = this->_trace.size() - 1;
+	uint64_t lastInterval = (last > 0) ? this->_trace[last].timeMs - this->_trace[last - 1].timeMs : 1;
+
+	this->_traceLengthMs = this->_trace[last].timeMs + ((0 != lastInterval) ? lastInterval : 1);
+
+	return true;
+}
+
+bool signalSource::loadCsv(const char* path, size_t column)
+{
+	std::ifstream file(path);
+
+	if (false == file.is_open())
+	{
+		return false;
+	}
+
+	std::vector<tracePoint> points;
+	std::string				line;
+
+	while (std::getline(file, line))
+	{
+		// Comments and the column names start with something else than a time
+		if (true == line.empty() || 0 == std::isdigit(static_cast<unsigned char>(line[0])))
+		{
+			continue;
+		}
+
+		size_t	 end = line.find_first_of(";,");
+		uint64_t timeMs;
+
+		if (std::string::npos == end || false == parseTime(line.substr(0, end), timeMs))
+		{
+			continue;
+		}
+
+		for (size_t skipped = 0; skipped < column && std::string::npos != end; skipped++)
+		{
+			end = line.find_first_of(";,", end + 1);
+		}
+
+		if (std::string::npos == end)
+		{
+			continue;
+		}
+
+		const char* pField = line.c_str() + end + 1;
+		char*		pEnd   = nullptr;
+		float		value  = std::strtof(pField, &pEnd);
+
+		if (pEnd != pField)
+		{
+			points.push_back({timeMs, value});
+		}
+	}
+
+	return setTrace(std::move(points));
+}
+
+float signalSource::valueAt(uint64_t timeMs) const
+{
+	switch (this->_type)
+	{
+		case signalType::WAVEFORM:
+			return _waveformAt(timeMs);
+		case signalType::TRACE:
+			return _traceAt(timeMs);
+		default:
+			return this->_value;
+	}
+}
+
+float signalSource::_waveformAt(uint64_t timeMs) const
+{
+	constexpr float twoPi = 6.28318531f;
+
+	const waveform& shape = this->_shape;
+	float			value = shape.mean;
+
+	if (0 != shape.periodMs)
+	{
+		uint64_t phaseMs  = (timeMs + shape.periodMs - shape.peakMs % shape.periodMs) % shape.periodMs;
+		value			 += shape.amplitude * std::cos(twoPi * static_cast<float>(phaseMs) / static_cast<float>(shape.periodMs));
+	}
+
+	if (0.0f != shape.noise)
+	{
+		// Box-Muller, two uniform values give a normal one
+		float radius  = std::sqrt(-2.0f * std::log(uniform(this->_seed, timeMs, 0)));
+		value		 += shape.noise * radius * std::cos(twoPi * uniform(this->_seed, timeMs, 1));
+	}
+
+	if (uniform(this->_seed, timeMs, 2) <= shape.spikeProbability)
+	{
+		value += shape.spikeAmplitude;
+	}
+
+	return value;
+}
+
+float signalSource::_traceAt(uint64_t timeMs) const
+{
+	uint64_t loopMs = timeMs % this->_traceLengthMs;
+
+	// Last point at or before the time
+	size_t low	= 0;
+	size_t high = this->_trace.size();
+
+	while (high - low > 1)
+	{
+		size_t middle = (low + high) / 2;
+
+		if (this->_trace[middle].timeMs <= loopMs)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return this->_trace[low].value;
+}
+
+////////////////////////////////////////////////////////////////////////
+//							  Replay clock
+////////////////////////////////////////////////////////////////////////
+
+static float								 replaySpeed  = 1.0f;
+static uint64_t								 replayBaseMs = 0; /// Replay time at realBase
+static std::chrono::steady_clock::time_point realBase	  = std::chrono::steady_clock::now();
+
+void setReplaySpeed(float factor)
+{
+	replayBaseMs = getReplayTimeMs();
+	realBase	 = std::chrono::steady_clock::now();
+	replaySpeed	 = factor;
+}
+
+void setReplayTime(uint64_t timeMs)
+{
+	replayBaseMs = timeMs;
+	realBase	 = std::chrono::steady_clock::now();
+}
+
+uint64_t getReplayTimeMs()
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - realBase;
+
+	return replayBaseMs + static_cast<uint64_t>(elapsed.count() * static_cast<double>(replaySpeed));
+}
+
+} // namespace sensorSimulator
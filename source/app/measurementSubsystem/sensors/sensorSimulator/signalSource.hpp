@@ -0,0 +1,202 @@
+/**
+ * @file signalSource.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Recorded and synthetic signals driving the host sensor mocks
+
+	A signalSource is the value a mocked sensor converts as a function of time. It is either
+	constant, a synthetic waveform, or a trace replayed from a file logged by the firmware,
+	CSV or binary (see record_schema.hpp). Mocks read their sources at the replay time,
+	which runs at any multiple of real time or is stepped by hand, so a day of data can be
+	pushed through the pipeline in seconds.
+
+	Synthetic waveforms are a daily sine cycle with gaussian noise and spikes on top. The
+	noise and the spikes are a hash of the seed and the time, not a random generator state:
+	the value at a given time is the same whatever the number of reads or the sampling rate,
+	and a benchmark run with the same seed is reproducible.
+
+	Traces hold each logged value until the next one and loop at their end.
+
+ * @version 0.1
+ * @date 2025-04-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "record_schema.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t SIGNAL_DAY_MS  = 24 * 60 * 60 * 1000;
+constexpr uint32_t SIGNAL_PEAK_MS = 15 * 60 * 60 * 1000; // Default time of day of the daily maximum, mid afternoon
+
+namespace sensorSimulator
+{
+
+////////////////////////////////////////////////////////////////////////
+//							     Types
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Shape of a synthetic signal
+ */
+struct waveform
+{
+	float	 mean			  = 0.0f;
+	float	 amplitude		  = 0.0f;			/// Half the peak to peak of the cycle
+	uint32_t periodMs		  = SIGNAL_DAY_MS;	/// Length of the cycle
+	uint32_t peakMs			  = SIGNAL_PEAK_MS;	/// Time within the cycle of the maximum
+	float	 noise			  = 0.0f;			/// Standard deviation of the gaussian noise
+	float	 spikeProbability = 0.0f;			/// Chance of a spike at each millisecond sampled
+	float	 spikeAmplitude	  = 0.0f;			/// Added to the value during a spike
+};
+
+/**
+ * @brief One logged value
+ */
+struct tracePoint
+{
+	uint64_t timeMs;
+	float	 value;
+};
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+class signalSource
+{
+  public:
+	/**
+	 * @brief Constant signal
+	 */
+	void setConstant(float value);
+
+	/**
+	 * @brief Synthetic signal
+	 *
+	 * @param seed same seed, same noise and spikes
+	 */
+	void setWaveform(const waveform& shape, uint32_t seed);
+
+	/**
+	 * @brief Replays a trace, time 0 is its first point
+	 *
+	 * @param points points in time order
+	 * @return false if the trace is empty, the signal is unchanged
+	 */
+	bool setTrace(std::vector<tracePoint> points);
+
+	/**
+	 * @brief Replays a column of a CSV file
+	 *
+	 * Lines are a time and values separated by ';' or ',', the time either in milliseconds
+	 * or in the record format "HH:MM:SS.mmm-DD/MM/YYYY". Comments starting with '#' and the
+	 * column names are skipped, so the files of the logger are read as they are.
+	 *
+	 * @param column value column, 0 is the first after the time
+	 * @return false if the file can not be read or has no value in the column
+	 */
+	bool loadCsv(const char* path, size_t column);
+
+	/**
+	 * @brief Replays a channel of a binary file written with a record schema
+	 *
+	 * @tparam schema_t schema::recordSchema the file was written with
+	 * @param column channel index in the schema
+	 * @return false if the file can not be read, was written with another schema or is empty
+	 */
+	template<typename schema_t>
+	bool loadBinary(const char* path, size_t column)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		if (false == file.is_open() || column >= schema_t::NUM_CHANNELS)
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+		if (false == schema_t::checkBinaryHeader(data))
+		{
+			return false;
+		}
+
+		std::vector<tracePoint>		points;
+		typename schema_t::record_t record;
+
+		for (size_t offset = BINARY_FILE_HEADER_SIZE; offset + schema_t::BINARY_RECORD_SIZE <= data.size(); offset += schema_t::BINARY_RECORD_SIZE)
+		{
+			schema_t::decode(std::span<const uint8_t>(&data[offset], schema_t::BINARY_RECORD_SIZE), record);
+			points.push_back({record.timestampMs, record.values[column]});
+		}
+
+		return setTrace(std::move(points));
+	}
+
+	/**
+	 * @brief Value of the signal at a replay time
+	 */
+	float valueAt(uint64_t timeMs) const;
+
+	/**
+	 * @brief Points of the trace replayed, 0 for other signals
+	 */
+	size_t getTraceSize() const
+	{
+		return this->_trace.size();
+	}
+
+  private:
+	enum class signalType
+	{
+		CONSTANT,
+		WAVEFORM,
+		TRACE
+	};
+
+	signalType				_type		   = signalType::CONSTANT;
+	float					_value		   = 0.0f;
+	waveform				_shape;
+	uint32_t				_seed		   = 0;
+	std::vector<tracePoint>	_trace;
+	uint64_t				_traceLengthMs = 0;	/// Loop length, the last point is held one interval
+
+	float _waveformAt(uint64_t timeMs) const;
+	float _traceAt(uint64_t timeMs) const;
+};
+
+////////////////////////////////////////////////////////////////////////
+//							  Replay clock
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Sets how fast the replay time runs, 1 is real time, 0 stops it
+ */
+void setReplaySpeed(float factor);
+
+/**
+ * @brief Moves the replay time, it keeps running from there at the current speed
+ */
+void setReplayTime(uint64_t timeMs);
+
+/**
+ * @brief Replay time in milliseconds, the time the mocks read their signals at
+ */
+uint64_t getReplayTimeMs();
+
+} // namespace sensorSimulator
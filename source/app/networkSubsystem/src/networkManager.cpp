@@ -28,6 +28,7 @@ void networkManager::mgEventHandler(struct mg_connection* c, int ev, void* ev_da
 		mg_printf(c,
 				  "POST %s HTTP/1.1\r\n"
 				  "Host: %.*s\r\n"
+				  "Content-Type: application/json\r\n"
 				  "Content-Length: %d\r\n"
 				  "\r\n"
 				  "%s",
@@ -0,0 +1,152 @@
+/**
+ * @file record_writer.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Allocation free formatter for measurement records
+
+	Records are built by chaining emitters on a recordWriter that owns a position inside
+	a caller provided buffer. Every emitter is a plain function of its arguments: there is
+	no format string to parse, no varargs, no locale and no heap, so formatting a record
+	costs a few integer divisions per field and does not need newlib's float printf.
+
+	Floats are written with a fixed number of decimals. The digits are computed with integer
+	math from the exact binary value of the float, rounded to nearest with ties to even,
+	so the output is the same as "%.*f" and no float operations are needed.
+	The integer part must fit in 32 bits, larger magnitudes are written as "nan", the
+	same as NaN, since no sensor produces them.
+
+	Timestamps travel through the firmware as epoch milliseconds, the timestamp emitters
+	are where they become text.
+
+	If a field does not fit, the writer stops emitting and finish() reports the overflow,
+	the buffer then holds an empty string so a truncated record is never stored.
+
+ * @version 0.1
+ * @date 2025-04-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint8_t RECORD_MAX_DECIMALS = 6; // Float decimals above this are clamped, 10^6 keeps the fraction in 32 bits
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+class recordWriter
+{
+  public:
+	/**
+	 * @brief Construct a new record Writer object
+	 *
+	 * @param buff buffer receiving the record, one byte is kept for the null terminator
+	 */
+	explicit recordWriter(std::span<char> buff);
+
+	/**
+	 * @brief Appends a single character
+	 */
+	recordWriter& appendChar(char value);
+
+	/**
+	 * @brief Appends a null terminated string
+	 */
+	recordWriter& appendString(const char* pValue);
+
+	/**
+	 * @brief Appends an unsigned integer
+	 *
+	 * @param value value to append
+	 * @param minDigits the value is left padded with zeros up to this number of digits
+	 */
+	recordWriter& appendUnsigned(uint32_t value, uint8_t minDigits = 0);
+
+	/**
+	 * @brief Appends a 64 bit unsigned integer, e.g. an epoch in milliseconds
+	 */
+	recordWriter& appendUnsigned64(uint64_t value);
+
+	/**
+	 * @brief Appends an unsigned integer as lowercase hexadecimal, left padded with zeros
+	 *
+	 * @param value value to append
+	 * @param numDigits number of digits written, at most 8
+	 */
+	recordWriter& appendHex(uint32_t value, uint8_t numDigits);
+
+	/**
+	 * @brief Appends a signed integer
+	 */
+	recordWriter& appendInt(int32_t value);
+
+	/**
+	 * @brief Appends a float with a fixed number of decimals, equivalent to "%.*f"
+	 *
+	 * @param value value to append
+	 * @param decimals digits after the decimal point, at most @ref RECORD_MAX_DECIMALS
+	 */
+	recordWriter& appendFixed(float value, uint8_t decimals);
+
+	/**
+	 * @brief Appends a time as "HH:MM:SS"
+	 */
+	recordWriter& appendTime(uint8_t hour, uint8_t minute, uint8_t seconds);
+
+	/**
+	 * @brief Appends a date as "DD/MM/YYYY"
+	 */
+	recordWriter& appendDate(uint8_t day, uint8_t month, uint16_t year);
+
+	/**
+	 * @brief Appends an epoch in milliseconds as "HH:MM:SS.mmm-DD/MM/YYYY", the record timestamp format
+	 */
+	recordWriter& appendTimestamp(uint64_t epochMs);
+
+	/**
+	 * @brief Appends an epoch in milliseconds as ISO 8601 "YYYY-MM-DDTHH:MM:SS.mmm"
+	 */
+	recordWriter& appendIsoTimestamp(uint64_t epochMs);
+
+	/**
+	 * @brief Null terminates the record
+	 *
+	 * @return size_t length of the record, 0 if it did not fit in the buffer
+	 */
+	size_t finish();
+
+	/**
+	 * @brief Characters written so far
+	 */
+	size_t length() const;
+
+	/**
+	 * @brief true if a field did not fit in the buffer
+	 */
+	bool overflowed() const;
+
+  private:
+	std::span<char> _buff;
+	size_t			_pos	  = 0;
+	bool			_overflow = false;
+
+	/**
+	 * @brief Reserves space for len characters
+	 *
+	 * @return pointer to the reserved space, nullptr if it does not fit
+	 */
+	char* _reserve(size_t len);
+};
@@ -20,7 +20,9 @@
 namespace utilities
 {
   
+constexpr uint16_t MS_IN_ONE_SECOND = 1000;
 constexpr uint16_t MS_IN_ONE_MINUTE = 60000;
+constexpr uint16_t MINUTES_IN_ONE_DAY = 1440;
 
 /**
  * @brief Parses a string and sets time and date values according to what's parsed
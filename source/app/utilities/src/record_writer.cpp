@@ -0,0 +1,359 @@
+/**
+ * @file record_writer.cpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Source file for the record formatter, for a better description go to the header file
+ * @version 0.1
+ * @date 2025-04-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "record_writer.hpp"
+#include "rtcCalendar.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////
+//							 Private constants
+////////////////////////////////////////////////////////////////////////
+
+static constexpr uint8_t MAX_UINT32_DIGITS	   = 10;
+static constexpr uint8_t MAX_UINT64_DIGITS	   = 20;
+static constexpr uint8_t MAX_UINT32_HEX_DIGITS = 8;
+
+static constexpr std::array<uint32_t, RECORD_MAX_DECIMALS + 1> powersOfTen = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+static constexpr float MAX_FIXED_MAGNITUDE = 4294967040.0f; // Largest float below 2^32
+
+static constexpr uint32_t FLOAT_EXPONENT_SHIFT = 150; // IEEE 754 single precision bias (127) plus mantissa bits (23)
+
+////////////////////////////////////////////////////////////////////////
+//					   Public methods implementation
+////////////////////////////////////////////////////////////////////////
+
+recordWriter::recordWriter(std::span<char> buff) : _buff(buff)
+{
+	if (0 == this->_buff.size())
+	{
+		this->_overflow = true;
+	}
+}
+
+recordWriter& recordWriter::appendChar(char value)
+{
+	char* pDst = _reserve(1);
+
+	if (nullptr != pDst)
+	{
+		*pDst = value;
+	}
+
+	return *this;
+}
+
+recordWriter& recordWriter::appendString(const char* pValue)
+{
+	size_t len = 0;
+
+	while ('\0' != pValue[len])
+	{
+		len++;
+	}
+
+	char* pDst = _reserve(len);
+
+	if (nullptr != pDst)
+	{
+		for (size_t index = 0; index < len; index++)
+		{
+			pDst[index] = pValue[index];
+		}
+	}
+
+	return *this;
+}
+
+recordWriter& recordWriter::appendUnsigned(uint32_t value, uint8_t minDigits)
+{
+	std::array<char, MAX_UINT32_DIGITS> digits;
+	uint8_t								numDigits = 0;
+
+	// Digits come out least significant first
+	do
+	{
+		digits[numDigits++] = static_cast<char>('0' + (value % 10));
+		value /= 10;
+	} while (0 != value);
+
+	while (numDigits < minDigits && numDigits < MAX_UINT32_DIGITS)
+	{
+		digits[numDigits++] = '0';
+	}
+
+	char* pDst = _reserve(numDigits);
+
+	if (nullptr != pDst)
+	{
+		for (uint8_t index = 0; index < numDigits; index++)
+		{
+			pDst[index] = digits[numDigits - 1 - index];
+		}
+	}
+
+	return *this;
+}
+
+recordWriter& recordWriter::appendUnsigned64(uint64_t value)
+{
+	// 64 bit divisions are library calls on the target, keep them for values that need them
+	if (value <= UINT32_MAX)
+	{
+		return appendUnsigned(static_cast<uint32_t>(value));
+	}
+
+	std::array<char, MAX_UINT64_DIGITS> digits;
+	uint8_t								numDigits = 0;
+
+	do
+	{
+		digits[numDigits++] = static_cast<char>('0' + (value % 10));
+		value /= 10;
+	} while (0 != value);
+
+	char* pDst = _reserve(numDigits);
+
+	if (nullptr != pDst)
+	{
+		for (uint8_t index = 0; index < numDigits; index++)
+		{
+			pDst[index] = digits[numDigits - 1 - index];
+		}
+	}
+
+	return *this;
+}
+
+recordWriter& recordWriter::appendHex(uint32_t value, uint8_t numDigits)
+{
+	if (numDigits > MAX_UINT32_HEX_DIGITS)
+	{
+		numDigits = MAX_UINT32_HEX_DIGITS;
+	}
+
+	char* pDst = _reserve(numDigits);
+
+	if (nullptr != pDst)
+	{
+		for (uint8_t index = numDigits; index > 0; index--)
+		{
+			pDst[index - 1] = "0123456789abcdef"[value & 0xF];
+			value >>= 4;
+		}
+	}
+
+	return *this;
+}
+
+recordWriter& recordWriter::appendInt(int32_t value)
+{
+	if (value < 0)
+	{
+		appendChar('-');
+
+		// Negate in unsigned arithmetic, -INT32_MIN does not fit in an int32_t
+		return appendUnsigned(0u - static_cast<uint32_t>(value));
+	}
+
+	return appendUnsigned(static_cast<uint32_t>(value));
+}
+
+recordWriter& recordWriter::appendFixed(float value, uint8_t decimals)
+{
+	if (decimals > RECORD_MAX_DECIMALS)
+	{
+		decimals = RECORD_MAX_DECIMALS;
+	}
+
+	if (true == std::isnan(value))
+	{
+		return appendString("nan");
+	}
+
+	if (true == std::signbit(value))
+	{
+		appendChar('-');
+		value = -value;
+	}
+
+	if (true == std::isinf(value))
+	{
+		return appendString("inf");
+	}
+
+	if (value > MAX_FIXED_MAGNITUDE)
+	{
+		return appendString("nan");
+	}
+
+	// value = mantissa * 2^-shift, the digits are computed from the exact binary value
+	uint32_t bits	  = std::bit_cast<uint32_t>(value);
+	uint32_t exponent = (bits >> 23) & 0xFF;
+	uint32_t mantissa = bits & 0x7FFFFF;
+	uint32_t shift	  = FLOAT_EXPONENT_SHIFT - 1; // Subnormals
+
+	if (0 != exponent)
+	{
+		mantissa |= 0x800000;
+		shift = (exponent > FLOAT_EXPONENT_SHIFT) ? 0 : FLOAT_EXPONENT_SHIFT - exponent;
+	}
+
+	uint32_t integerPart;
+	uint64_t fractionBits;
+
+	if (0 == shift)
+	{
+		integerPart	 = mantissa << (exponent - FLOAT_EXPONENT_SHIFT);
+		fractionBits = 0;
+	}
+	else if (shift < 32)
+	{
+		integerPart	 = mantissa >> shift;
+		fractionBits = mantissa & ((1u << shift) - 1);
+	}
+	else
+	{
+		integerPart	 = 0;
+		fractionBits = mantissa;
+	}
+
+	// fraction * 10^decimals = fractionBits * scale / 2^shift, the product fits in 44 bits
+	uint32_t scale		  = powersOfTen[decimals];
+	uint64_t scaled		  = fractionBits * scale;
+	uint32_t fractionPart = 0;
+	bool	 roundUp	  = false;
+
+	if (shift > 0 && shift < 64)
+	{
+		uint64_t remainder = scaled & ((1ull << shift) - 1);
+		uint64_t half	   = 1ull << (shift - 1);
+
+		fractionPart = static_cast<uint32_t>(scaled >> shift);
+
+		// Round to nearest, exact ties to even like printf does, the last digit is in the integer part without decimals
+		uint32_t lastDigits = (0 == decimals) ? integerPart : fractionPart;
+		roundUp				= (remainder > half) || (remainder == half && 1u == (lastDigits & 1u));
+	}
+
+	if (true == roundUp)
+	{
+		fractionPart++;
+	}
+
+	if (fractionPart >= scale)
+	{
+		// Rounding carried into the integer part, e.g. 1.999 with 2 decimals
+		fractionPart -= scale;
+		integerPart++;
+	}
+
+	appendUnsigned(integerPart);
+
+	if (decimals > 0)
+	{
+		appendChar('.');
+		appendUnsigned(fractionPart, decimals);
+	}
+
+	return *this;
+}
+
+recordWriter& recordWriter::appendTime(uint8_t hour, uint8_t minute, uint8_t seconds)
+{
+	return appendUnsigned(hour, 2).appendChar(':').appendUnsigned(minute, 2).appendChar(':').appendUnsigned(seconds, 2);
+}
+
+recordWriter& recordWriter::appendDate(uint8_t day, uint8_t month, uint16_t year)
+{
+	return appendUnsigned(day, 2).appendChar('/').appendUnsigned(month, 2).appendChar('/').appendUnsigned(year, 4);
+}
+
+recordWriter& recordWriter::appendTimestamp(uint64_t epochMs)
+{
+	rtcDateTime dateTime = rtcCalendar::fromEpochMs(epochMs);
+	uint32_t	millis	 = static_cast<uint32_t>(epochMs % 1000);
+
+	// clang-format off
+	return appendTime(dateTime.hour, dateTime.minute, dateTime.seconds)
+		  .appendChar('.')
+		  .appendUnsigned(millis, 3)
+		  .appendChar('-')
+		  .appendDate(dateTime.day, dateTime.month, dateTime.year);
+	// clang-format on
+}
+
+recordWriter& recordWriter::appendIsoTimestamp(uint64_t epochMs)
+{
+	rtcDateTime dateTime = rtcCalendar::fromEpochMs(epochMs);
+	uint32_t	millis	 = static_cast<uint32_t>(epochMs % 1000);
+
+	// clang-format off
+	return appendUnsigned(dateTime.year, 4).appendChar('-')
+		  .appendUnsigned(dateTime.month, 2).appendChar('-')
+		  .appendUnsigned(dateTime.day, 2).appendChar('T')
+		  .appendTime(dateTime.hour, dateTime.minute, dateTime.seconds)
+		  .appendChar('.')
+		  .appendUnsigned(millis, 3);
+	// clang-format on
+}
+
+size_t recordWriter::finish()
+{
+	if (true == this->_overflow)
+	{
+		if (0 != this->_buff.size())
+		{
+			this->_buff[0] = '\0';
+		}
+
+		return 0;
+	}
+
+	this->_buff[this->_pos] = '\0';
+
+	return this->_pos;
+}
+
+size_t recordWriter::length() const
+{
+	return this->_pos;
+}
+
+bool recordWriter::overflowed() const
+{
+	return this->_overflow;
+}
+
+////////////////////////////////////////////////////////////////////////
+//					 Private methods implementation
+////////////////////////////////////////////////////////////////////////
+
+char* recordWriter::_reserve(size_t len)
+{
+	// One byte is always left for the null terminator
+	if (true == this->_overflow || (this->_pos + len) >= this->_buff.size())
+	{
+		this->_overflow = true;
+		return nullptr;
+	}
+
+	char* pDst = this->_buff.data() + this->_pos;
+	this->_pos += len;
+
+	return pDst;
+}
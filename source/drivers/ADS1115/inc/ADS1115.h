@@ -42,6 +42,16 @@ extern "C" {
 #define ADS1115_COMP_1_3 6
 #define ADS1115_COMP_2_3 7
 
+/*Device data rate (samples per second)*/
+#define ADS1115_RATE_8SPS 0
+#define ADS1115_RATE_16SPS 1
+#define ADS1115_RATE_32SPS 2
+#define ADS1115_RATE_64SPS 3
+#define ADS1115_RATE_128SPS 4 //(default)
+#define ADS1115_RATE_250SPS 5
+#define ADS1115_RATE_475SPS 6
+#define ADS1115_RATE_860SPS 7
+
 /*Device handler*/
 typedef struct _ADS1115_Handler
 {
@@ -56,7 +66,10 @@ uint8_t ADS1115_init(ADS1115_handler* ads, uint8_t address);
 uint8_t ADS1115_Set_Mode(ADS1115_handler* ads, uint8_t mode);
 uint8_t ADS1115_Set_Volt_Range(ADS1115_handler* ads, uint8_t mode);
 uint8_t ADS1115_Set_Compare_Channel(ADS1115_handler* ads, uint8_t channel);
+uint8_t ADS1115_Set_Data_Rate(ADS1115_handler* ads, uint8_t rate);
+uint8_t ADS1115_Enable_Conversion_Ready(ADS1115_handler* ads);
 uint8_t ADS1115_Start_Single_Measurement(ADS1115_handler* ads);
+uint8_t ADS1115_Read_Conversion(ADS1115_handler* ads);
 float	ADS1115_Get_Volt(ADS1115_handler* ads);
 
 #ifdef __cplusplus
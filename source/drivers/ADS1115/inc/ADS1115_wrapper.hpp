@@ -1,12 +1,312 @@
 #pragma once
+#include "ADS1115.h"
+#include "debug_log.hpp"
 #include "virtualADC.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+constexpr uint8_t  ADS1115_MAX_SCAN_INPUTS		  = 8;	 // One entry per multiplexer setting
+constexpr uint8_t  ADS1115_SCAN_BUFFER_SIZE		  = 16;	 // Samples kept per input until read
+constexpr uint8_t  ADS1115_SETTLE_CONVERSIONS	  = 1;	 // Conversions discarded after switching input, the one in progress used the old input
+constexpr uint16_t ADS1115_RATE_TOLERANCE		  = 110; // Internal oscillator is within 10%, in percent
+constexpr uint8_t  ADS1115_ALERT_DEADLINE_PERIODS = 2;	 // Conversion periods without ALERT/RDY before the conversion is read anyway
+
+/**
+ * @brief Samples per second of each ADS1115_RATE_xxx setting
+ */
+constexpr std::array<uint16_t, 8> ADS1115_DATA_RATES_SPS = {8, 16, 32, 64, 128, 250, 475, 860};
 
 namespace ADC
 {
+
+/**
+ * @brief ADS1115 with single shot reads and a continuous multi input scanner
+ *
+ * The scanner runs the converter in continuous mode and cycles through a list of
+ * multiplexer inputs. Each input is converted oversampling + ADS1115_SETTLE_CONVERSIONS
+ * times before switching to the next, the settle conversions are dropped and the others
+ * are averaged into one sample, stored in a per input buffer.
+ *
+ * Conversions are collected by scanHandler(), called from the superloop. When the
+ * ALERT/RDY pin interrupt is available, conversionReadyISR() flags each finished
+ * conversion, otherwise scanHandler() falls back to reading at the data rate. A
+ * conversion not signaled within ADS1115_ALERT_DEADLINE_PERIODS conversion periods, the
+ * pin not wired or an edge missed, is read anyway so the scan does not stall.
+ */
 class ADS1115 : public ADC::IADC<ADS1115>
 {
   public:
 	bool  initImpl();
 	float readVoltageImpl(uint8_t channel);
+
+	/**
+	 * @brief Starts scanning a list of inputs in continuous mode
+	 *
+	 * @param inputs ADS1115_COMP_xxx multiplexer settings, up to ADS1115_MAX_SCAN_INPUTS
+	 * @param dataRate ADS1115_RATE_xxx conversion rate
+	 * @param oversampling conversions averaged into each sample, 1 for no averaging
+	 * @return false if the arguments are invalid or the converter could not be configured
+	 */
+	bool startScan(std::span<const uint8_t> inputs, uint8_t dataRate, uint8_t oversampling)
+	{
+		if (inputs.empty() || inputs.size() > ADS1115_MAX_SCAN_INPUTS || dataRate >= ADS1115_DATA_RATES_SPS.size() || 0 == oversampling)
+		{
+			return false;
+		}
+
+		_numInputs = static_cast<uint8_t>(inputs.size());
+		for (uint8_t index = 0; index < _numInputs; index++)
+		{
+			_inputs[index]		= inputs[index];
+			_bufferHead[index]	= 0;
+			_bufferCount[index] = 0;
+			_lastSample[index].reset();
+		}
+
+		// Round up so a poll never comes before the conversion is done
+		uint32_t sps		= ADS1115_DATA_RATES_SPS[dataRate];
+		_conversionPeriodMs = (1000u * ADS1115_RATE_TOLERANCE / 100u + sps - 1u) / sps;
+		_oversampling		= oversampling;
+		_current			= 0;
+		_accumulator		= 0.0f;
+		_accumulated		= 0;
+		_settle				= ADS1115_SETTLE_CONVERSIONS;
+		_conversionReady	= false;
+		_alertOverdue		= false;
+		_lastConversionMs	= 0;
+
+		_scanning = _startContinuous(_inputs[0], dataRate);
+
+		return _scanning;
+	}
+
+	void stopScan()
+	{
+		_scanning = false;
+		_stopContinuous();
+	}
+
+	bool isScanning() const
+	{
+		return _scanning;
+	}
+
+	/**
+	 * @brief Collects the finished conversion, if any, and moves the scan forward
+	 *
+	 * @param now current time in milliseconds, paces the reads without the ALERT/RDY interrupt
+	 * and bounds the wait for it
+	 */
+	void scanHandler(uint64_t now)
+	{
+		if (false == _scanning)
+		{
+			return;
+		}
+
+		if (true == _alertEnabled)
+		{
+			if (true == _conversionReady)
+			{
+				_alertOverdue = false;
+			}
+			else if (now - _lastConversionMs < ADS1115_ALERT_DEADLINE_PERIODS * _conversionPeriodMs)
+			{
+				return;
+			}
+			else
+			{
+				// Warn once per outage, the deadline then paces the scan
+				if (false == _alertOverdue)
+				{
+					debug::log<true, debug::logLevel::LOG_WARNING>("ADS1115: conversion ready not signaled, reading the conversion anyway\r\n");
+					_alertOverdue = true;
+				}
+
+				_missedAlerts++;
+			}
+
+			_conversionReady = false;
+		}
+		else if (now - _lastConversionMs < _conversionPeriodMs)
+		{
+			return;
+		}
+
+		_lastConversionMs = now;
+		_onConversion();
+	}
+
+	/**
+	 * @brief ALERT/RDY falling edge, called from the interrupt
+	 */
+	void conversionReadyISR()
+	{
+		_conversionReady = true;
+	}
+
+	/**
+	 * @brief Conversions read on the deadline because ALERT/RDY did not signal them
+	 */
+	uint32_t getMissedAlerts() const
+	{
+		return _missedAlerts;
+	}
+
+	/**
+	 * @brief Latest sample of a scanned input, nullopt if the input is not scanned or has no sample yet
+	 */
+	std::optional<float> getLastSample(uint8_t input) const
+	{
+		int index = _findInput(input);
+
+		return (index < 0) ? std::nullopt : _lastSample[static_cast<size_t>(index)];
+	}
+
+	/**
+	 * @brief Moves the buffered samples of an input to out, oldest first
+	 *
+	 * @return number of samples copied, the buffer keeps the ones that did not fit
+	 */
+	size_t readSamples(uint8_t input, std::span<float> out)
+	{
+		int index = _findInput(input);
+
+		if (index < 0)
+		{
+			return 0;
+		}
+
+		size_t	slot  = static_cast<size_t>(index);
+		size_t	count = (out.size() < _bufferCount[slot]) ? out.size() : _bufferCount[slot];
+		uint8_t tail  = static_cast<uint8_t>((_bufferHead[slot] + ADS1115_SCAN_BUFFER_SIZE - _bufferCount[slot]) % ADS1115_SCAN_BUFFER_SIZE);
+
+		for (size_t sample = 0; sample < count; sample++)
+		{
+			out[sample] = _buffer[slot][(tail + sample) % ADS1115_SCAN_BUFFER_SIZE];
+		}
+
+		_bufferCount[slot] = static_cast<uint8_t>(_bufferCount[slot] - count);
+
+		return count;
+	}
+
+  private:
+	using sampleBuffer_t = std::array<float, ADS1115_SCAN_BUFFER_SIZE>;
+
+	std::array<uint8_t, ADS1115_MAX_SCAN_INPUTS>			  _inputs{};
+	std::array<sampleBuffer_t, ADS1115_MAX_SCAN_INPUTS>		  _buffer{};
+	std::array<uint8_t, ADS1115_MAX_SCAN_INPUTS>			  _bufferHead{};  /// Next slot to write
+	std::array<uint8_t, ADS1115_MAX_SCAN_INPUTS>			  _bufferCount{}; /// Samples not read yet
+	std::array<std::optional<float>, ADS1115_MAX_SCAN_INPUTS> _lastSample{};
+	uint8_t													  _numInputs		  = 0;
+	uint8_t													  _current			  = 0; /// Index in _inputs being converted
+	uint8_t													  _oversampling		  = 1;
+	uint8_t													  _accumulated		  = 0;
+	uint8_t													  _settle			  = 0; /// Conversions left to drop
+	float													  _accumulator		  = 0.0f;
+	uint32_t												  _conversionPeriodMs = 0;
+	uint64_t												  _lastConversionMs	  = 0;
+	volatile bool											  _conversionReady	  = false;
+	bool													  _alertEnabled		  = false; /// ALERT/RDY interrupt configured
+	bool													  _alertOverdue		  = false; /// Last conversion was read on the deadline
+	uint32_t												  _missedAlerts		  = 0;
+	bool													  _scanning			  = false;
+
+	int _findInput(uint8_t input) const
+	{
+		for (uint8_t index = 0; index < _numInputs; index++)
+		{
+			if (input == _inputs[index])
+			{
+				return index;
+			}
+		}
+
+		return -1;
+	}
+
+	void _onConversion()
+	{
+		float volts;
+
+		if (false == _readConversion(volts))
+		{
+			return;
+		}
+
+		if (_settle > 0)
+		{
+			_settle--;
+			return;
+		}
+
+		_accumulator += volts;
+
+		if (++_accumulated < _oversampling)
+		{
+			return;
+		}
+
+		_store(_current, _accumulator / static_cast<float>(_accumulated));
+		_accumulator = 0.0f;
+		_accumulated = 0;
+
+		if (_numInputs > 1)
+		{
+			_current = static_cast<uint8_t>((_current + 1) % _numInputs);
+			_settle	 = ADS1115_SETTLE_CONVERSIONS;
+			_selectInput(_inputs[_current]);
+		}
+	}
+
+	void _store(uint8_t slot, float sample)
+	{
+		_buffer[slot][_bufferHead[slot]] = sample;
+		_bufferHead[slot]				 = static_cast<uint8_t>((_bufferHead[slot] + 1) % ADS1115_SCAN_BUFFER_SIZE);
+		_lastSample[slot]				 = sample;
+
+		// A full buffer drops its oldest sample
+		if (_bufferCount[slot] < ADS1115_SCAN_BUFFER_SIZE)
+		{
+			_bufferCount[slot]++;
+		}
+	}
+
+	// Platform part of the scanner, see ADS1115_wrapper.cpp and ADS1115_mock.cpp
+	bool _startContinuous(uint8_t input, uint8_t dataRate);
+	void _stopContinuous();
+	bool _selectInput(uint8_t input);
+	bool _readConversion(float& volts);
 };
-}
\ No newline at end of file
+} // namespace ADC
+
+#ifndef TARGET_MICRO
+namespace sensorSimulator
+{
+class signalSource;
+}
+
+namespace ads1115Mock
+{
+/**
+ * @brief Voltage the host mock converts on an input, 3.3 V by default
+ */
+void setInputVoltage(uint8_t input, float volts);
+
+/**
+ * @brief Replays a signal on an input, read at the replay time, see signalSource.hpp
+ *
+ * @param pSignal signal in volts, it must outlive its use, nullptr goes back to the fixed voltage
+ */
+void setInputSignal(uint8_t input, const sensorSimulator::signalSource* pSignal);
+
+/**
+ * @brief Makes the next scans configure the ALERT/RDY interrupt, the mock never signals it
+ */
+void setAlertAvailable(bool available);
+} // namespace ads1115Mock
+#endif
@@ -197,13 +197,11 @@ uint8_t ADS1115_Set_Volt_Range(ADS1115_handler* ads, uint8_t mode)
 	return retVal;
 }
 
-/* @brief
+/* @brief Selects the input multiplexer
  * @param ads: pointer to object handler of type ADS1115_handler
- * @param channel: ADC channel to measure
+ * @param channel: ADS1115_COMP_x_GND single ended or ADS1115_COMP_x_y differential input
  * @retval 1: if communication was successful
  * @retval 0: if error while trying to communicate
- *
- * TODO: Implement register manipulation for differential measurement
  */
 
 uint8_t ADS1115_Set_Compare_Channel(ADS1115_handler* ads, uint8_t channel)
@@ -230,11 +228,88 @@ uint8_t ADS1115_Set_Compare_Channel(ADS1115_handler* ads, uint8_t channel)
 			ads->configReg[0] |= (1 << 5);
 			ads->configReg[0] |= (1 << 6);
 			break;
+		case 4:
+			ads->configReg[0] &= ~(1 << 4);
+			ads->configReg[0] &= ~(1 << 5);
+			ads->configReg[0] &= ~(1 << 6);
+			break;
+		case 5:
+			ads->configReg[0] |= (1 << 4);
+			ads->configReg[0] &= ~(1 << 5);
+			ads->configReg[0] &= ~(1 << 6);
+			break;
+		case 6:
+			ads->configReg[0] &= ~(1 << 4);
+			ads->configReg[0] |= (1 << 5);
+			ads->configReg[0] &= ~(1 << 6);
+			break;
+		case 7:
+			ads->configReg[0] |= (1 << 4);
+			ads->configReg[0] |= (1 << 5);
+			ads->configReg[0] &= ~(1 << 6);
+			break;
 	}
 	uint8_t retVal;
 	retVal = _ADS1115_write_config_reg(ads);
 	return retVal;
 }
+/* @brief Sets the conversion rate, in continuous mode a new result is available at this rate
+ * @param ads: pointer to object handler of type ADS1115_handler
+ * @param rate: ADS1115_RATE_8SPS to ADS1115_RATE_860SPS
+ * @retval 1: if communication was successful
+ * @retval 0: if error while communicating
+ */
+uint8_t ADS1115_Set_Data_Rate(ADS1115_handler* ads, uint8_t rate)
+{
+	uint8_t retVal;
+
+	/*Data rate is bits 7:5 of the register LSB*/
+	ads->configReg[1] &= ~(0x07 << 5);
+	ads->configReg[1] |= ((rate & 0x07) << 5);
+
+	retVal = _ADS1115_write_config_reg(ads);
+	return retVal;
+}
+
+/* @brief Configures the ALERT/RDY pin to pulse low at the end of every conversion
+ * @param ads: pointer to object handler of type ADS1115_handler
+ * @retval 1: if communication was successful
+ * @retval 0: if error while communicating
+ */
+uint8_t ADS1115_Enable_Conversion_Ready(ADS1115_handler* ads)
+{
+	uint8_t hiThresh[2] = {0x80, 0x00};
+	uint8_t loThresh[2] = {0x00, 0x00};
+
+	/*Hi_thresh MSB set and Lo_thresh MSB cleared turn the comparator into a conversion ready signal*/
+	if (_ADS1115_I2C_reg_write((uint16_t)ads->address, (uint16_t)ADS1115RegHiThresh, hiThresh, 2) == 0)
+	{
+		return 0;
+	}
+
+	if (_ADS1115_I2C_reg_write((uint16_t)ads->address, (uint16_t)ADS1115RegLoThresh, loThresh, 2) == 0)
+	{
+		return 0;
+	}
+
+	/*Comparator queue bits 1:0 to 00, assert after one conversion, active low*/
+	ads->configReg[1] &= ~(1 << 0);
+	ads->configReg[1] &= ~(1 << 1);
+	ads->configReg[1] &= ~(1 << 3);
+
+	return _ADS1115_write_config_reg(ads);
+}
+
+/* @brief Reads the last conversion result without starting a new one, used in continuous mode
+ * @param ads: pointer to object handler of type ADS1115_handler
+ * @retval 1: if communication was successful
+ * @retval 0: if error while communicating
+ */
+uint8_t ADS1115_Read_Conversion(ADS1115_handler* ads)
+{
+	return _ADS1115_read_conversion_reg(ads);
+}
+
 /* @brief Make a single shot measurement
  * @param ads: pointer to object handler of type ADS1115_handler
  * @retval 1: if communication was successful
@@ -1,4 +1,52 @@
 #include "ADS1115_wrapper.hpp"
+#include "signalSource.hpp"
+
+// Voltage on each multiplexer input
+static std::array<float, ADS1115_MAX_SCAN_INPUTS> inputVoltages = {3.3f, 3.3f, 3.3f, 3.3f, 3.3f, 3.3f, 3.3f, 3.3f};
+
+// Signal replayed on each input instead of its fixed voltage, nullptr if none
+static std::array<const sensorSimulator::signalSource*, ADS1115_MAX_SCAN_INPUTS> inputSignals{};
+
+// Like the device, the conversion running when the input changes still returns the previous input
+static uint8_t selectedInput   = 0;
+static uint8_t convertingInput = 0;
+
+// Scans configure ALERT/RDY, no edge ever comes
+static bool alertAvailable = false;
+
+namespace ads1115Mock
+{
+void setInputVoltage(uint8_t input, float volts)
+{
+	if (input < inputVoltages.size())
+	{
+		inputVoltages[input] = volts;
+	}
+}
+
+void setInputSignal(uint8_t input, const sensorSimulator::signalSource* pSignal)
+{
+	if (input < inputSignals.size())
+	{
+		inputSignals[input] = pSignal;
+	}
+}
+
+void setAlertAvailable(bool available)
+{
+	alertAvailable = available;
+}
+} // namespace ads1115Mock
+
+static float inputVoltage(uint8_t input)
+{
+	if (nullptr != inputSignals[input])
+	{
+		return inputSignals[input]->valueAt(sensorSimulator::getReplayTimeMs());
+	}
+
+	return inputVoltages[input];
+}
 
 namespace ADC
 {
@@ -9,7 +57,42 @@ bool ADS1115::initImpl()
 
 float ADS1115::readVoltageImpl(uint8_t channel)
 {
-	return 3.3f;
+	if (true == _scanning)
+	{
+		return getLastSample(channel).value_or(0.0f);
+	}
+
+	return (channel < inputVoltages.size()) ? inputVoltage(channel) : 0.0f;
+}
+
+bool ADS1115::_startContinuous(uint8_t input, uint8_t dataRate)
+{
+	(void)dataRate;
+
+	_alertEnabled	= alertAvailable;
+	selectedInput	= input;
+	convertingInput = input;
+
+	return input < inputVoltages.size();
+}
+
+void ADS1115::_stopContinuous()
+{
+}
+
+bool ADS1115::_selectInput(uint8_t input)
+{
+	selectedInput = input;
+
+	return input < inputVoltages.size();
+}
+
+bool ADS1115::_readConversion(float& volts)
+{
+	volts			= inputVoltage(convertingInput);
+	convertingInput = selectedInput;
+
+	return true;
 }
 
-} // namespace ADC
\ No newline at end of file
+} // namespace ADC
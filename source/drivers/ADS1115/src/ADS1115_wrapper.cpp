@@ -1,11 +1,29 @@
 #include "ADS1115_wrapper.hpp"
-#include "ADS1115.h"
+#include "gpio_module.h"
+
+// Pins used by the ADS1115:
+//  - PB8/PB9 I2C1 SCL/SDA, see i2c_drv.c
+//  - PF3 ALERT/RDY (A3 on the Nucleo-F429ZI), on EXTI line 3
+// PF13/PF14 are the SPI chip selects (spi_drv.c) and EXTI line 2 is the rain gauge (PG2),
+// an EXTI line serves a single pin across all ports
+#define ADS1115_ALERT_PIN GPIO_PIN_3
+#define ADS1115_ALERT_PORT GPIOF
 
 namespace ADC
 {
 
 ADS1115_handler ADS1115_1;
 
+static ADS1115* alertOwner = nullptr; // Scanner notified by the ALERT/RDY interrupt
+
+static void ADS1115_alertCallback()
+{
+	if (nullptr != alertOwner)
+	{
+		alertOwner->conversionReadyISR();
+	}
+}
+
 bool ADS1115::initImpl()
 {
 	if (0 == ADS1115_init(&ADS1115_1, ADS1115_I2C_ADDR_GND))
@@ -35,6 +53,17 @@ float ADS1115::readVoltageImpl(uint8_t channel)
 {
 	float retVal = 0;
 
+	// While scanning the converter is busy, scanned inputs are served from their last sample
+	if (true == _scanning)
+	{
+		return getLastSample(channel).value_or(retVal);
+	}
+
+	if (0 == ADS1115_Set_Compare_Channel(&ADS1115_1, channel))
+	{
+		return retVal;
+	}
+
 	if (0 == ADS1115_Start_Single_Measurement(&ADS1115_1))
 	{
 		return retVal;
@@ -44,4 +73,50 @@ float ADS1115::readVoltageImpl(uint8_t channel)
 
 	return retVal;
 }
-} // namespace ADC
\ No newline at end of file
+
+bool ADS1115::_startContinuous(uint8_t input, uint8_t dataRate)
+{
+	if (0 == ADS1115_Set_Data_Rate(&ADS1115_1, dataRate))
+	{
+		return false;
+	}
+
+	if (0 == ADS1115_Set_Compare_Channel(&ADS1115_1, input))
+	{
+		return false;
+	}
+
+	// Without the conversion ready signal the scan is paced by the data rate
+	_alertEnabled = (0 != ADS1115_Enable_Conversion_Ready(&ADS1115_1));
+
+	if (true == _alertEnabled)
+	{
+		alertOwner = this;
+		initGPIOInterrupt(ADS1115_ALERT_PIN, ADS1115_ALERT_PORT, GPIO_MODE_IT_FALLING, ADS1115_alertCallback);
+	}
+
+	return 0 != ADS1115_Set_Mode(&ADS1115_1, ADS1115_CONT_MODE);
+}
+
+void ADS1115::_stopContinuous()
+{
+	ADS1115_Set_Mode(&ADS1115_1, ADS1115_SINGLE_SHOT);
+}
+
+bool ADS1115::_selectInput(uint8_t input)
+{
+	return 0 != ADS1115_Set_Compare_Channel(&ADS1115_1, input);
+}
+
+bool ADS1115::_readConversion(float& volts)
+{
+	if (0 == ADS1115_Read_Conversion(&ADS1115_1))
+	{
+		return false;
+	}
+
+	volts = ADS1115_Get_Volt(&ADS1115_1);
+
+	return true;
+}
+} // namespace ADC
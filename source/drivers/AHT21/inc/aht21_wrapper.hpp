@@ -1,21 +1,159 @@
 #pragma once
 
 #include "IHygrometer.hpp"
+#include "IMultiQuantity.hpp"
 #include "IThermometer.hpp"
 #include "driver_aht21.h"
+#include "sensorChannel.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint32_t AHT21_CONVERSION_TIME_MS	   = 80;  // Datasheet measurement time, the status is not polled before it
+constexpr uint32_t AHT21_CONVERSION_TIMEOUT_MS = 200; // A conversion still busy after this is reported as failed
 
 namespace sensor::thermometer
 {
 
-class AHT21 : public IThermometer<AHT21>, public hygrometer::IHygrometer<AHT21>
+class AHT21 : public IThermometer<AHT21>, public hygrometer::IHygrometer<AHT21>, public IMultiQuantity<AHT21, 2>
 {
   public:
+	// clang-format off
+	static constexpr std::array<channelInfo, 2> channels = {{{"temperature", "degC", 2, fieldType::INT16},
+															 {"humidity", "%RH", 0, fieldType::UINT8}}};
+	// clang-format on
+
 	bool				   initImpl();
 	std::optional<float>   readTemperatureImpl();
 	std::optional<uint8_t> readHumidityImpl();
 
+	/**
+	 * @brief Temperature and humidity from a single conversion
+	 */
+	bool sampleImpl(std::array<float, 2>& quantities);
+
+	/**
+	 * @brief Reads a channel declared in channels from the last sample(), nullopt if it failed
+	 */
+	template<size_t channel>
+	std::optional<float> readChannel()
+	{
+		return getSample<channel>();
+	}
+
+	/**
+	 * @brief Starts a temperature and humidity conversion, does nothing if one is in progress
+	 */
+	bool startConversionImpl()
+	{
+		if (conversionStatus::BUSY == _conversion)
+		{
+			return true;
+		}
+
+		if (false == _triggerConversion())
+		{
+			_conversion = conversionStatus::FAILED;
+
+			return false;
+		}
+
+		_conversionStartMs = _nowMs();
+		_conversion		   = conversionStatus::BUSY;
+
+		return true;
+	}
+
+	/**
+	 * @brief Advances the conversion, the bus is not used before AHT21_CONVERSION_TIME_MS
+	 */
+	conversionStatus pollConversionImpl()
+	{
+		if (conversionStatus::BUSY != _conversion)
+		{
+			return _conversion;
+		}
+
+		uint64_t elapsed = _nowMs() - _conversionStartMs;
+
+		if (elapsed < AHT21_CONVERSION_TIME_MS)
+		{
+			return _conversion;
+		}
+
+		_conversion = _readConversion();
+
+		if (conversionStatus::BUSY == _conversion && elapsed >= AHT21_CONVERSION_TIMEOUT_MS)
+		{
+			_conversion = conversionStatus::FAILED;
+		}
+
+		return _conversion;
+	}
+
+	std::optional<float> collectTemperatureImpl()
+	{
+		return (conversionStatus::READY == _conversion) ? std::optional<float>(_temperature) : std::nullopt;
+	}
+
+	std::optional<uint8_t> collectHumidityImpl()
+	{
+		return (conversionStatus::READY == _conversion) ? std::optional<uint8_t>(_humidity) : std::nullopt;
+	}
+
+	/**
+	 * @brief Quantities of a READY non blocking conversion, in channel order
+	 */
+	bool collectImpl(std::array<float, 2>& quantities)
+	{
+		if (conversionStatus::READY != _conversion)
+		{
+			return false;
+		}
+
+		quantities[0] = _temperature;
+		quantities[1] = static_cast<float>(_humidity);
+
+		return true;
+	}
+
   private:
-	aht21_handle_t _gs_handle;
+	aht21_handle_t	 _gs_handle;
+	conversionStatus _conversion		= conversionStatus::IDLE;
+	uint64_t		 _conversionStartMs = 0;
+	float			 _temperature		= 0.0f; /// Result of the last non blocking conversion
+	uint8_t			 _humidity			= 0;
+
+	// Platform part of the non blocking conversion, see aht21_wrapper.cpp and aht21_mock.cpp
+	bool			 _triggerConversion();
+	conversionStatus _readConversion();
+	uint64_t		 _nowMs();
 };
 
-} // namespace sensor::thermometer
\ No newline at end of file
+} // namespace sensor::thermometer
+
+#ifndef TARGET_MICRO
+namespace sensorSimulator
+{
+class signalSource;
+}
+
+namespace aht21Mock
+{
+/**
+ * @brief Conversion time of the host mock, AHT21_CONVERSION_TIME_MS by default
+ */
+void setConversionTime(uint32_t ms);
+
+/**
+ * @brief Replays signals instead of the fixed 25.5 degC and 70 %RH, see signalSource.hpp
+ *
+ * The signals are read at the replay time when a conversion completes, they must outlive
+ * their use. nullptr goes back to the fixed value.
+ *
+ * @param pTemperature signal in degC
+ * @param pHumidity signal in %RH, clamped to [0, 100]
+ */
+void setSignals(const sensorSimulator::signalSource* pTemperature, const sensorSimulator::signalSource* pHumidity);
+} // namespace aht21Mock
+#endif
\ No newline at end of file
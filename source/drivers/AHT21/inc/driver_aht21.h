@@ -251,6 +251,37 @@ uint8_t aht21_read_temperature(aht21_handle_t *handle, uint32_t *temperature_raw
  */
 uint8_t aht21_read_humidity(aht21_handle_t *handle, uint32_t *humidity_raw, uint8_t *humidity_s);
 
+/**
+ * @brief     start a temperature and humidity measurement without waiting for it
+ * @param[in] *handle pointer to an aht21 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 start measurement failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the result is read with aht21_read_measurement once the conversion is done
+ */
+uint8_t aht21_start_measurement(aht21_handle_t *handle);
+
+/**
+ * @brief      read the result of a measurement started with aht21_start_measurement
+ * @param[in]  *handle pointer to an aht21 handle structure
+ * @param[out] *temperature_raw pointer to a raw temperature buffer
+ * @param[out] *temperature_s pointer to a converted temperature buffer
+ * @param[out] *humidity_raw pointer to a raw humidity buffer
+ * @param[out] *humidity_s pointer to a converted humidity buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read measurement failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 data is not ready
+ *             - 5 crc is error
+ * @note       does not wait, data not ready is not an error and can be polled again
+ */
+uint8_t aht21_read_measurement(aht21_handle_t *handle, uint32_t *temperature_raw, float *temperature_s,
+                               uint32_t *humidity_raw, uint8_t *humidity_s);
+
 /**
  * @}
  */
@@ -1,4 +1,51 @@
 #include "aht21_wrapper.hpp"
+#include "signalSource.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// The mock takes as long as the sensor, blocking reads wait for the conversion
+static uint32_t conversionTimeMs = AHT21_CONVERSION_TIME_MS;
+
+static void waitConversion()
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(conversionTimeMs));
+}
+
+// Signals replayed instead of the fixed values, nullptr if none
+static const sensorSimulator::signalSource* pTemperatureSignal = nullptr;
+static const sensorSimulator::signalSource* pHumiditySignal	   = nullptr;
+
+static float temperature()
+{
+	return (nullptr != pTemperatureSignal) ? pTemperatureSignal->valueAt(sensorSimulator::getReplayTimeMs()) : 25.5f;
+}
+
+static uint8_t humidity()
+{
+	if (nullptr == pHumiditySignal)
+	{
+		return 70;
+	}
+
+	float value = pHumiditySignal->valueAt(sensorSimulator::getReplayTimeMs());
+
+	return static_cast<uint8_t>(std::clamp(value, 0.0f, 100.0f) + 0.5f);
+}
+
+namespace aht21Mock
+{
+void setConversionTime(uint32_t ms)
+{
+	conversionTimeMs = ms;
+}
+
+void setSignals(const sensorSimulator::signalSource* pTemperature, const sensorSimulator::signalSource* pHumidity)
+{
+	pTemperatureSignal = pTemperature;
+	pHumiditySignal	   = pHumidity;
+}
+} // namespace aht21Mock
 
 namespace sensor::thermometer
 {
@@ -10,12 +57,50 @@ bool AHT21::initImpl()
 
 std::optional<float> AHT21::readTemperatureImpl()
 {
-	return 25.5;
+	waitConversion();
+
+	return temperature();
 }
 
 std::optional<uint8_t> AHT21::readHumidityImpl()
 {
-	return 70;
+	waitConversion();
+
+	return humidity();
+}
+
+bool AHT21::sampleImpl(std::array<float, 2>& quantities)
+{
+	waitConversion();
+
+	quantities[0] = temperature();
+	quantities[1] = humidity();
+
+	return true;
+}
+
+bool AHT21::_triggerConversion()
+{
+	return true;
+}
+
+conversionStatus AHT21::_readConversion()
+{
+	if (_nowMs() - _conversionStartMs < conversionTimeMs)
+	{
+		return conversionStatus::BUSY;
+	}
+
+	_temperature = temperature();
+	_humidity	 = humidity();
+
+	return conversionStatus::READY;
+}
+
+// Non blocking conversions run on the replay time, faster than real time when the replay is
+uint64_t AHT21::_nowMs()
+{
+	return sensorSimulator::getReplayTimeMs();
 }
 
-} // namespace sensor::thermometer
\ No newline at end of file
+} // namespace sensor::thermometer
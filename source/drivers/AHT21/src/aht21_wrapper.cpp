@@ -98,4 +98,48 @@ std::optional<uint8_t> AHT21::readHumidityImpl()
 
 	return humidity;
 }
+
+bool AHT21::sampleImpl(std::array<float, 2>& quantities)
+{
+	float	 temperature;
+	uint32_t temperature_raw;
+	uint32_t humidity_raw;
+	uint8_t	 humidity;
+
+	/* read temperature and humidity in one conversion */
+	if (0 != aht21_read_temperature_humidity(&_gs_handle, &temperature_raw, &temperature, &humidity_raw, &humidity))
+	{
+		return false;
+	}
+
+	quantities[0] = temperature;
+	quantities[1] = static_cast<float>(humidity);
+
+	return true;
+}
+
+bool AHT21::_triggerConversion()
+{
+	return 0 == aht21_start_measurement(&_gs_handle);
+}
+
+conversionStatus AHT21::_readConversion()
+{
+	uint32_t temperature_raw;
+	uint32_t humidity_raw;
+
+	uint8_t res = aht21_read_measurement(&_gs_handle, &temperature_raw, &_temperature, &humidity_raw, &_humidity);
+
+	if (4 == res)
+	{
+		return conversionStatus::BUSY;
+	}
+
+	return (0 == res) ? conversionStatus::READY : conversionStatus::FAILED;
+}
+
+uint64_t AHT21::_nowMs()
+{
+	return timer_getTick();
+}
 } // namespace sensor::thermometer
\ No newline at end of file
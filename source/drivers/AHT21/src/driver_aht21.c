@@ -533,6 +533,113 @@ uint8_t aht21_read_humidity(aht21_handle_t *handle, uint32_t *humidity_raw, uint
     }
 }
 
+/**
+ * @brief     start a temperature and humidity measurement without waiting for it
+ * @param[in] *handle pointer to an aht21 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 start measurement failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the result is read with aht21_read_measurement once the conversion is done
+ */
+uint8_t aht21_start_measurement(aht21_handle_t *handle)
+{
+    uint8_t buf[3];
+
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+
+    buf[0] = 0xAC;                                                    /* set the addr */
+    buf[1] = 0x33;                                                    /* set 0x33 */
+    buf[2] = 0x00;                                                    /* set 0x00 */
+    if (a_aht21_iic_write(handle, buf, 3) != 0)                       /* write the command */
+    {
+        handle->debug_print("aht21: send command failed.\n");         /* send command failed */
+
+        return 1;                                                     /* return error */
+    }
+
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief      read the result of a measurement started with aht21_start_measurement
+ * @param[in]  *handle pointer to an aht21 handle structure
+ * @param[out] *temperature_raw pointer to a raw temperature buffer
+ * @param[out] *temperature_s pointer to a converted temperature buffer
+ * @param[out] *humidity_raw pointer to a raw humidity buffer
+ * @param[out] *humidity_s pointer to a converted humidity buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read measurement failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 data is not ready
+ *             - 5 crc is error
+ * @note       does not wait, data not ready is not an error and can be polled again
+ */
+uint8_t aht21_read_measurement(aht21_handle_t *handle, uint32_t *temperature_raw, float *temperature_s,
+                               uint32_t *humidity_raw, uint8_t *humidity_s)
+{
+    uint8_t status;
+    uint8_t buf[7];
+
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+
+    if (a_aht21_iic_read(handle, &status, 1) != 0)                    /* read the status */
+    {
+        handle->debug_print("aht21: read status failed.\n");          /* read status failed */
+
+        return 1;                                                     /* return error */
+    }
+    if ((status & 0x80) != 0)                                         /* check the busy bit */
+    {
+        return 4;                                                     /* conversion in progress */
+    }
+    if (a_aht21_iic_read(handle, buf, 7) != 0)                        /* read data */
+    {
+        handle->debug_print("aht21: read data failed.\n");            /* read data failed */
+
+        return 1;                                                     /* return error */
+    }
+    if (a_aht21_calc_crc(buf, 6) != buf[6])                           /* check the crc */
+    {
+        handle->debug_print("aht21: crc is error.\n");                /* crc is error */
+
+        return 5;                                                     /* return error */
+    }
+
+    *humidity_raw = (((uint32_t)buf[1]) << 16) |
+                    (((uint32_t)buf[2]) << 8) |
+                    (((uint32_t)buf[3]) << 0);                        /* set the humidity */
+    *humidity_raw = (*humidity_raw) >> 4;                             /* right shift 4 */
+    *humidity_s = (uint8_t)((float)(*humidity_raw)
+                            / 1048576.0f * 100.0f);                   /* convert the humidity */
+    *temperature_raw = (((uint32_t)buf[3]) << 16) |
+                       (((uint32_t)buf[4]) << 8) |
+                       (((uint32_t)buf[5]) << 0);                     /* set the temperature */
+    *temperature_raw = (*temperature_raw) & 0xFFFFF;                  /* cut the temperature part */
+    *temperature_s = (float)(*temperature_raw)
+                             / 1048576.0f * 200.0f
+                             - 50.0f;                                 /* convert the temperature */
+
+    return 0;                                                         /* success return 0 */
+}
+
 /**
  * @brief     set the chip register
  * @param[in] *handle pointer to an aht21 handle structure
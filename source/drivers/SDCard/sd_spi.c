@@ -5,29 +5,46 @@
 #include "diskio.h"
 #include "sd_spi.h"
 #include "spi_drv.h"
-
-uint16_t Timer1, Timer2;					/* 1ms Timer Counter */
+#include "timer.h"
+#include <string.h>
 
 static volatile DSTATUS Stat = STA_NOINIT;	/* Disk Status */
 static uint8_t CardType;                    /* Type 0:MMC, 1:SDC, 2:Block addressing */
 static uint8_t PowerFlag = 0;				/* Power flag */
 
+/***************************************
+ * Timeout functions
+ **************************************/
+
+/* returns the tick at which a timeout of ms milliseconds expires */
+static uint64_t SD_Deadline(uint32_t ms)
+{
+	return timer_getTick() + ms;
+}
+
+/* true while the deadline has not been reached */
+static uint8_t SD_BeforeDeadline(uint64_t deadline)
+{
+	return timer_getTick() < deadline;
+}
+
 /***************************************
  * SPI functions
  **************************************/
 
-/* slave select */
+/* slave select, the dummy byte gives the card a few clocks to see CS */
 static void SELECT(void)
 {
+	uint8_t dummy = 0xFF;
+
 	csWrite(SDCard, 0);
-	spiDelay(1);
+	spi_transmit(&dummy, 1);
 }
 
 /* slave deselect */
 static void DESELECT(void)
 {
 	csWrite(SDCard, 1);
-	spiDelay(1);
 }
 
 /* SPI transmit a byte */
@@ -60,10 +77,11 @@ static uint8_t SPI_RxByte(void)
 	return data;
 }
 
-/* SPI receive a byte via pointer */
-static void SPI_RxBytePtr(uint8_t *buff) 
+/* SPI receive a buffer, MOSI is held high while clocking the data in */
+static void SPI_RxBuffer(uint8_t *buff, uint16_t len)
 {
-	*buff = SPI_RxByte();
+	memset(buff, 0xFF, len);
+	spi_transmitReceive(buff, buff, len);
 }
 
 /***************************************
@@ -76,12 +94,12 @@ static uint8_t SD_ReadyWait(void)
 	uint8_t res;
 
 	/* timeout 500ms */
-	Timer2 = 500;
+	uint64_t deadline = SD_Deadline(500);
 
 	/* if SD goes ready, receives 0xFF */
 	do {
 		res = SPI_RxByte();
-	} while ((res != 0xFF) && Timer2);
+	} while ((res != 0xFF) && SD_BeforeDeadline(deadline));
 
 	return res;
 }
@@ -142,20 +160,18 @@ static bool SD_RxDataBlock(BYTE *buff, UINT len)
 	uint8_t token;
 
 	/* timeout 200ms */
-	Timer1 = 200;
+	uint64_t deadline = SD_Deadline(200);
 
 	/* loop until receive a response or timeout */
 	do {
 		token = SPI_RxByte();
-	} while((token == 0xFF) && Timer1);
+	} while((token == 0xFF) && SD_BeforeDeadline(deadline));
 
 	/* invalid response */
 	if(token != 0xFE) return FALSE;
 
-	/* receive data */
-	do {
-		SPI_RxBytePtr(buff++);
-	} while(len--);
+	/* receive data in a single transfer */
+	SPI_RxBuffer(buff, len);
 
 	/* discard CRC */
 	SPI_RxByte();
@@ -168,7 +184,7 @@ static bool SD_RxDataBlock(BYTE *buff, UINT len)
 #if _USE_WRITE == 1
 static bool SD_TxDataBlock(const uint8_t *buff, BYTE token)
 {
-	uint8_t resp;
+	uint8_t resp = 0;
 	uint8_t i = 0;
 
 	/* wait SD ready */
@@ -177,30 +193,30 @@ static bool SD_TxDataBlock(const uint8_t *buff, BYTE token)
 	/* transmit token */
 	SPI_TxByte(token);
 
-	/* if it's not STOP token, transmit data */
-	if (token != 0xFD)
+	/* STOP_TRAN token, the card goes busy while it flushes the last block */
+	if (token == 0xFD)
 	{
-		SPI_TxBuffer((uint8_t*)buff, 512);
-
-		/* discard CRC */
-		SPI_RxByte();
 		SPI_RxByte();
+		return (SD_ReadyWait() == 0xFF) ? TRUE : FALSE;
+	}
 
-		/* receive response */
-		while (i <= 64)
-		{
-			resp = SPI_RxByte();
+	SPI_TxBuffer((uint8_t*)buff, 512);
 
-			/* transmit 0x05 accepted */
-			if ((resp & 0x1F) == 0x05) break;
-			i++;
-		}
+	/* discard CRC */
+	SPI_RxByte();
+	SPI_RxByte();
 
-		/* recv buffer clear */
-		while (SPI_RxByte() == 0);
+	/* receive response */
+	while (i <= 64)
+	{
+		resp = SPI_RxByte();
+
+		/* transmit 0x05 accepted */
+		if ((resp & 0x1F) == 0x05) break;
+		i++;
 	}
 
-	/* transmit 0x05 accepted */
+	/* transmit 0x05 accepted, busy is checked before the next token/command */
 	if ((resp & 0x1F) == 0x05) return TRUE;
 
 	return FALSE;
@@ -212,8 +228,8 @@ static BYTE SD_SendCmd(BYTE cmd, uint32_t arg)
 {
 	uint8_t crc, res;
 
-	/* wait SD ready */
-	if (SD_ReadyWait() != 0xFF) return 0xFF;
+	/* wait SD ready, STOP_TRANSMISSION is sent while the card is still streaming data */
+	if (cmd != CMD12 && SD_ReadyWait() != 0xFF) return 0xFF;
 
 	/* transmit command */
 	SPI_TxByte(cmd); 					/* Command */
@@ -257,6 +273,10 @@ DSTATUS SD_disk_initialize(BYTE drv)
 	/* no disk */
 	if(Stat & STA_NODISK) return Stat;
 
+	/* identification must run below 400kHz, the bus is shared with the W25Q flash */
+	SPI_Speed_t busSpeed = spi_getClockSpeed();
+	spi_setClockSpeed(SPI_SPEED_SLOW);
+
 	/* power on */
 	SD_PowerOn();
 
@@ -270,7 +290,7 @@ DSTATUS SD_disk_initialize(BYTE drv)
 	if (SD_SendCmd(CMD0, 0) == 1)
 	{
 		/* timeout 1 sec */
-		Timer1 = 1000;
+		uint64_t deadline = SD_Deadline(1000);
 
 		/* SDC V2+ accept CMD8 command, http://elm-chan.org/docs/mmc/mmc_e.html */
 		if (SD_SendCmd(CMD8, 0x1AA) == 1)
@@ -287,10 +307,10 @@ DSTATUS SD_disk_initialize(BYTE drv)
 				/* ACMD41 with HCS bit */
 				do {
 					if (SD_SendCmd(CMD55, 0) <= 1 && SD_SendCmd(CMD41, 1UL << 30) == 0) break;
-				} while (Timer1);
+				} while (SD_BeforeDeadline(deadline));
 
 				/* READ_OCR */
-				if (Timer1 && SD_SendCmd(CMD58, 0) == 0)
+				if (SD_BeforeDeadline(deadline) && SD_SendCmd(CMD58, 0) == 0)
 				{
 					/* Check CCS bit */
 					for (n = 0; n < 4; n++)
@@ -319,10 +339,10 @@ DSTATUS SD_disk_initialize(BYTE drv)
 					if (SD_SendCmd(CMD1, 0) == 0) break; /* CMD1 */
 				}
 
-			} while (Timer1);
+			} while (SD_BeforeDeadline(deadline));
 
 			/* SET_BLOCKLEN */
-			if (!Timer1 || SD_SendCmd(CMD16, 512) != 0) type = 0;
+			if (!SD_BeforeDeadline(deadline) || SD_SendCmd(CMD16, 512) != 0) type = 0;
 		}
 	}
 
@@ -336,10 +356,14 @@ DSTATUS SD_disk_initialize(BYTE drv)
 	if (type)
 	{
 		Stat &= ~STA_NOINIT;
+
+		/* card identified, data transfers run at full speed */
+		spi_setClockSpeed(SPI_SPEED_FAST);
 	}
 	else
 	{
-		/* Initialization failed */
+		/* Initialization failed, the flash keeps its rate */
+		spi_setClockSpeed(busSpeed);
 		SD_PowerOff();
 	}
 
@@ -363,7 +387,7 @@ DRESULT SD_disk_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT count)
 	if (Stat & STA_NOINIT) return RES_NOTRDY;
 
 	/* convert to byte address */
-	if (!(CardType & CT_SD2)) sector *= 512;
+	if (!(CardType & CT_BLOCK)) sector *= 512;
 
 	SELECT();
 
@@ -408,7 +432,7 @@ DRESULT SD_disk_write(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count)
 	if (Stat & STA_PROTECT) return RES_WRPRT;
 
 	/* convert to byte address */
-	if (!(CardType & CT_SD2)) sector *= 512;
+	if (!(CardType & CT_BLOCK)) sector *= 512;
 
 	SELECT();
 
@@ -420,11 +444,11 @@ DRESULT SD_disk_write(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count)
 	}
 	else
 	{
-		/* WRITE_MULTIPLE_BLOCK */
-		if (CardType & CT_SD1)
+		/* WRITE_MULTIPLE_BLOCK, pre-erase hint so the card can prepare the whole run */
+		if (CardType & CT_SDC)
 		{
 			SD_SendCmd(CMD55, 0);
-			SD_SendCmd(CMD23, count); /* ACMD23 */
+			SD_SendCmd(CMD23, count); /* ACMD23 SET_WR_BLK_ERASE_COUNT */
 		}
 
 		if (SD_SendCmd(CMD25, sector) == 0)
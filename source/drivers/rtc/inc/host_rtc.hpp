@@ -67,6 +67,18 @@ class simulatedRTC : public rtcInterface
      */
 	void getDate(char* buffer, size_t bufferSize) const override;
 
+	/**
+     * @brief Retrieves time and date from a single read of the system clock.
+     * 
+     * @param dateTime Structure receiving the time and date.
+     */
+	void getDateTime(rtcDateTime& dateTime) const override;
+
+	/**
+     * @brief Retrieves the local time of the system clock as milliseconds since 01/01/1970.
+     */
+	uint64_t getEpochMs() const override;
+
   private:
 	/// Stores the current time and date.
 	std::tm currentTime;
@@ -11,4 +11,6 @@ class stm429RTC : public rtcInterface
 	void getTime(char* buffer, size_t bufferSize) const override;
 	bool setDate(uint8_t day, uint8_t month, uint16_t year) override;
 	void getDate(char* buffer, size_t bufferSize) const override;
+	void getDateTime(rtcDateTime& dateTime) const override;
+	uint64_t getEpochMs() const override;
 };
\ No newline at end of file
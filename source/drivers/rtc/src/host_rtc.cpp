@@ -1,4 +1,6 @@
 #include "host_rtc.hpp"
+#include "rtcCalendar.hpp"
+#include <chrono>
 #include <cstdio>
 #include <ctime>
 
@@ -83,6 +85,38 @@ void simulatedRTC::getDate(char* buffer, size_t bufferSize) const
 	std::snprintf(buffer, bufferSize, "%02d/%02d/%04d", currentTime_.tm_mday, currentTime_.tm_mon + 1, currentTime_.tm_year + 1900);
 }
 
+void simulatedRTC::getDateTime(rtcDateTime& dateTime) const
+{
+	std::time_t t			 = std::time(nullptr);
+	std::tm		currentTime_ = *std::localtime(&t);
+
+	dateTime.hour	 = static_cast<uint8_t>(currentTime_.tm_hour);
+	dateTime.minute	 = static_cast<uint8_t>(currentTime_.tm_min);
+	dateTime.seconds = static_cast<uint8_t>(currentTime_.tm_sec);
+	dateTime.day	 = static_cast<uint8_t>(currentTime_.tm_mday);
+	dateTime.month	 = static_cast<uint8_t>(currentTime_.tm_mon + 1);
+	dateTime.year	 = static_cast<uint16_t>(currentTime_.tm_year + 1900);
+}
+
+uint64_t simulatedRTC::getEpochMs() const
+{
+	// Local time like the other getters, the epoch is built from the broken down time
+	auto		sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+	auto		millis	   = std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count() % 1000;
+	std::time_t t		   = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch).count();
+	std::tm		currentTime_ = *std::localtime(&t);
+	rtcDateTime dateTime;
+
+	dateTime.hour	 = static_cast<uint8_t>(currentTime_.tm_hour);
+	dateTime.minute	 = static_cast<uint8_t>(currentTime_.tm_min);
+	dateTime.seconds = static_cast<uint8_t>(currentTime_.tm_sec);
+	dateTime.day	 = static_cast<uint8_t>(currentTime_.tm_mday);
+	dateTime.month	 = static_cast<uint8_t>(currentTime_.tm_mon + 1);
+	dateTime.year	 = static_cast<uint16_t>(currentTime_.tm_year + 1900);
+
+	return rtcCalendar::toEpochMs(dateTime) + static_cast<uint64_t>(millis);
+}
+
 void simulatedRTC::syncSystemTime()
 {
 	std::mktime(&currentTime);
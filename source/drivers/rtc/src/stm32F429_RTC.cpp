@@ -1,4 +1,5 @@
 #include "stm32F429_RTC.hpp"
+#include "rtcCalendar.hpp"
 #include "rtc_drv.h"
 #include <cstdio>
 
@@ -45,4 +46,23 @@ void stm429RTC::getDate(char* buffer, size_t bufferSize) const
 	rtc_get_date(&day, &month, &year);
 
 	snprintf(buffer, bufferSize, "%02d/%02d/%04d", day, month, year);
-}
\ No newline at end of file
+}
+
+void stm429RTC::getDateTime(rtcDateTime& dateTime) const
+{
+	// The HAL requires the time to be read before the date, reading the date unlocks the shadow registers
+	rtc_get_time(&dateTime.hour, &dateTime.minute, &dateTime.seconds);
+	rtc_get_date(&dateTime.day, &dateTime.month, &dateTime.year);
+}
+
+uint64_t stm429RTC::getEpochMs() const
+{
+	rtcDateTime dateTime;
+	uint16_t	millis;
+
+	// Same order as getDateTime(), the sub seconds are latched with the time
+	rtc_get_time_ms(&dateTime.hour, &dateTime.minute, &dateTime.seconds, &millis);
+	rtc_get_date(&dateTime.day, &dateTime.month, &dateTime.year);
+
+	return rtcCalendar::toEpochMs(dateTime) + millis;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file capture_module.h
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief TIM2 input capture of pulse edges into a circular DMA buffer
+
+	TIM2 is a free running 32 bit counter at CAPTURE_TIMER_HZ, each falling edge on PA15
+	(TIM2_CH1) latches the counter and DMA1 Stream5 copies it to the buffer, so pulses
+	cost no CPU time. The reader finds new captures from the DMA write position.
+
+ * @version 0.1
+ * @date 2025-04-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef CAPTURE_MODULE_H
+#define CAPTURE_MODULE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "stm32f4xx_hal.h"
+
+////////////////////////////////////////////////////////////////////////
+//							Function definition
+////////////////////////////////////////////////////////////////////////
+
+void	 initInputCapture(volatile uint32_t* buffer, uint16_t size, uint32_t timerHz);
+uint16_t inputCaptureWriteIndex(void);
+uint32_t inputCaptureCounter(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAPTURE_MODULE_H */
@@ -26,7 +26,10 @@ extern "C" {
 //							Function definition
 ////////////////////////////////////////////////////////////////////////
 
+typedef void (*gpioInterruptCallback)(void);
+
 void initGPIOOutput(uint16_t pin, GPIO_TypeDef* port);
+void initGPIOInterrupt(uint16_t pin, GPIO_TypeDef* port, uint32_t edge, gpioInterruptCallback callback);
 
 #ifdef __cplusplus
 }
@@ -13,6 +13,8 @@ int8_t rtc_set_time(uint8_t hour, uint8_t minute, uint8_t second);
 
 void rtc_get_time(uint8_t* hour, uint8_t* minute, uint8_t* second);
 
+void rtc_get_time_ms(uint8_t* hour, uint8_t* minute, uint8_t* second, uint16_t* millis);
+
 int8_t rtc_set_date(uint8_t day, uint8_t month, uint16_t year);
 
 void rtc_get_date(uint8_t* day, uint8_t* month, uint16_t* year);
@@ -28,6 +28,20 @@ typedef enum
 	SDCard
 } SPI_Devices_t;
 
+/**
+ * @brief SPI clock rates used by the bus devices.
+ *
+ * SPI_SPEED_SLOW keeps SCK below 400 kHz, as required by SD cards during
+ * identification. SPI_SPEED_DEFAULT is the rate set by spi_init().
+ * SPI_SPEED_FAST is the highest rate both devices accept.
+ */
+typedef enum
+{
+	SPI_SPEED_SLOW,
+	SPI_SPEED_DEFAULT,
+	SPI_SPEED_FAST
+} SPI_Speed_t;
+
 ////////////////////////////////////////////////////////////////////////
 //							Function definition
 ////////////////////////////////////////////////////////////////////////
@@ -77,6 +91,20 @@ void csWrite(SPI_Devices_t device, uint8_t val);
 
 void spiDelay(uint32_t delay);
 
+/**
+ * @brief Change the SPI clock rate without re-initializing the peripheral.
+ *
+ * @param speed The clock rate to use for the following transfers.
+ */
+void spi_setClockSpeed(SPI_Speed_t speed);
+
+/**
+ * @brief Get the SPI clock rate in use, e.g. to restore it after a slow phase.
+ *
+ * @return The clock rate of the following transfers.
+ */
+SPI_Speed_t spi_getClockSpeed(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,93 @@
+/**
+ * @file capture_module.c
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief TIM2 input capture of pulse edges into a circular DMA buffer
+ * @version 0.1
+ * @date 2025-04-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "capture_module.h"
+
+////////////////////////////////////////////////////////////////////////
+//							Global variables
+////////////////////////////////////////////////////////////////////////
+
+#define CAPTURE_PIN			 GPIO_PIN_15
+#define CAPTURE_PORT		 GPIOA
+#define CAPTURE_DMA_STREAM	 DMA1_Stream5 // TIM2_CH1 request is DMA1 Stream5 Channel3
+#define CAPTURE_INPUT_FILTER 0xFu		  // fDTS/32, N = 8, rejects contact bounce shorter than about 3 us
+
+static uint16_t captureSize = 0;
+
+////////////////////////////////////////////////////////////////////////
+//							Functions declarations
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Starts capturing falling edges into a circular buffer
+ *
+ * @param buffer destination of the captured counter values, written by DMA
+ * @param size number of entries in the buffer
+ * @param timerHz counter frequency, the timer clock must be a multiple of it
+ */
+void initInputCapture(volatile uint32_t* buffer, uint16_t size, uint32_t timerHz)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_TIM2_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	GPIO_InitStruct.Pin		  = CAPTURE_PIN;
+	GPIO_InitStruct.Mode	  = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull	  = GPIO_PULLUP;
+	GPIO_InitStruct.Speed	  = GPIO_SPEED_FREQ_LOW;
+	GPIO_InitStruct.Alternate = GPIO_AF1_TIM2;
+	HAL_GPIO_Init(CAPTURE_PORT, &GPIO_InitStruct);
+
+	captureSize = size;
+
+	// Circular peripheral to memory transfer of 32 bit words from CCR1
+	CAPTURE_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+	while (CAPTURE_DMA_STREAM->CR & DMA_SxCR_EN);
+	CAPTURE_DMA_STREAM->PAR	 = (uint32_t)&TIM2->CCR1;
+	CAPTURE_DMA_STREAM->M0AR = (uint32_t)buffer;
+	CAPTURE_DMA_STREAM->NDTR = size;
+	CAPTURE_DMA_STREAM->CR	 = DMA_CHANNEL_3 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_CIRC;
+	CAPTURE_DMA_STREAM->CR	|= DMA_SxCR_EN;
+
+	// APB1 runs at HCLK / 2, its timers are clocked at twice PCLK1
+	TIM2->CR1	= 0;
+	TIM2->PSC	= (2u * HAL_RCC_GetPCLK1Freq()) / timerHz - 1u;
+	TIM2->ARR	= 0xFFFFFFFFu;
+	TIM2->CCMR1 = TIM_CCMR1_CC1S_0 | (CAPTURE_INPUT_FILTER << TIM_CCMR1_IC1F_Pos);
+	TIM2->CCER	= TIM_CCER_CC1P | TIM_CCER_CC1E;
+	TIM2->DIER	= TIM_DIER_CC1DE;
+	TIM2->EGR	= TIM_EGR_UG;
+	TIM2->CR1	= TIM_CR1_CEN;
+}
+
+/**
+ * @brief Index of the next entry the DMA will write
+ */
+uint16_t inputCaptureWriteIndex(void)
+{
+	uint16_t remaining = (uint16_t)CAPTURE_DMA_STREAM->NDTR;
+
+	return (uint16_t)((captureSize - remaining) % captureSize);
+}
+
+/**
+ * @brief Current value of the capture counter
+ */
+uint32_t inputCaptureCounter(void)
+{
+	return TIM2->CNT;
+}
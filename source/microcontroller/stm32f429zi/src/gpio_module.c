@@ -15,6 +15,14 @@
 
 #include "gpio_module.h"
 
+////////////////////////////////////////////////////////////////////////
+//							Global variables
+////////////////////////////////////////////////////////////////////////
+
+#define GPIO_NUM_LINES 16
+
+static gpioInterruptCallback extiCallbacks[GPIO_NUM_LINES] = {0}; // Callback of each EXTI line, indexed by pin number
+
 ////////////////////////////////////////////////////////////////////////
 //							Functions declarations
 ////////////////////////////////////////////////////////////////////////
@@ -59,3 +67,83 @@ void initGPIOOutput(uint16_t pin, GPIO_TypeDef* port)
 	// Set the pin to a default state
 	HAL_GPIO_WritePin(port, pin, GPIO_PIN_SET);
 }
+
+/**
+ * @brief Initializes a GPIO pin as an interrupt input, the callback runs in interrupt context.
+ *
+ * @param pin The pin to be initialized, one pin per EXTI line across all ports.
+ * @param port The GPIO port to which the pin belongs.
+ * @param edge GPIO_MODE_IT_RISING, GPIO_MODE_IT_FALLING or GPIO_MODE_IT_RISING_FALLING.
+ * @param callback Function called on each edge.
+ */
+void initGPIOInterrupt(uint16_t pin, GPIO_TypeDef* port, uint32_t edge, gpioInterruptCallback callback)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {};
+	uint8_t			 line			 = 0;
+	IRQn_Type		 irq;
+
+	if (port == GPIOF)
+	{
+		__HAL_RCC_GPIOF_CLK_ENABLE();
+	}
+	else if (port == GPIOE)
+	{
+		__HAL_RCC_GPIOE_CLK_ENABLE();
+	}
+	else if (port == GPIOG)
+	{
+		__HAL_RCC_GPIOG_CLK_ENABLE();
+	}
+	// Add other cases for different GPIO ports as needed
+
+	else
+	{
+		// Error: Invalid GPIO port
+		while (1);
+	}
+
+	while ((pin >> line) != 1)
+	{
+		line++;
+	}
+
+	extiCallbacks[line] = callback;
+
+	// Open drain outputs such as the ADS1115 ALERT/RDY or reed switches need the pull up
+	GPIO_InitStruct.Pin	 = pin;
+	GPIO_InitStruct.Mode = edge;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	HAL_GPIO_Init(port, &GPIO_InitStruct);
+
+	if (line <= 4)
+	{
+		irq = (IRQn_Type)(EXTI0_IRQn + line);
+	}
+	else if (line <= 9)
+	{
+		irq = EXTI9_5_IRQn;
+	}
+	else
+	{
+		irq = EXTI15_10_IRQn;
+	}
+
+	HAL_NVIC_SetPriority(irq, 5, 0);
+	HAL_NVIC_EnableIRQ(irq);
+}
+
+/**
+ * @brief HAL EXTI callback, dispatches the edge to the callback registered for the pin.
+ *
+ * @param GPIO_Pin The pin that triggered the interrupt.
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	for (uint8_t line = 0; line < GPIO_NUM_LINES; line++)
+	{
+		if ((GPIO_Pin == (1U << line)) && (extiCallbacks[line] != 0))
+		{
+			extiCallbacks[line]();
+		}
+	}
+}
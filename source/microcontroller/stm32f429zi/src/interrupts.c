@@ -62,7 +62,6 @@ extern DMA_HandleTypeDef  hdma_usart3_rx;
 extern DMA_HandleTypeDef  hdma_usart3_tx;
 extern UART_HandleTypeDef huart3;
 
-extern uint16_t					Timer1, Timer2;
 extern struct hardwareTimeouts* pTask_1;
 //struct hardwareTimeouts task_1;
 
@@ -191,11 +190,7 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
 	/* USER CODE BEGIN SysTick_IRQn 0 */
-	if (Timer1 > 0)
-		Timer1--;
 
-	if (Timer2 > 0)
-		Timer2--;
 	/* USER CODE END SysTick_IRQn 0 */
 	HAL_IncTick();
 	/* USER CODE BEGIN SysTick_IRQn 1 */
@@ -251,4 +246,48 @@ void USART3_IRQHandler(void)
 
 	/* USER CODE END USART3_IRQn 1 */
 }
+
+/**
+* @brief EXTI lines used by initGPIOInterrupt(), HAL clears the flags and calls HAL_GPIO_EXTI_Callback.
+*/
+void EXTI0_IRQHandler(void)
+{
+	HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_0);
+}
+
+void EXTI1_IRQHandler(void)
+{
+	HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+	HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_2);
+}
+
+void EXTI3_IRQHandler(void)
+{
+	HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_3);
+}
+
+void EXTI4_IRQHandler(void)
+{
+	HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_4);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+	for (uint16_t pin = GPIO_PIN_5; pin <= GPIO_PIN_9; pin <<= 1)
+	{
+		HAL_GPIO_EXTI_IRQHandler(pin);
+	}
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+	for (uint32_t pin = GPIO_PIN_10; pin <= GPIO_PIN_15; pin <<= 1)
+	{
+		HAL_GPIO_EXTI_IRQHandler((uint16_t)pin);
+	}
+}
 /* USER CODE END 1 */
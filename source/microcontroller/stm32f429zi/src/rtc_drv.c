@@ -108,6 +108,20 @@ void rtc_get_time(uint8_t *hour, uint8_t *minute, uint8_t *second)
   *second = sTime.Seconds;
 }
 
+void rtc_get_time_ms(uint8_t *hour, uint8_t *minute, uint8_t *second, uint16_t *millis)
+{
+  RTC_TimeTypeDef sTime = {0};
+
+  HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
+
+  *hour = sTime.Hours;
+  *minute = sTime.Minutes;
+  *second = sTime.Seconds;
+
+  // The sub second register counts down from SynchPrediv once per synchronous prescaler tick
+  *millis = (uint16_t)(((sTime.SecondFraction - sTime.SubSeconds) * 1000U) / (sTime.SecondFraction + 1U));
+}
+
 int8_t rtc_set_date(uint8_t day, uint8_t month, uint16_t year)
 {
   RTC_DateTypeDef sDate = {0};
@@ -22,11 +22,18 @@
 //							    Defines
 ////////////////////////////////////////////////////////////////////////
 
+// Pins used by SPI1: PA5 SCK, PA6 MISO, PB5 MOSI, PF13 W25Q64 CS and PF14 SD card CS.
+// The chip selects are driven outputs, no other driver may configure PF13/PF14 (e.g. as EXTI inputs)
 #define CS_PIN_W25Q  GPIO_PIN_13
 #define CS_PORT_W25Q GPIOF
 #define CS_PIN_SD_CARD  GPIO_PIN_14
 #define CS_PORT_SD_CARD GPIOF
 
+// SPI1 sits on APB2 (16 MHz with the HSI clock tree): /64 -> 250 kHz, /16 -> 1 MHz, /2 -> 8 MHz
+#define SPI_PRESCALER_SLOW    SPI_BAUDRATEPRESCALER_64
+#define SPI_PRESCALER_DEFAULT SPI_BAUDRATEPRESCALER_16
+#define SPI_PRESCALER_FAST    SPI_BAUDRATEPRESCALER_2
+
 ////////////////////////////////////////////////////////////////////////
 //							    Private variables 
 ////////////////////////////////////////////////////////////////////////
@@ -104,7 +111,7 @@ int8_t spi_init()
     mySPIHandler.Init.CLKPolarity = SPI_POLARITY_LOW;
     mySPIHandler.Init.CLKPhase = SPI_PHASE_1EDGE;
     mySPIHandler.Init.NSS = SPI_NSS_SOFT;
-    mySPIHandler.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16;
+    mySPIHandler.Init.BaudRatePrescaler = SPI_PRESCALER_DEFAULT;
     mySPIHandler.Init.FirstBit = SPI_FIRSTBIT_MSB;
     mySPIHandler.Init.TIMode = SPI_TIMODE_DISABLE;
     mySPIHandler.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
@@ -217,4 +224,46 @@ int8_t _initCSPin(uint16_t pin, GPIO_TypeDef *port)
 void spiDelay(uint32_t delay)
 {
     HAL_Delay(delay);
-}
\ No newline at end of file
+}
+
+void spi_setClockSpeed(SPI_Speed_t speed)
+{
+    uint32_t prescaler;
+
+    switch (speed)
+    {
+        case SPI_SPEED_SLOW:
+            prescaler = SPI_PRESCALER_SLOW;
+            break;
+        case SPI_SPEED_FAST:
+            prescaler = SPI_PRESCALER_FAST;
+            break;
+        default:
+            prescaler = SPI_PRESCALER_DEFAULT;
+            break;
+    }
+
+    if (mySPIHandler.Init.BaudRatePrescaler == prescaler)
+    {
+        return;
+    }
+
+    // BR bits can only be changed while the peripheral is disabled
+    __HAL_SPI_DISABLE(&mySPIHandler);
+    MODIFY_REG(mySPIHandler.Instance->CR1, SPI_CR1_BR, prescaler);
+    mySPIHandler.Init.BaudRatePrescaler = prescaler;
+    __HAL_SPI_ENABLE(&mySPIHandler);
+}
+
+SPI_Speed_t spi_getClockSpeed(void)
+{
+    switch (mySPIHandler.Init.BaudRatePrescaler)
+    {
+        case SPI_PRESCALER_SLOW:
+            return SPI_SPEED_SLOW;
+        case SPI_PRESCALER_FAST:
+            return SPI_SPEED_FAST;
+        default:
+            return SPI_SPEED_DEFAULT;
+    }
+}
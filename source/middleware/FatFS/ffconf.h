@@ -90,7 +90,7 @@
 #define _USE_FASTSEEK 1
 /* This option switches fast seek feature. (0:Disable or 1:Enable) */
 
-#define _USE_EXPAND 0
+#define _USE_EXPAND 1
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 #define _USE_CHMOD 0
@@ -8,7 +8,9 @@
 	Provides a wrapper for filesystem operations, there are two filesystems used; littleFS and fatFS
 	A C standlard library filesystem handler is also used when builiding the firmware for the developing machine
 
-	The wrapper allows the client to select the filesystem via the constructor call 
+	The wrapper allows the client to select the filesystem via the constructor call, along with
+	the tag of the subsystem that owns it, every call is reported to the I/O accounting module
+	under that tag
 
 
  * @version 0.1
@@ -32,6 +34,7 @@ extern "C" {
 //								Includes
 ////////////////////////////////////////////////////////////////////////
 
+#include "ioAccounting.hpp"
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
@@ -55,6 +58,11 @@ struct FileHandler
 	virtual int	 read(char* buffer, size_t size)		  = 0;
 	virtual int	 write(const char* buffer, size_t size)	  = 0;
 	virtual int	 close()								  = 0;
+	virtual bool sync()									  = 0;
+	virtual bool seek(uint32_t offset)					  = 0;
+	virtual bool preallocate(uint32_t size)				  = 0;
+	virtual int	 size()									  = 0;
+	virtual bool exists(const char* fileName)			  = 0;
 	virtual ~FileHandler()								  = default;
 };
 
@@ -70,7 +78,8 @@ class CFileHandler : public FileHandler
 	/**
 	 * @brief Opens a file with the given mode.
 	 * @param[in] fileName Name of the file to open.
-	 * @param mode Access mode: 0 = read, 1 = write, 2 = append.
+	 * @param mode Access mode: 0 = read, 1 = write, 2 = append, 3 = create a new file, fails if it exists,
+	 *             4 = create or truncate an existing file.
 	 * @return true if the file was successfully opened, false otherwise.
 	 */
 	bool open(const char* fileName, uint8_t mode) override
@@ -87,6 +96,12 @@ class CFileHandler : public FileHandler
 			case 2:
 				cMode = "a";
 				break; // Append mode
+			case 3:
+				cMode = "wx";
+				break; // Create new mode
+			case 4:
+				cMode = "w";
+				break; // Create always mode
 			default:
 				return false;
 		}
@@ -147,6 +162,75 @@ class CFileHandler : public FileHandler
 
 		return 0;
 	}
+
+	/**
+	 * @brief Flushes buffered data of the opened file without closing it.
+	 * @return true on success, false otherwise.
+	 */
+	bool sync() override
+	{
+		if (!file)
+			return false;
+		return fflush(file) == 0;
+	}
+
+	/**
+	 * @brief Moves the file pointer to an absolute offset.
+	 * @param offset Offset in bytes from the start of the file.
+	 * @return true on success, false otherwise.
+	 */
+	bool seek(uint32_t offset) override
+	{
+		if (!file)
+			return false;
+		return fseek(file, static_cast<long>(offset), SEEK_SET) == 0;
+	}
+
+	/**
+	 * @brief Space reservation is left to the host filesystem.
+	 * @return true
+	 */
+	bool preallocate(uint32_t size) override
+	{
+		(void)size;
+		return true;
+	}
+
+	/**
+	 * @brief Gets the size of the opened file, the file pointer is preserved.
+	 * @return Size in bytes, negative on error.
+	 */
+	int size() override
+	{
+		if (!file)
+			return -1;
+
+		long position = ftell(file);
+		fseek(file, 0, SEEK_END);
+		long end = ftell(file);
+		fseek(file, position, SEEK_SET);
+
+		return static_cast<int>(end);
+	}
+
+	/**
+	 * @brief Checks whether a file exists, without changing the opened file.
+	 * @param fileName Name of the file.
+	 * @return true if the file exists, false otherwise.
+	 */
+	bool exists(const char* fileName) override
+	{
+		FILE* probe = fopen(fileName, "r");
+
+		if (probe == nullptr)
+		{
+			return false;
+		}
+
+		fclose(probe);
+
+		return true;
+	}
 };
 
 #ifdef TARGET_MICRO
@@ -156,8 +240,9 @@ class CFileHandler : public FileHandler
 class LittleFSHandler : public FileHandler
 {
   private:
-	lfs_t	   lfs;	 ///< LittleFS instance.
-	lfs_file_t file; ///< LittleFS file handle.
+	static inline lfs_t lfs;			 ///< LittleFS instance, shared by all handlers since they use the same flash.
+	static inline bool	mounted = false; ///< Set once the shared instance is mounted.
+	lfs_file_t			file;			 ///< LittleFS file handle.
 
   public:
 	/**
@@ -166,6 +251,11 @@ class LittleFSHandler : public FileHandler
 	 */
 	bool mount() override
 	{
+		if (mounted)
+		{
+			return true;
+		}
+
 		flash_init();
 
 		int res = lfs_mount(&lfs, &cfg);
@@ -185,13 +275,16 @@ class LittleFSHandler : public FileHandler
 			}
 		}
 
+		mounted = true;
+
 		return true;
 	}
 
 	/**
 	 * @brief Opens a file on the LittleFS filesystem.
 	 * @param fileName Name of the file to open.
-	 * @param mode Access mode: 0 = read, 1 = write, 2 = append.
+	 * @param mode Access mode: 0 = read, 1 = write, 2 = append, 3 = create a new file, fails if it exists,
+	 *             4 = create or truncate an existing file.
 	 * @return true if the file was successfully opened, false otherwise.
 	 */
 	bool open(const char* fileName, uint8_t mode) override
@@ -204,11 +297,17 @@ class LittleFSHandler : public FileHandler
 				flags = LFS_O_RDONLY;
 				break; // Read mode
 			case 1:
-				flags = LFS_O_WRONLY | LFS_O_CREAT;
+				flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC;
 				break; // Write mode
 			case 2:
 				flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND;
 				break; // Append mode
+			case 3:
+				flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_EXCL;
+				break; // Create new mode
+			case 4:
+				flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC;
+				break; // Create always mode
 			default:
 				return false;
 		}
@@ -253,21 +352,77 @@ class LittleFSHandler : public FileHandler
 	{
 		return lfs_file_close(&lfs, &file);
 	}
+
+	/**
+	 * @brief Commits pending data of the opened file to flash without closing it.
+	 * @return true on success, false otherwise.
+	 */
+	bool sync() override
+	{
+		return lfs_file_sync(&lfs, &file) >= 0;
+	}
+
+	/**
+	 * @brief Moves the file pointer to an absolute offset.
+	 * @param offset Offset in bytes from the start of the file.
+	 * @return true on success, false otherwise.
+	 */
+	bool seek(uint32_t offset) override
+	{
+		return lfs_file_seek(&lfs, &file, static_cast<lfs_soff_t>(offset), LFS_SEEK_SET) >= 0;
+	}
+
+	/**
+	 * @brief LittleFS is copy-on-write and allocates blocks on demand, nothing to reserve.
+	 * @return true
+	 */
+	bool preallocate(uint32_t size) override
+	{
+		(void)size;
+		return true;
+	}
+
+	/**
+	 * @brief Gets the size of the opened file.
+	 * @return Size in bytes, negative on error.
+	 */
+	int size() override
+	{
+		return lfs_file_size(&lfs, &file);
+	}
+
+	/**
+	 * @brief Checks whether a file exists, without changing the opened file.
+	 * @param fileName Name of the file.
+	 * @return true if the file exists, false otherwise.
+	 */
+	bool exists(const char* fileName) override
+	{
+		struct lfs_info info;
+
+		return lfs_stat(&lfs, fileName, &info) >= 0;
+	}
 };
 
 /**
- * @name 
- * @brief 
- * 
+ * @brief File handler implementation for FatFS on the SD card.
+ *
+ * Files opened for reading get a cluster link map table, so seeks are resolved
+ * from RAM instead of following the FAT chain. New files can be given a
+ * contiguous cluster run to be filled first, see preallocate().
  */
 class fatFSHandler : public FileHandler
 {
   private:
+	/// Link map entries, a contiguous file needs 4, each extra fragment needs 2 more
+	static constexpr uint8_t LINK_MAP_SIZE = 32;
+
 	FATFS	fs;
 	FATFS*	pfs;
 	FIL		fil;
 	FRESULT fres;
 	DWORD	fre_clust;
+	DWORD	linkMap[LINK_MAP_SIZE]; ///< Cluster link map table used by fast seek.
 
   public:
 	/**
@@ -289,7 +444,8 @@ class fatFSHandler : public FileHandler
 	/**
 		* @brief Opens a file on the FatFS filesystem.
 		* @param fileName Name of the file to open.
-		* @param mode Access mode: 0 = read, 1 = write, 2 = append.
+		* @param mode Access mode: 0 = read, 1 = write, 2 = append, 3 = create a new file, fails if it exists,
+		*             4 = create or truncate an existing file.
 		* @return true if the file was successfully opened, false otherwise.
 		*/
 	bool open(const char* fileName, uint8_t mode) override
@@ -306,7 +462,13 @@ class fatFSHandler : public FileHandler
 				break; // Write mode
 			case 2:
 				flags = FA_OPEN_APPEND | FA_WRITE;
-				break; // Append mode
+				break; // Append mode, creates a missing file
+			case 3:
+				flags = FA_CREATE_NEW | FA_WRITE;
+				break; // Create new mode
+			case 4:
+				flags = FA_CREATE_ALWAYS | FA_WRITE;
+				break; // Create always mode
 			default:
 				return false;
 		}
@@ -316,6 +478,19 @@ class fatFSHandler : public FileHandler
 			return false;
 		}
 
+		if (mode == 0)
+		{
+			// Read only files do not grow, so the link map stays valid until close
+			linkMap[0] = LINK_MAP_SIZE;
+			fil.cltbl  = linkMap;
+
+			if (f_lseek(&fil, CREATE_LINKMAP) != FR_OK)
+			{
+				// Too fragmented for the table, fall back to FAT chain walks
+				fil.cltbl = nullptr;
+			}
+		}
+
 		return true;
 	}
 
@@ -362,6 +537,63 @@ class fatFSHandler : public FileHandler
 
 		return 0;
 	}
+
+	/**
+		* @brief Flushes cached data and the directory entry of the opened file without closing it.
+		* @return true on success, false otherwise.
+		*/
+	bool sync() override
+	{
+		return f_sync(&fil) == FR_OK;
+	}
+
+	/**
+		* @brief Moves the file pointer to an absolute offset, using the link map when available.
+		* @param offset Offset in bytes from the start of the file.
+		* @return true on success, false otherwise.
+		*/
+	bool seek(uint32_t offset) override
+	{
+		return f_lseek(&fil, offset) == FR_OK;
+	}
+
+	/**
+		* @brief Prepares a contiguous cluster run for a newly created (empty) file.
+		*
+		* f_expand(..., 0) only finds the run and marks it as the next allocation point,
+		* nothing is allocated and the file size is not changed. Appends fill the run in
+		* order while nothing else writes to the volume, but contiguity is not guaranteed
+		* once the file is written: another file written meanwhile, or growing past the
+		* run, takes clusters from elsewhere.
+		*
+		* @param size Expected file size in bytes.
+		* @return true if a contiguous area was found, false otherwise.
+		*/
+	bool preallocate(uint32_t size) override
+	{
+		return f_expand(&fil, size, 0) == FR_OK;
+	}
+
+	/**
+		* @brief Gets the size of the opened file.
+		* @return Size in bytes.
+		*/
+	int size() override
+	{
+		return static_cast<int>(f_size(&fil));
+	}
+
+	/**
+		* @brief Checks whether a file exists, without changing the opened file.
+		* @param fileName Name of the file.
+		* @return true if the file exists, false otherwise.
+		*/
+	bool exists(const char* fileName) override
+	{
+		FILINFO info;
+
+		return f_stat(fileName, &info) == FR_OK;
+	}
 };
 #endif
 
@@ -379,13 +611,15 @@ class fileSysWrapper
 #endif
 
 	FileHandler* activeHandler = nullptr; ///< Pointer to the active file handler.
+	ioTag_t		 tag;					  ///< Subsystem the I/O is accounted to.
 
   public:
 	/**
 	 * @brief Constructs a file system wrapper with a specified handler.
 	 * @param fs Type of filesystem (0 = standard, 1 = LittleFS if enabled, 2 = fatFS).
+	 * @param ioTag Subsystem that owns the wrapper, used for I/O accounting.
 	 */
-	fileSysWrapper(uint8_t fs)
+	fileSysWrapper(uint8_t fs, ioTag_t ioTag) : tag(ioTag)
 	{
 #ifndef TARGET_MICRO
 		if (fs == 0)
@@ -403,28 +637,43 @@ class fileSysWrapper
 		}
 #endif
 	}
+
+	/**
+	 * @brief Subsystem the I/O of this wrapper is accounted to.
+	 */
+	ioTag_t getTag() const
+	{
+		return tag;
+	}
+
 	/**
 	 * @brief Mounts the selected filesystem.
 	 * @return true if successful, false otherwise.
 	 */
 	bool mount()
 	{
-#ifdef TARGET_MICRO
-		return activeHandler ? activeHandler->mount() : false;
-#else
-		return true;
-#endif
+		uint64_t start	= ioAccounting::begin(tag); // Formatting programs and erases the medium
+		bool	 status = activeHandler ? activeHandler->mount() : false;
+		ioAccounting::end(tag, ioOperation_t::MOUNT, start, status);
+
+		return status;
 	}
 
 	/**
 	 * @brief Opens a file using the selected filesystem.
 	 * @param fileName Name of the file to open.
-	 * @param mode Access mode: 0 = read, 1 = write, 2 = append.
+	 * @param mode Access mode: 0 = read, 1 = write, 2 = append, 3 = create a new file, fails if it exists,
+	 *             4 = create or truncate an existing file. Mode 1 fails on an existing file with
+	 *             FatFS, use 4 to rewrite a file on every backend.
 	 * @return true if the file was successfully opened, false otherwise.
 	 */
 	bool open(const char* fileName, uint8_t mode)
 	{
-		return activeHandler ? activeHandler->open(fileName, mode) : false;
+		uint64_t start	= ioAccounting::begin(tag);
+		bool	 status = activeHandler ? activeHandler->open(fileName, mode) : false;
+		ioAccounting::end(tag, ioOperation_t::OPEN, start, status);
+
+		return status;
 	}
 
 	/**
@@ -435,7 +684,11 @@ class fileSysWrapper
 	 */
 	int read(char* buffer, size_t size)
 	{
-		return activeHandler ? activeHandler->read(buffer, size) : 0;
+		uint64_t start	   = ioAccounting::begin(tag);
+		int		 bytesRead = activeHandler ? activeHandler->read(buffer, size) : 0;
+		ioAccounting::end(tag, ioOperation_t::READ, start, bytesRead >= 0, bytesRead > 0 ? static_cast<uint32_t>(bytesRead) : 0);
+
+		return bytesRead;
 	}
 
 	/**
@@ -446,7 +699,11 @@ class fileSysWrapper
 	 */
 	int write(const char* buffer, size_t size)
 	{
-		return activeHandler ? activeHandler->write(buffer, size) : 0;
+		uint64_t start		  = ioAccounting::begin(tag);
+		int		 bytesWritten = activeHandler ? activeHandler->write(buffer, size) : 0;
+		ioAccounting::end(tag, ioOperation_t::WRITE, start, bytesWritten == static_cast<int>(size), bytesWritten > 0 ? static_cast<uint32_t>(bytesWritten) : 0);
+
+		return bytesWritten;
 	}
 
 	/**
@@ -455,7 +712,71 @@ class fileSysWrapper
 	 */
 	int close()
 	{
-		return activeHandler->close();
+		uint64_t start	= ioAccounting::begin(tag);
+		int		 status = activeHandler->close();
+		ioAccounting::end(tag, ioOperation_t::CLOSE, start, 0 == status);
+
+		return status;
+	}
+
+	/**
+	 * @brief Flushes the currently opened file to the storage without closing it.
+	 * @return true if successful, false otherwise.
+	 */
+	bool sync()
+	{
+		uint64_t start	= ioAccounting::begin(tag);
+		bool	 status = activeHandler ? activeHandler->sync() : false;
+		ioAccounting::end(tag, ioOperation_t::SYNC, start, status);
+
+		return status;
+	}
+
+	/**
+	 * @brief Moves the file pointer of the currently opened file.
+	 * @param offset Offset in bytes from the start of the file.
+	 * @return true if successful, false otherwise.
+	 */
+	bool seek(uint32_t offset)
+	{
+		uint64_t start	= ioAccounting::begin(tag); // Seeking may flush cached data
+		bool	 status = activeHandler ? activeHandler->seek(offset) : false;
+		ioAccounting::end(tag, ioOperation_t::SEEK, start, status);
+
+		return status;
+	}
+
+	/**
+	 * @brief Reserves space for a newly created file.
+	 * @param size Expected file size in bytes.
+	 * @return true if the space was reserved, false otherwise.
+	 */
+	bool preallocate(uint32_t size)
+	{
+		uint64_t start	= ioAccounting::begin(tag);
+		bool	 status = activeHandler ? activeHandler->preallocate(size) : false;
+		ioAccounting::end(tag, ioOperation_t::PREALLOCATE, start, status);
+
+		return status;
+	}
+
+	/**
+	 * @brief Gets the size of the currently opened file.
+	 * @return Size in bytes, negative on error.
+	 */
+	int size()
+	{
+		return activeHandler ? activeHandler->size() : -1;
+	}
+
+	/**
+	 * @brief Checks whether a file exists, the opened file is not affected.
+	 * @param fileName Name of the file.
+	 * @return true if the file exists, false otherwise.
+	 */
+	bool exists(const char* fileName)
+	{
+		return activeHandler ? activeHandler->exists(fileName) : false;
 	}
 
 	/**
@@ -463,6 +784,6 @@ class fileSysWrapper
 	 */
 	~fileSysWrapper()
 	{
-		close(); // Close the file if open
+		activeHandler->close(); // Close the file if open, not accounted
 	}
 };
@@ -0,0 +1,164 @@
+/**
+ * @file ioAccounting.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Storage I/O accounting
+
+	Every fileSysWrapper belongs to a caller (logger, metadata), identified by a tag given
+	in its constructor. The wrapper reports each mount, open, close, read, write, sync, seek
+	and preallocation to this module, which keeps per tag counters of calls, bytes and call
+	latencies.
+
+	Backends that know about the physical medium also report it; the LittleFS block device
+	callbacks count page programs and block erases of the W25Q64 flash. Those are attributed
+	to the tag of the wrapper call in progress. The SD card hides its physical operations
+	behind its own controller, so FatFS only contributes logical counters.
+
+	Counters can be printed from the terminal state machine, or by the host build at any
+	time, to compare bytes requested against bytes programmed (write amplification).
+
+	A caller that writes in chunks calibrated for its medium also reports the chunk size,
+	which is printed with its counters. It is a setting, reset() keeps it.
+
+ * @version 0.1
+ * @date 2025-04-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//								Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+//							     Types
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Subsystem that owns a filesystem wrapper
+ */
+enum class ioTag_t : uint8_t
+{
+	LOGGER = 0, ///< Measurement records and their journal
+	METADATA,	///< Logger metadata in internal storage
+
+	NUM_TAGS
+};
+
+/**
+ * @brief Operation reported by a filesystem wrapper
+ */
+enum class ioOperation_t : uint8_t
+{
+	MOUNT,
+	OPEN,
+	CLOSE,
+	READ,
+	WRITE,
+	SYNC,
+	SEEK,
+	PREALLOCATE
+};
+
+/**
+ * @brief Counters kept for each tag
+ */
+struct ioCounters_t
+{
+	uint32_t mounts;		  ///< Successful mount calls
+	uint32_t opens;			  ///< Successful open calls
+	uint32_t closes;		  ///< Close calls
+	uint32_t reads;			  ///< Read calls
+	uint32_t writes;		  ///< Write calls
+	uint32_t syncs;			  ///< Sync calls
+	uint32_t seeks;			  ///< Seek calls
+	uint32_t preallocations;  ///< Preallocate calls
+	uint32_t errors;		  ///< Calls that failed
+	uint64_t bytesRead;		  ///< Bytes returned by read calls
+	uint64_t bytesWritten;	  ///< Bytes accepted by write calls
+	uint64_t totalLatencyMs;  ///< Sum of the duration of every call
+	uint32_t maxLatencyMs;	  ///< Longest call
+	uint32_t pagePrograms;	  ///< Physical page programs, when the backend reports them
+	uint64_t programmedBytes; ///< Bytes sent to the medium by those page programs
+	uint32_t blockErases;	  ///< Physical block erases, when the backend reports them
+};
+
+////////////////////////////////////////////////////////////////////////
+//						  Function declarations
+////////////////////////////////////////////////////////////////////////
+
+namespace ioAccounting
+{
+
+/**
+ * @brief Marks the start of a wrapper call
+ *
+ * Physical operations reported until the matching end() are attributed to the tag.
+ *
+ * @param tag caller of the wrapper
+ * @return uint64_t start time, to be passed to end()
+ */
+uint64_t begin(ioTag_t tag);
+
+/**
+ * @brief Marks the end of a wrapper call and updates the tag counters
+ *
+ * @param tag caller of the wrapper
+ * @param operation operation that was performed
+ * @param startTime value returned by begin()
+ * @param status true if the call succeeded
+ * @param bytes bytes read or written by the call
+ */
+void end(ioTag_t tag, ioOperation_t operation, uint64_t startTime, bool status, uint32_t bytes = 0);
+
+/**
+ * @brief Called by a block device when it programs the medium
+ *
+ * @param pages number of pages programmed
+ * @param bytes number of bytes programmed
+ */
+void countPageProgram(uint32_t pages, uint32_t bytes);
+
+/**
+ * @brief Called by a block device when it erases a block of the medium
+ */
+void countBlockErase();
+
+/**
+ * @brief Gets the counters of a tag
+ */
+const ioCounters_t& getCounters(ioTag_t tag);
+
+/**
+ * @brief Gets a printable name for a tag
+ */
+const char* getTagName(ioTag_t tag);
+
+/**
+ * @brief Sets the write chunk size used by a tag, printed in the report
+ *
+ * @param tag caller of the wrapper
+ * @param chunkSize bytes per write, 0 if the caller does not write in chunks
+ */
+void setWriteChunkSize(ioTag_t tag, uint16_t chunkSize);
+
+/**
+ * @brief Gets the write chunk size reported by a tag, 0 if none
+ */
+uint16_t getWriteChunkSize(ioTag_t tag);
+
+/**
+ * @brief Clears the counters of every tag
+ */
+void reset();
+
+/**
+ * @brief Prints the counters of every tag
+ */
+void printReport();
+
+} // namespace ioAccounting
@@ -0,0 +1,222 @@
+/**
+ * @file ioAccounting.cpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Storage I/O accounting, for a better description go to the header file
+ * @version 0.1
+ * @date 2025-04-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////
+//								Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "ioAccounting.hpp"
+#include "record_writer.hpp"
+#include "virtualTimer.hpp"
+#include <array>
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////
+//							 Private variables
+////////////////////////////////////////////////////////////////////////
+
+static constexpr size_t NUM_IO_TAGS = static_cast<size_t>(ioTag_t::NUM_TAGS);
+
+// clang-format off
+static constexpr std::array<const char*, NUM_IO_TAGS> tagNames =
+{
+	"logger",
+	"metadata",
+};
+// clang-format on
+
+static std::array<ioCounters_t, NUM_IO_TAGS> counters{};
+static std::array<uint16_t, NUM_IO_TAGS>	 writeChunkSizes{}; // Not counters, reset() keeps them
+static ioTag_t								 activeTag = ioTag_t::LOGGER;
+
+using countBuff_t = std::array<char, 24>; // Up to 20 digits plus two decimals, newlib nano printf has no %llu
+
+////////////////////////////////////////////////////////////////////////
+//						  Private functions
+////////////////////////////////////////////////////////////////////////
+
+static const char* formatCount(countBuff_t& buff, uint64_t value)
+{
+	recordWriter(buff).appendUnsigned64(value).finish();
+
+	return buff.data();
+}
+
+////////////////////////////////////////////////////////////////////////
+//						  Function implementation
+////////////////////////////////////////////////////////////////////////
+
+namespace ioAccounting
+{
+
+uint64_t begin(ioTag_t tag)
+{
+	activeTag = tag;
+
+	return systick::getTicks();
+}
+
+void end(ioTag_t tag, ioOperation_t operation, uint64_t startTime, bool status, uint32_t bytes)
+{
+	ioCounters_t& tagCounters = counters[static_cast<size_t>(tag)];
+	uint32_t	  latency	  = static_cast<uint32_t>(systick::getTicks() - startTime);
+
+	tagCounters.totalLatencyMs += latency;
+
+	if (latency > tagCounters.maxLatencyMs)
+	{
+		tagCounters.maxLatencyMs = latency;
+	}
+
+	if (false == status)
+	{
+		tagCounters.errors++;
+	}
+
+	switch (operation)
+	{
+		case ioOperation_t::MOUNT:
+		{
+			if (true == status)
+			{
+				tagCounters.mounts++;
+			}
+		}
+		break;
+		case ioOperation_t::OPEN:
+		{
+			if (true == status)
+			{
+				tagCounters.opens++;
+			}
+		}
+		break;
+		case ioOperation_t::CLOSE:
+		{
+			tagCounters.closes++;
+		}
+		break;
+		case ioOperation_t::READ:
+		{
+			tagCounters.reads++;
+			tagCounters.bytesRead += bytes;
+		}
+		break;
+		case ioOperation_t::WRITE:
+		{
+			tagCounters.writes++;
+			tagCounters.bytesWritten += bytes;
+		}
+		break;
+		case ioOperation_t::SYNC:
+		{
+			tagCounters.syncs++;
+		}
+		break;
+		case ioOperation_t::SEEK:
+		{
+			tagCounters.seeks++;
+		}
+		break;
+		case ioOperation_t::PREALLOCATE:
+		{
+			tagCounters.preallocations++;
+		}
+		break;
+		default:
+		{
+			// do nothing
+		}
+		break;
+	}
+}
+
+void countPageProgram(uint32_t pages, uint32_t bytes)
+{
+	ioCounters_t& tagCounters = counters[static_cast<size_t>(activeTag)];
+
+	tagCounters.pagePrograms += pages;
+	tagCounters.programmedBytes += bytes;
+}
+
+void countBlockErase()
+{
+	counters[static_cast<size_t>(activeTag)].blockErases++;
+}
+
+const ioCounters_t& getCounters(ioTag_t tag)
+{
+	return counters[static_cast<size_t>(tag)];
+}
+
+const char* getTagName(ioTag_t tag)
+{
+	return (tag < ioTag_t::NUM_TAGS) ? tagNames[static_cast<size_t>(tag)] : "unknown";
+}
+
+void setWriteChunkSize(ioTag_t tag, uint16_t chunkSize)
+{
+	writeChunkSizes[static_cast<size_t>(tag)] = chunkSize;
+}
+
+uint16_t getWriteChunkSize(ioTag_t tag)
+{
+	return writeChunkSizes[static_cast<size_t>(tag)];
+}
+
+void reset()
+{
+	counters.fill(ioCounters_t{});
+}
+
+void printReport()
+{
+	printf("#############################\r\n");
+	printf("Storage I/O report\r\n");
+	printf("#############################\r\n");
+
+	countBuff_t countBuff;
+
+	for (size_t index = 0; index < NUM_IO_TAGS; index++)
+	{
+		const ioCounters_t& tagCounters = counters[index];
+
+		printf("[%s]\r\n", tagNames[index]);
+		printf("  mount: %lu | open: %lu | close: %lu | sync: %lu | errors: %lu\r\n", static_cast<unsigned long>(tagCounters.mounts), static_cast<unsigned long>(tagCounters.opens), static_cast<unsigned long>(tagCounters.closes), static_cast<unsigned long>(tagCounters.syncs), static_cast<unsigned long>(tagCounters.errors));
+		printf("  seek: %lu | preallocate: %lu\r\n", static_cast<unsigned long>(tagCounters.seeks), static_cast<unsigned long>(tagCounters.preallocations));
+		printf("  read: %lu calls, %s bytes\r\n", static_cast<unsigned long>(tagCounters.reads), formatCount(countBuff, tagCounters.bytesRead));
+		printf("  write: %lu calls, %s bytes\r\n", static_cast<unsigned long>(tagCounters.writes), formatCount(countBuff, tagCounters.bytesWritten));
+		printf("  latency: %s ms total, %lu ms max\r\n", formatCount(countBuff, tagCounters.totalLatencyMs), static_cast<unsigned long>(tagCounters.maxLatencyMs));
+
+		if (0 != writeChunkSizes[index])
+		{
+			printf("  write chunk: %u bytes\r\n", static_cast<unsigned>(writeChunkSizes[index]));
+		}
+
+		if (0 != tagCounters.pagePrograms || 0 != tagCounters.blockErases)
+		{
+			printf("  page programs: %lu (%s bytes) | block erases: %lu\r\n", static_cast<unsigned long>(tagCounters.pagePrograms), formatCount(countBuff, tagCounters.programmedBytes), static_cast<unsigned long>(tagCounters.blockErases));
+		}
+
+		if (0 != tagCounters.bytesWritten && 0 != tagCounters.programmedBytes)
+		{
+			// Two decimals using integer math
+			uint64_t amplification = (tagCounters.programmedBytes * 100) / tagCounters.bytesWritten;
+
+			recordWriter(countBuff).appendUnsigned64(amplification / 100).appendChar('.').appendUnsigned(static_cast<uint32_t>(amplification % 100), 2).finish();
+			printf("  write amplification: %s\r\n", countBuff.data());
+		}
+	}
+
+	printf("#############################\r\n");
+}
+
+} // namespace ioAccounting
@@ -8,6 +8,7 @@
  */
 
 #include "W25Qx_module.h"
+#include "ioAccounting.hpp"
 #include <cstdint>
 #include <littleFSInterface.h>
 
@@ -64,6 +65,8 @@ int w25q64_prog(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, co
 
 	myFlash.page_program(addr, const_cast<uint8_t*>(static_cast<const uint8_t*>(buffer)), size);
 
+	ioAccounting::countPageProgram((size + W25Q64_PROG_SIZE - 1) / W25Q64_PROG_SIZE, size);
+
 	return 0;
 }
 
@@ -80,6 +83,8 @@ int w25q64_erase(const struct lfs_config* c, lfs_block_t block)
 
 	myFlash.block_erase(addr);
 
+	ioAccounting::countBlockErase();
+
 	return 0;
 }
 
@@ -44,6 +44,8 @@ static terminalKeyMap keyMap[] =
 	{terminalSignal::pressedKey_S, 'S'},
 	{terminalSignal::pressedKey_F, 'F'},
 	{terminalSignal::pressedKey_M, 'M'},
+	{terminalSignal::pressedKey_D, 'D'},
+	{terminalSignal::pressedKey_R, 'R'},
 	{terminalSignal::pressedKey_Enter, '\r'},
 };
 // clang-format on
@@ -0,0 +1,215 @@
+/**
+ * @file rtcCalendar.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Calendar arithmetic on broken down RTC time
+
+	Used by the virtual RTC to advance its cached clock without reading the hardware, and
+	to convert between broken down time and epoch milliseconds.
+
+	Epoch values count from 01/01/1970 00:00:00 of the RTC time, the RTC keeps no time zone
+	so neither do the epochs. Conversions use the days from civil algorithm, a handful of
+	32 bit multiplications and divisions with no tables and no loops.
+
+ * @version 0.1
+ * @date 2025-04-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include "rtcInterface.hpp"
+#include <cstdint>
+
+namespace rtcCalendar
+{
+
+////////////////////////////////////////////////////////////////////////
+//							     Types
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Fields modified by advanceSeconds(), a field changes only if all smaller fields carried
+ */
+enum changedField : uint8_t
+{
+	CHANGED_SECONDS = 1 << 0,
+	CHANGED_MINUTES = 1 << 1,
+	CHANGED_HOURS	= 1 << 2,
+	CHANGED_DAY		= 1 << 3,
+	CHANGED_MONTH	= 1 << 4,
+	CHANGED_YEAR	= 1 << 5,
+};
+
+////////////////////////////////////////////////////////////////////////
+//						  Function definitions
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t SECONDS_IN_ONE_DAY = 86400;
+
+constexpr bool isLeapYear(uint16_t year)
+{
+	return (0 == year % 4 && 0 != year % 100) || (0 == year % 400);
+}
+
+constexpr uint8_t daysInMonth(uint8_t month, uint16_t year)
+{
+	constexpr uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+	if (2 == month && true == isLeapYear(year))
+	{
+		return 29;
+	}
+
+	return days[(month - 1) % 12];
+}
+
+/**
+ * @brief Moves a date and time forward
+ *
+ * @param dateTime date and time to advance
+ * @param seconds seconds to add
+ * @return uint8_t mask of @ref changedField, 0 if seconds is 0
+ */
+constexpr uint8_t advanceSeconds(rtcDateTime& dateTime, uint32_t seconds)
+{
+	if (0 == seconds)
+	{
+		return 0;
+	}
+
+	uint8_t	 changed = CHANGED_SECONDS;
+	uint32_t total	 = dateTime.seconds + seconds;
+
+	dateTime.seconds = static_cast<uint8_t>(total % 60);
+	uint32_t carry	 = total / 60;
+
+	if (0 == carry)
+	{
+		return changed;
+	}
+
+	changed |= CHANGED_MINUTES;
+	total			= dateTime.minute + carry;
+	dateTime.minute = static_cast<uint8_t>(total % 60);
+	carry			= total / 60;
+
+	if (0 == carry)
+	{
+		return changed;
+	}
+
+	changed |= CHANGED_HOURS;
+	total		  = dateTime.hour + carry;
+	dateTime.hour = static_cast<uint8_t>(total % 24);
+	carry		  = total / 24;
+
+	// Whole days are walked one month at a time
+	while (carry > 0)
+	{
+		changed |= CHANGED_DAY;
+
+		uint8_t monthDays = daysInMonth(dateTime.month, dateTime.year);
+
+		if (dateTime.day + carry <= monthDays)
+		{
+			dateTime.day = static_cast<uint8_t>(dateTime.day + carry);
+			break;
+		}
+
+		carry -= static_cast<uint32_t>(monthDays - dateTime.day + 1);
+		dateTime.day = 1;
+		changed |= CHANGED_MONTH;
+
+		if (12 == dateTime.month)
+		{
+			dateTime.month = 1;
+			dateTime.year++;
+			changed |= CHANGED_YEAR;
+		}
+		else
+		{
+			dateTime.month++;
+		}
+	}
+
+	return changed;
+}
+
+/**
+ * @brief Days since 01/01/1970 of a civil date, valid from year 1970
+ */
+constexpr uint32_t daysFromCivil(uint16_t year, uint8_t month, uint8_t day)
+{
+	// Years start in March so the leap day is the last day of the year
+	uint32_t y	 = (month <= 2) ? year - 1u : year;
+	uint32_t era = y / 400;
+	uint32_t yoe = y - era * 400;
+	uint32_t mp	 = (month > 2) ? month - 3u : month + 9u;
+	uint32_t doy = (153 * mp + 2) / 5 + day - 1;
+	uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+	return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Civil date of a number of days since 01/01/1970
+ */
+constexpr void civilFromDays(uint32_t days, uint16_t& year, uint8_t& month, uint8_t& day)
+{
+	uint32_t z	 = days + 719468;
+	uint32_t era = z / 146097;
+	uint32_t doe = z - era * 146097;
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint32_t mp	 = (5 * doy + 2) / 153;
+
+	day	  = static_cast<uint8_t>(doy - (153 * mp + 2) / 5 + 1);
+	month = static_cast<uint8_t>((mp < 10) ? mp + 3 : mp - 9);
+	year  = static_cast<uint16_t>(yoe + era * 400 + ((month <= 2) ? 1 : 0));
+}
+
+/**
+ * @brief Seconds since 01/01/1970 of a date and time
+ */
+constexpr uint32_t toEpochSeconds(const rtcDateTime& dateTime)
+{
+	return daysFromCivil(dateTime.year, dateTime.month, dateTime.day) * SECONDS_IN_ONE_DAY + dateTime.hour * 3600u + dateTime.minute * 60u + dateTime.seconds;
+}
+
+/**
+ * @brief Date and time of a number of seconds since 01/01/1970
+ */
+constexpr rtcDateTime fromEpochSeconds(uint32_t epochSeconds)
+{
+	rtcDateTime dateTime{};
+	uint32_t	secondsOfDay = epochSeconds % SECONDS_IN_ONE_DAY;
+
+	civilFromDays(epochSeconds / SECONDS_IN_ONE_DAY, dateTime.year, dateTime.month, dateTime.day);
+
+	dateTime.hour	 = static_cast<uint8_t>(secondsOfDay / 3600);
+	dateTime.minute	 = static_cast<uint8_t>((secondsOfDay / 60) % 60);
+	dateTime.seconds = static_cast<uint8_t>(secondsOfDay % 60);
+
+	return dateTime;
+}
+
+constexpr uint64_t toEpochMs(const rtcDateTime& dateTime)
+{
+	return static_cast<uint64_t>(toEpochSeconds(dateTime)) * 1000;
+}
+
+/**
+ * @brief Date and time of a number of milliseconds since 01/01/1970, the milliseconds are dropped
+ */
+constexpr rtcDateTime fromEpochMs(uint64_t epochMs)
+{
+	return fromEpochSeconds(static_cast<uint32_t>(epochMs / 1000));
+}
+
+} // namespace rtcCalendar
@@ -0,0 +1,142 @@
+/**
+ * @file rtcDiscipline.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief Millisecond clock built from the RTC and the systick counter
+
+	The RTC is the time reference, it keeps the date across resets, but reading it is slow
+	and the STM32 sub second counter only has a 4 ms step. Between RTC reads the time is
+	interpolated with the 1 ms systick counter.
+
+	The two oscillators do not run at the same rate (the RTC runs from the LSI, systick
+	from the main clock), so on every sync the RTC time elapsed since the previous sync is
+	compared with the systick time elapsed, and the difference in parts per million is
+	averaged into a drift estimate. Interpolation is scaled by that estimate, which keeps
+	the correction applied at each sync small.
+
+	Timestamps never go backwards: if a sync finds the interpolated clock ahead of the RTC,
+	the clock holds its last value until the RTC catches up. reset() drops the monotonic
+	floor, used when the RTC is set to a new time.
+
+ * @version 0.1
+ * @date 2025-04-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//							    Includes
+////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+//							    Constants
+////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t RTC_DRIFT_MIN_WINDOW_MS = 10000; // Syncs closer than this are too short to measure drift
+constexpr int32_t  RTC_MAX_DRIFT_PPM	   = 50000; // LSI tolerance, larger differences mean the RTC was stepped
+constexpr int32_t  RTC_DRIFT_SMOOTHING	   = 8;		// Weight of the previous estimate in the drift average
+constexpr int64_t  PPM					   = 1000000;
+
+////////////////////////////////////////////////////////////////////////
+//							Class definition
+////////////////////////////////////////////////////////////////////////
+
+class rtcDiscipline
+{
+  public:
+	/**
+	 * @brief Forgets the RTC reference and the monotonic floor, the drift estimate is kept
+	 */
+	void reset()
+	{
+		this->_synced	   = false;
+		this->_lastEpochMs = 0;
+	}
+
+	/**
+	 * @brief Anchors the clock to an RTC reading and updates the drift estimate
+	 *
+	 * @param ticks systick counter when the RTC was read
+	 * @param rtcEpochMs RTC time in milliseconds since 01/01/1970
+	 */
+	void sync(uint64_t ticks, uint64_t rtcEpochMs)
+	{
+		if (true == this->_synced)
+		{
+			int64_t elapsedTicks = static_cast<int64_t>(ticks - this->_anchorTicks);
+			int64_t elapsedRtc	 = static_cast<int64_t>(rtcEpochMs - this->_anchorEpochMs);
+			int64_t difference	 = elapsedRtc - elapsedTicks;
+
+			if (elapsedTicks >= RTC_DRIFT_MIN_WINDOW_MS && (difference < 0 ? -difference : difference) * PPM <= elapsedTicks * RTC_MAX_DRIFT_PPM)
+			{
+				int32_t measuredPpm = static_cast<int32_t>(difference * PPM / elapsedTicks);
+
+				// The first measurement is taken as is, later ones are averaged in
+				if (false == this->_driftValid)
+				{
+					this->_driftPpm	  = measuredPpm;
+					this->_driftValid = true;
+				}
+				else
+				{
+					this->_driftPpm += (measuredPpm - this->_driftPpm) / RTC_DRIFT_SMOOTHING;
+				}
+			}
+		}
+
+		this->_anchorTicks	 = ticks;
+		this->_anchorEpochMs = rtcEpochMs;
+		this->_synced		 = true;
+	}
+
+	/**
+	 * @brief Milliseconds since 01/01/1970 at a systick count, never less than a previous result
+	 *
+	 * @param ticks systick counter, not before the last sync
+	 * @return uint64_t epoch in milliseconds, 0 if the clock was never synced
+	 */
+	uint64_t getEpochMs(uint64_t ticks)
+	{
+		if (false == this->_synced)
+		{
+			return 0;
+		}
+
+		int64_t	 elapsed = static_cast<int64_t>(ticks - this->_anchorTicks);
+		uint64_t epochMs = this->_anchorEpochMs + static_cast<uint64_t>(elapsed + elapsed * this->_driftPpm / PPM);
+
+		if (epochMs < this->_lastEpochMs)
+		{
+			epochMs = this->_lastEpochMs;
+		}
+
+		this->_lastEpochMs = epochMs;
+
+		return epochMs;
+	}
+
+	/**
+	 * @brief Rate of the RTC relative to systick, positive if the RTC runs faster
+	 */
+	int32_t getDriftPpm() const
+	{
+		return this->_driftPpm;
+	}
+
+	bool isSynced() const
+	{
+		return this->_synced;
+	}
+
+  private:
+	uint64_t _anchorTicks	= 0; /// Systick counter at the last sync
+	uint64_t _anchorEpochMs = 0; /// RTC time at the last sync
+	uint64_t _lastEpochMs	= 0; /// Last returned time, the monotonic floor
+	int32_t	 _driftPpm		= 0;
+	bool	 _driftValid	= false;
+	bool	 _synced		= false;
+};
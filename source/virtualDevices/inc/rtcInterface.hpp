@@ -3,6 +3,17 @@
 #include <cstddef>
 #include <cstdint>
 
+// Broken down date and time, as kept by the RTC peripheral
+struct rtcDateTime
+{
+	uint8_t	 hour;
+	uint8_t	 minute;
+	uint8_t	 seconds;
+	uint8_t	 day;
+	uint8_t	 month;
+	uint16_t year;
+};
+
 struct rtcInterface
 {
 	virtual bool init() = 0;
@@ -16,5 +27,11 @@ struct rtcInterface
 	// Write formatted date ("DD/MM/YYYY") into buffer (which must be at least 11 bytes).
 	virtual void getDate(char* buffer, size_t bufferSize) const = 0;
 
+	// Read time and date in one access, so both belong to the same instant.
+	virtual void getDateTime(rtcDateTime& dateTime) const = 0;
+
+	// Milliseconds since 01/01/1970 of the RTC time, the RTC keeps no time zone.
+	virtual uint64_t getEpochMs() const = 0;
+
 	virtual ~rtcInterface() = default;
 };
@@ -0,0 +1,186 @@
+/**
+ * This class abstracts a frequency input,
+ *
+ * Pulse edges are timestamped by a timer input capture and
+ * copied by DMA to a circular buffer (target build), or
+ * injected by the host simulation (host build)
+ *
+ * update() consumes the captures written since the previous call, so
+ * the CPU handles pulses in batches instead of one interrupt each. It
+ * must be called before the buffer wraps, at least every
+ * CAPTURE_BUFFER_SIZE pulses.
+ *
+ * From the captures it derives the instantaneous frequency (last period),
+ * the average frequency since closeWindow(), and the gust, the highest
+ * 3 second running mean in the window. Following the WMO practice the
+ * running mean is taken over CAPTURE_GUST_BINS bins of CAPTURE_GUST_BIN_MS.
+ *
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint32_t CAPTURE_TIMER_HZ		   = 1000000; // Capture counter frequency, 1 us resolution
+constexpr size_t   CAPTURE_BUFFER_SIZE	   = 128;	  // Captures kept by the DMA ring
+constexpr uint32_t CAPTURE_GUST_BIN_MS	   = 250;	  // Resolution of the gust running mean
+constexpr size_t   CAPTURE_GUST_BINS	   = 12;	  // Bins in the running mean, 3 s
+constexpr uint32_t CAPTURE_STOP_TIMEOUT_MS = 5000;	  // Without pulses for this long the frequency is 0
+
+namespace virtualDevice
+{
+class virtualCapture
+{
+  public:
+	/**
+     * @brief Starts capturing, the averaging window starts now
+     */
+	bool init();
+
+	/**
+     * @brief Consumes the new captures, meant to be called from the superloop
+     */
+	void update()
+	{
+		const volatile uint32_t* buffer = _captureBuffer();
+		size_t					 head	= _captureWriteIndex();
+
+		while (_tail != head)
+		{
+			uint32_t capture = buffer[_tail];
+			_tail			 = (_tail + 1) % CAPTURE_BUFFER_SIZE;
+
+			if (true == _hasCapture)
+			{
+				_periodTicks = capture - _lastCapture;
+			}
+
+			_advanceBins(capture);
+			_currentBin++;
+			_windowPulses++;
+			_lastCapture = capture;
+			_hasCapture	 = true;
+		}
+
+		_now = _captureNow();
+		_advanceBins(_now);
+	}
+
+	/**
+     * @brief Frequency of the last period in Hz, 0 once the pulses stop
+     */
+	float getFrequency() const
+	{
+		if (0 == _periodTicks || _now - _lastCapture >= CAPTURE_STOP_TIMEOUT_MS * _ticksPerMs)
+		{
+			return 0.0f;
+		}
+
+		return static_cast<float>(CAPTURE_TIMER_HZ) / static_cast<float>(_periodTicks);
+	}
+
+	/**
+     * @brief Pulses per second since the window started
+     */
+	float getAverageFrequency() const
+	{
+		uint32_t elapsed = _now - _windowStart;
+
+		if (0 == elapsed)
+		{
+			return 0.0f;
+		}
+
+		return static_cast<float>(_windowPulses) * static_cast<float>(CAPTURE_TIMER_HZ) / static_cast<float>(elapsed);
+	}
+
+	/**
+     * @brief Highest 3 second mean frequency in the window, in Hz
+     */
+	float getGustFrequency() const
+	{
+		return static_cast<float>(_gustPulses) / _gustSeconds;
+	}
+
+	/**
+     * @brief Starts a new averaging window
+     */
+	void closeWindow()
+	{
+		_windowStart  = _now;
+		_windowPulses = 0;
+		_gustPulses	  = 0;
+	}
+
+  private:
+	static constexpr uint32_t _ticksPerMs  = CAPTURE_TIMER_HZ / 1000;
+	static constexpr uint32_t _binTicks	   = CAPTURE_GUST_BIN_MS * _ticksPerMs;
+	static constexpr float	  _gustSeconds = static_cast<float>(CAPTURE_GUST_BINS * CAPTURE_GUST_BIN_MS) / 1000.0f;
+
+	size_t	 _tail		  = 0; /// Next capture to consume
+	bool	 _hasCapture  = false;
+	uint32_t _lastCapture = 0;
+	uint32_t _periodTicks = 0; /// Interval between the last two captures
+	uint32_t _now		  = 0; /// Counter value at the last update()
+
+	// Averaging window
+	uint32_t _windowStart  = 0;
+	uint32_t _windowPulses = 0;
+
+	// Gust running mean over the last completed bins
+	std::array<uint32_t, CAPTURE_GUST_BINS> _bins{};
+	size_t									_binIndex	= 0; /// Oldest completed bin, replaced by the next one
+	uint32_t								_binStart	= 0; /// Counter value when the bin in progress started
+	uint32_t								_currentBin = 0; /// Pulses in the bin in progress
+	uint32_t								_binPulses	= 0; /// Pulses in the completed bins
+	uint32_t								_gustPulses = 0; /// Highest _binPulses in the window
+
+	/**
+     * @brief Completes the bins ending before a time and updates the gust
+     */
+	void _advanceBins(uint32_t ticks)
+	{
+		while (ticks - _binStart >= _binTicks)
+		{
+			_binPulses		 += _currentBin;
+			_binPulses		 -= _bins[_binIndex]; // Oldest bin leaves the running mean
+			_bins[_binIndex]  = _currentBin;
+			_gustPulses		  = (_binPulses > _gustPulses) ? _binPulses : _gustPulses;
+			_binIndex		  = (_binIndex + 1) % CAPTURE_GUST_BINS;
+			_currentBin		  = 0;
+			_binStart		 += _binTicks;
+
+			// After a long calm every bin is empty, the remaining ones are skipped
+			if (0 == _binPulses)
+			{
+				_binStart = ticks - (ticks - _binStart) % _binTicks;
+			}
+		}
+	}
+
+	// Platform part, see virtualCapture.cpp
+	static const volatile uint32_t* _captureBuffer();
+	static size_t					_captureWriteIndex();
+	static uint32_t					_captureNow();
+};
+} // namespace virtualDevice
+
+#ifndef TARGET_MICRO
+namespace captureMock
+{
+/**
+ * @brief Writes a pulse train to the capture buffer as the timer and DMA would
+ *
+ * @param startTicks counter value of the first pulse
+ * @param pulses number of pulses
+ * @param periodTicks counter ticks between pulses
+ */
+void injectPulseTrain(uint32_t startTicks, uint32_t pulses, uint32_t periodTicks);
+
+/**
+ * @brief Sets the counter value read by update()
+ */
+void setCounter(uint32_t ticks);
+} // namespace captureMock
+#endif
@@ -1,31 +1,132 @@
 /**
- * This class abstracts a counter, 
- * 
+ * This class abstracts a counter,
+ *
  * Counter is increased from a ISR (target build)
  * or Shared memory (host build)
- * 
+ *
  * This class then offers an interface to read this resource
  * without worring about the type of build and also having a
  * barrier with the hardware in case of a change in the type
  * of the microcontroller
- * 
+ *
+ * Each pulse is timestamped in the interrupt. Edges closer than COUNTER_DEBOUNCE_MS to
+ * the last accepted pulse are contact bounce and are dropped, so no external filter or
+ * polling is needed. Pulses are counted in an atomic, reading and resetting it is a
+ * single exchange and no pulse arriving during the read is lost. The interval between
+ * the last two pulses gives the pulse rate.
+ *
+ * On the host, pulses are injected with counterMock::injectPulseTrain(), and the
+ * counts of the shared memory simulator are added when it is running.
+ *
  */
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
+constexpr uint32_t COUNTER_DEBOUNCE_MS	   = 10;			 // Reed switch bounce, shorter than any real pulse interval
+constexpr uint32_t COUNTER_RATE_TIMEOUT_MS = 15 * 60 * 1000; // Without pulses for this long the rate is 0
+constexpr uint32_t COUNTER_MS_IN_ONE_HOUR  = 60 * 60 * 1000;
+
 namespace virtualDevice
 {
 class virtualCounter
 {
   public:
+	/**
+     * @brief Attaches the counter to its interrupt, pulses are counted from then on
+     */
+	bool init();
+
 	/**
      * @brief This function reads the counter object and then
-     * resets it to 0. 
+     * resets it to 0.
+     */
+	uint32_t readandResetCounter();
+
+	/**
+     * @brief Pulses accepted since init, never reset
      */
-	uint16_t readandResetCounter();
+	uint32_t getTotalPulses() const
+	{
+		return _total.load(std::memory_order_relaxed);
+	}
+
+	/**
+     * @brief Pulse edge, called from the interrupt
+     *
+     * @param nowMs time of the edge in milliseconds
+     */
+	void onPulse(uint32_t nowMs)
+	{
+		uint32_t last = _lastPulseMs.load(std::memory_order_relaxed);
+
+		if (_total.load(std::memory_order_relaxed) > 0)
+		{
+			uint32_t interval = nowMs - last;
+
+			if (interval < COUNTER_DEBOUNCE_MS)
+			{
+				return;
+			}
+
+			_intervalMs.store(interval, std::memory_order_relaxed);
+		}
+
+		_lastPulseMs.store(nowMs, std::memory_order_relaxed);
+		_total.fetch_add(1, std::memory_order_relaxed);
+		_count.fetch_add(1, std::memory_order_release);
+	}
+
+	/**
+     * @brief Pulses per hour estimated from the interval between the last two pulses
+     *
+     * While the current interval is longer than the last one, the rate is estimated from
+     * the current interval so it decays when the pulses stop, and it is 0 after
+     * COUNTER_RATE_TIMEOUT_MS without pulses.
+     *
+     * @param nowMs current time in milliseconds, same clock as onPulse()
+     */
+	float getPulseRate(uint32_t nowMs) const
+	{
+		uint32_t interval = _intervalMs.load(std::memory_order_relaxed);
+		uint32_t elapsed  = nowMs - _lastPulseMs.load(std::memory_order_relaxed);
+
+		if (0 == interval || elapsed >= COUNTER_RATE_TIMEOUT_MS)
+		{
+			return 0.0f;
+		}
+
+		if (elapsed > interval)
+		{
+			interval = elapsed;
+		}
+
+		return static_cast<float>(COUNTER_MS_IN_ONE_HOUR) / static_cast<float>(interval);
+	}
 
   private:
+	std::atomic<uint32_t> _count{0};	   /// Pulses since the last read
+	std::atomic<uint32_t> _total{0};	   /// Pulses since init
+	std::atomic<uint32_t> _lastPulseMs{0}; /// Time of the last accepted pulse
+	std::atomic<uint32_t> _intervalMs{0};  /// Interval between the last two pulses, 0 until there are two
+
 	void resetCounter();
 };
-} // namespace virtualDevice
\ No newline at end of file
+} // namespace virtualDevice
+
+#ifndef TARGET_MICRO
+namespace counterMock
+{
+/**
+ * @brief Feeds a pulse train to a counter as its interrupt would
+ *
+ * @param counter counter receiving the pulses
+ * @param startMs time of the first pulse
+ * @param pulses number of pulses
+ * @param intervalMs time between pulses
+ * @param bounces bounce edges following each pulse, 1 ms apart
+ */
+void injectPulseTrain(virtualDevice::virtualCounter& counter, uint32_t startMs, uint32_t pulses, uint32_t intervalMs, uint8_t bounces);
+} // namespace counterMock
+#endif
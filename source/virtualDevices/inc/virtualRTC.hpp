@@ -1,3 +1,26 @@
+/**
+ * @file virtualRTC.hpp
+ * @author Renato Barresi (renatobarresi@gmail.com)
+ * @brief RTC virtual device
+
+	Wraps the target RTC peripheral or the host system clock behind the same interface.
+
+	Timestamps are served from a cached clock: the hardware is read in milliseconds, then
+	time is interpolated from the systick counter and the hardware is read again every
+	RTC_RESYNC_PERIOD_MS, see @ref rtcDiscipline for the drift correction. getEpochMs()
+	gives millisecond, monotonic timestamps.
+
+	The cached date and time follow the same clock. The cached timestamp text is kept
+	formatted and only the fields that changed are rewritten, so a timestamp costs a tick
+	read and a copy, and time and date always belong to the same instant.
+
+ * @version 0.1
+ * @date 2025-04-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
 #pragma once
 
 #ifdef TARGET_MICRO
@@ -5,13 +28,18 @@
 #else
 #include "host_rtc.hpp"
 #endif
+#include "rtcCalendar.hpp"
+#include "rtcDiscipline.hpp"
 #include "rtcInterface.hpp"
+#include "virtualTimer.hpp"
 #include <cstring>
 
 constexpr uint8_t TIME_BUFF_SIZE	  = 9;
 constexpr uint8_t DATE_BUFF_SIZE	  = 11;
 constexpr uint8_t TIMESTAMP_BUFF_SIZE = TIME_BUFF_SIZE + DATE_BUFF_SIZE;
 
+constexpr uint32_t RTC_RESYNC_PERIOD_MS = 60000; // The cached clock is corrected with the hardware RTC this often
+
 class virtualRTC
 {
   private:
@@ -23,6 +51,97 @@ class virtualRTC
 
 	rtcInterface* interface;
 
+	rtcDiscipline _clock;
+	rtcDateTime	  _cachedDateTime{};
+	char		  _cachedTimestamp[TIMESTAMP_BUFF_SIZE] = {'\0'}; /// "HH:MM:SS-DD/MM/YYYY"
+	uint64_t	  _syncTicks							= 0;	 /// Ticks of the last hardware read
+	uint32_t	  _cachedEpochSeconds					= 0;	 /// Seconds since 01/01/1970 of the cached second
+	bool		  _cacheValid							= false;
+
+	/**
+	 * @brief Writes a zero padded number in the cached timestamp
+	 */
+	void _putDigits(uint8_t pos, uint16_t value, uint8_t numDigits)
+	{
+		for (uint8_t digit = numDigits; digit > 0; digit--)
+		{
+			this->_cachedTimestamp[pos + digit - 1] = static_cast<char>('0' + (value % 10));
+			value /= 10;
+		}
+	}
+
+	/**
+	 * @brief Rewrites the cached timestamp fields selected by a mask of @ref rtcCalendar::changedField
+	 */
+	void _formatFields(uint8_t changed)
+	{
+		if (0 != (changed & rtcCalendar::CHANGED_SECONDS))
+		{
+			_putDigits(6, this->_cachedDateTime.seconds, 2);
+		}
+		if (0 != (changed & rtcCalendar::CHANGED_MINUTES))
+		{
+			_putDigits(3, this->_cachedDateTime.minute, 2);
+		}
+		if (0 != (changed & rtcCalendar::CHANGED_HOURS))
+		{
+			_putDigits(0, this->_cachedDateTime.hour, 2);
+		}
+		if (0 != (changed & rtcCalendar::CHANGED_DAY))
+		{
+			_putDigits(9, this->_cachedDateTime.day, 2);
+		}
+		if (0 != (changed & rtcCalendar::CHANGED_MONTH))
+		{
+			_putDigits(12, this->_cachedDateTime.month, 2);
+		}
+		if (0 != (changed & rtcCalendar::CHANGED_YEAR))
+		{
+			_putDigits(15, this->_cachedDateTime.year, 4);
+		}
+	}
+
+	/**
+	 * @brief Brings the cached clock up to date, from the hardware when a resync is due
+	 *
+	 * @return uint64_t time in milliseconds since 01/01/1970
+	 */
+	uint64_t _refreshCache(uint64_t now)
+	{
+		if (false == this->_cacheValid || (now - this->_syncTicks) >= RTC_RESYNC_PERIOD_MS)
+		{
+			if (false == this->_cacheValid)
+			{
+				// The RTC may have been set backwards
+				this->_clock.reset();
+			}
+
+			this->_clock.sync(now, this->interface->getEpochMs());
+			this->_syncTicks = now;
+		}
+
+		uint64_t epochMs	  = this->_clock.getEpochMs(now);
+		uint32_t epochSeconds = static_cast<uint32_t>(epochMs / 1000);
+
+		if (false == this->_cacheValid)
+		{
+			this->_cachedDateTime	  = rtcCalendar::fromEpochSeconds(epochSeconds);
+			this->_cachedEpochSeconds = epochSeconds;
+			this->_cacheValid		  = true;
+
+			std::memcpy(this->_cachedTimestamp, "00:00:00-00/00/0000", TIMESTAMP_BUFF_SIZE);
+			_formatFields(0xFF);
+		}
+		else if (epochSeconds > this->_cachedEpochSeconds)
+		{
+			// The clock is monotonic, the cached second only moves forward
+			_formatFields(rtcCalendar::advanceSeconds(this->_cachedDateTime, epochSeconds - this->_cachedEpochSeconds));
+			this->_cachedEpochSeconds = epochSeconds;
+		}
+
+		return epochMs;
+	}
+
   public:
 	uint8_t timeBuffSize	  = TIME_BUFF_SIZE;
 	uint8_t dateBuffSize	  = DATE_BUFF_SIZE;
@@ -41,6 +160,8 @@ class virtualRTC
      */
 	bool setTime(uint8_t hour, uint8_t minute, uint8_t seconds)
 	{
+		this->_cacheValid = false;
+
 		return this->interface->setTime(hour, minute, seconds);
 	}
 
@@ -53,9 +174,17 @@ class virtualRTC
      * @param buffer Pointer to the character array to store the formatted time.
      * @param bufferSize Size of the provided buffer.
      */
-	void getTime(char* buffer, size_t bufferSize) const
+	void getTime(char* buffer, size_t bufferSize)
 	{
-		this->interface->getTime(buffer, bufferSize);
+		if (bufferSize < TIME_BUFF_SIZE)
+		{
+			return;
+		}
+
+		_refreshCache(systick::getTicks());
+
+		std::memcpy(buffer, this->_cachedTimestamp, TIME_BUFF_SIZE - 1);
+		buffer[TIME_BUFF_SIZE - 1] = '\0';
 	}
 
 	/**
@@ -69,6 +198,8 @@ class virtualRTC
      */
 	bool setDate(uint8_t day, uint8_t month, uint16_t year)
 	{
+		this->_cacheValid = false;
+
 		return this->interface->setDate(day, month, year);
 	}
 
@@ -81,21 +212,63 @@ class virtualRTC
      * @param buffer Pointer to the character array to store the formatted date.
      * @param bufferSize Size of the provided buffer.
      */
-	void getDate(char* buffer, size_t bufferSize) const
+	void getDate(char* buffer, size_t bufferSize)
 	{
-		this->interface->getDate(buffer, bufferSize);
+		if (bufferSize < DATE_BUFF_SIZE)
+		{
+			return;
+		}
+
+		_refreshCache(systick::getTicks());
+
+		std::memcpy(buffer, this->_cachedTimestamp + TIME_BUFF_SIZE, DATE_BUFF_SIZE);
 	}
 
+	/**
+     * @brief Retrieves the formatted time and date of the same instant.
+     * 
+     * Writes "HH:MM:SS-DD/MM/YYYY" into the provided buffer, which must be at
+     * least TIMESTAMP_BUFF_SIZE bytes long (including the null terminator).
+     * 
+     * @param buff Pointer to the character array to store the timestamp.
+     */
 	void getTimestamp(char* buff)
 	{
-		char timeBuff[TIME_BUFF_SIZE];
-		char dateBuff[DATE_BUFF_SIZE];
+		_refreshCache(systick::getTicks());
+
+		std::memcpy(buff, this->_cachedTimestamp, TIMESTAMP_BUFF_SIZE);
+	}
+
+	/**
+     * @brief Retrieves the cached time and date as numbers.
+     * 
+     * @param dateTime Structure receiving the time and date.
+     */
+	void getDateTime(rtcDateTime& dateTime)
+	{
+		_refreshCache(systick::getTicks());
 
-		getTime(timeBuff, timeBuffSize);
-		getDate(dateBuff, dateBuffSize);
+		dateTime = this->_cachedDateTime;
+	}
 
-		memcpy(buff, timeBuff, TIME_BUFF_SIZE);
-		buff[timeBuffSize] = '-';
-		memcpy(buff + TIME_BUFF_SIZE + 1, dateBuff, DATE_BUFF_SIZE);
+	/**
+     * @brief Retrieves the time as milliseconds since 01/01/1970.
+     * 
+     * Interpolated from the systick counter between hardware reads, never
+     * less than a previous result unless the time or date were set.
+     * 
+     * @return uint64_t epoch in milliseconds.
+     */
+	uint64_t getEpochMs()
+	{
+		return _refreshCache(systick::getTicks());
+	}
+
+	/**
+     * @brief Estimated rate difference between the RTC and systick, in parts per million.
+     */
+	int32_t getDriftPpm() const
+	{
+		return this->_clock.getDriftPpm();
 	}
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "virtualCapture.hpp"
+
+#ifdef TARGET_MICRO
+#include "capture_module.h"
+#endif
+
+namespace virtualDevice
+{
+
+// One entry per captured edge, written by DMA on the target and by captureMock on the host
+static volatile uint32_t captureBuffer[CAPTURE_BUFFER_SIZE];
+
+#ifndef TARGET_MICRO
+static size_t	captureHead	   = 0;
+static uint32_t captureCounter = 0;
+#endif
+
+bool virtualCapture::init()
+{
+#ifdef TARGET_MICRO
+	initInputCapture(captureBuffer, CAPTURE_BUFFER_SIZE, CAPTURE_TIMER_HZ);
+#endif
+	_tail		 = _captureWriteIndex();
+	_now		 = _captureNow();
+	_windowStart = _now;
+	_binStart	 = _now;
+
+	return true;
+}
+
+const volatile uint32_t* virtualCapture::_captureBuffer()
+{
+	return captureBuffer;
+}
+
+size_t virtualCapture::_captureWriteIndex()
+{
+#ifdef TARGET_MICRO
+	return inputCaptureWriteIndex();
+#else
+	return captureHead;
+#endif
+}
+
+uint32_t virtualCapture::_captureNow()
+{
+#ifdef TARGET_MICRO
+	return inputCaptureCounter();
+#else
+	return captureCounter;
+#endif
+}
+} // namespace virtualDevice
+
+#ifndef TARGET_MICRO
+namespace captureMock
+{
+void injectPulseTrain(uint32_t startTicks, uint32_t pulses, uint32_t periodTicks)
+{
+	for (uint32_t pulse = 0; pulse < pulses; pulse++)
+	{
+		virtualDevice::captureBuffer[virtualDevice::captureHead] = startTicks + pulse * periodTicks;
+		virtualDevice::captureHead								 = (virtualDevice::captureHead + 1) % CAPTURE_BUFFER_SIZE;
+	}
+
+	if (pulses > 0)
+	{
+		virtualDevice::captureCounter = startTicks + (pulses - 1) * periodTicks;
+	}
+}
+
+void setCounter(uint32_t ticks)
+{
+	virtualDevice::captureCounter = ticks;
+}
+} // namespace captureMock
+#endif
@@ -1,26 +1,77 @@
 #include "virtualCounter.hpp"
+
+#ifdef TARGET_MICRO
+#include "gpio_module.h"
+#include "timer.h"
+
+// Rain gauge reed switch to ground, wired to PG2, the pin is pulled up
+#define COUNTER_PULSE_PIN  GPIO_PIN_2
+#define COUNTER_PULSE_PORT GPIOG
+#else
 #include "sensorSimulatorConsumer.hpp"
+#endif
 
 namespace virtualDevice
 {
-uint16_t virtualCounter::readandResetCounter()
+
+#ifdef TARGET_MICRO
+static virtualCounter* pulseOwner = nullptr; // Counter notified by the pulse interrupt
+
+static void counterPulseCallback()
+{
+	if (nullptr != pulseOwner)
+	{
+		pulseOwner->onPulse(static_cast<uint32_t>(timer_getTick()));
+	}
+}
+#endif
+
+bool virtualCounter::init()
+{
+#ifdef TARGET_MICRO
+	pulseOwner = this;
+	initGPIOInterrupt(COUNTER_PULSE_PIN, COUNTER_PULSE_PORT, GPIO_MODE_IT_FALLING, counterPulseCallback);
+#endif
+	return true;
+}
+
+uint32_t virtualCounter::readandResetCounter()
 {
+	uint32_t pulses = _count.exchange(0, std::memory_order_acquire);
+
 #ifndef TARGET_MICRO
-	if (false == sensorSimulator::getMemInitFlag())
+	if (true == sensorSimulator::getMemInitFlag())
 	{
-		return 0;
+		sensorSimulator::sensorOutput output = sensorSimulator::readSharedMemory();
+		pulses								+= output.rain;
 	}
-	sensorSimulator::sensorOutput output = sensorSimulator::readSharedMemory();
-	return output.rain;
 #endif
-	//	Target implementation
 
-	return 0;
+	return pulses;
 }
 
 void virtualCounter::resetCounter()
 {
+	_count.store(0, std::memory_order_relaxed);
+}
+} // namespace virtualDevice
+
 #ifndef TARGET_MICRO
-#endif
+namespace counterMock
+{
+void injectPulseTrain(virtualDevice::virtualCounter& counter, uint32_t startMs, uint32_t pulses, uint32_t intervalMs, uint8_t bounces)
+{
+	for (uint32_t pulse = 0; pulse < pulses; pulse++)
+	{
+		uint32_t edgeMs = startMs + pulse * intervalMs;
+
+		counter.onPulse(edgeMs);
+
+		for (uint8_t bounce = 1; bounce <= bounces; bounce++)
+		{
+			counter.onPulse(edgeMs + bounce);
+		}
+	}
 }
-} // namespace virtualDevice
\ No newline at end of file
+} // namespace counterMock
+#endif
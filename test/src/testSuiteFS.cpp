@@ -10,12 +10,19 @@
 #include "networkManager.hpp"
 #include "pluviometer.hpp"
 #include "processing_manager.hpp"
+#include "record_writer.hpp"
+#include "sampleRing.hpp"
 #include "sensorService.hpp"
+#include "signalSource.hpp"
+#include "storage_mirror.hpp"
 #include "terminal_component.hpp"
 #include "utilities.hpp"
 #include "virtualRTC.hpp"
 #include <ADS1115_wrapper.hpp>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
@@ -24,6 +31,7 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
 TEST(utilities, testTimeDateParsing)
 {
@@ -65,12 +73,262 @@ TEST(utilities, testTimeDateParsing)
 	EXPECT_FALSE(utilities::parseTimeAndDate("", &hour, &minute, &seconds, &day, &month, &year));
 }
 
+TEST(utilities, testRecordWriter)
+{
+	std::array<char, 64> buff;
+	std::array<char, 64> expected;
+
+	// Same output as snprintf for values a sensor produces
+	const float values[] = {0.0f, 23.5f, -0.25f, 1.999f, -40.0f, 85.12f, 0.004f, 123456.0f};
+
+	for (float value : values)
+	{
+		for (uint8_t decimals = 0; decimals <= 3; decimals++)
+		{
+			recordWriter writer(buff);
+			writer.appendFixed(value, decimals);
+			ASSERT_GT(writer.finish(), 0u);
+
+			snprintf(expected.data(), expected.size(), "%.*f", decimals, static_cast<double>(value));
+			EXPECT_STREQ(expected.data(), buff.data()) << "value " << value << " decimals " << static_cast<int>(decimals);
+		}
+	}
+
+	// Sweep over the thermometer range, ties and near ties included
+	for (int32_t step = -400000; step <= 850000; step += 7)
+	{
+		float value = static_cast<float>(step) * 0.0001f;
+
+		recordWriter writer(buff);
+		writer.appendFixed(value, 2);
+		writer.finish();
+
+		snprintf(expected.data(), expected.size(), "%.2f", static_cast<double>(value));
+		ASSERT_STREQ(expected.data(), buff.data());
+	}
+
+	// Full record with integer and timestamp emitters
+	recordWriter writer(buff);
+	writer.appendTime(9, 5, 0).appendChar('-').appendDate(1, 2, 2025).appendChar(';').appendInt(-12).appendChar(';').appendUnsigned(45).appendChar('\n');
+	EXPECT_EQ(writer.finish(), std::strlen("09:05:00-01/02/2025;-12;45\n"));
+	EXPECT_STREQ("09:05:00-01/02/2025;-12;45\n", buff.data());
+
+	// Non finite values
+	recordWriter nanWriter(buff);
+	nanWriter.appendFixed(std::nanf(""), 2).appendChar(';').appendFixed(-INFINITY, 2);
+	nanWriter.finish();
+	EXPECT_STREQ("nan;-inf", buff.data());
+
+	// A record that does not fit is dropped instead of truncated
+	std::array<char, 8> smallBuff;
+	recordWriter		smallWriter(smallBuff);
+	smallWriter.appendString("12:00:00").appendChar(';');
+	EXPECT_TRUE(smallWriter.overflowed());
+	EXPECT_EQ(smallWriter.finish(), 0u);
+	EXPECT_STREQ("", smallBuff.data());
+}
+
+TEST(virtualRTC, testCalendarAdvance)
+{
+	rtcDateTime dateTime{23, 59, 59, 31, 12, 2024};
+
+	// Only the seconds change
+	dateTime.seconds = 10;
+	EXPECT_EQ(rtcCalendar::advanceSeconds(dateTime, 5), rtcCalendar::CHANGED_SECONDS);
+	EXPECT_EQ(dateTime.seconds, 15);
+
+	// New year carries into every field
+	dateTime.seconds = 59;
+	EXPECT_EQ(rtcCalendar::advanceSeconds(dateTime, 1), 0x3F);
+	EXPECT_EQ(dateTime.hour, 0);
+	EXPECT_EQ(dateTime.minute, 0);
+	EXPECT_EQ(dateTime.seconds, 0);
+	EXPECT_EQ(dateTime.day, 1);
+	EXPECT_EQ(dateTime.month, 1);
+	EXPECT_EQ(dateTime.year, 2025);
+
+	// February of leap and common years
+	rtcDateTime leap{23, 59, 30, 28, 2, 2024};
+	rtcCalendar::advanceSeconds(leap, 45);
+	EXPECT_EQ(leap.day, 29);
+	EXPECT_EQ(leap.month, 2);
+
+	rtcDateTime common{23, 59, 30, 28, 2, 2023};
+	rtcCalendar::advanceSeconds(common, 45);
+	EXPECT_EQ(common.day, 1);
+	EXPECT_EQ(common.month, 3);
+
+	// Several days at once
+	rtcDateTime days{12, 0, 0, 30, 1, 2025};
+	rtcCalendar::advanceSeconds(days, 3 * 86400);
+	EXPECT_EQ(days.day, 2);
+	EXPECT_EQ(days.month, 2);
+	EXPECT_EQ(days.hour, 12);
+}
+
+TEST(virtualRTC, testCachedTimestamp)
+{
+	virtualRTC rtc;
+	char	   timestamp[TIMESTAMP_BUFF_SIZE];
+	char	   timeBuff[TIME_BUFF_SIZE];
+	char	   dateBuff[DATE_BUFF_SIZE];
+
+	rtc.getTimestamp(timestamp);
+	rtc.getTime(timeBuff, sizeof(timeBuff));
+	rtc.getDate(dateBuff, sizeof(dateBuff));
+
+	// Time and date of the same instant in one string
+	ASSERT_EQ(std::strlen(timestamp), TIMESTAMP_BUFF_SIZE - 1u);
+	EXPECT_EQ(timestamp[8], '-');
+	EXPECT_EQ(std::string(timestamp, 8), std::string(timeBuff));
+	EXPECT_EQ(std::string(timestamp + 9), std::string(dateBuff));
+
+	int hour, minute, seconds, day, month, year;
+	timestamp[8] = ' ';
+	EXPECT_TRUE(utilities::parseTimeAndDate(timestamp, &hour, &minute, &seconds, &day, &month, &year));
+
+	rtcDateTime dateTime;
+	rtc.getDateTime(dateTime);
+	EXPECT_EQ(dateTime.year, year);
+	EXPECT_EQ(dateTime.month, month);
+	EXPECT_EQ(dateTime.day, day);
+}
+
+TEST(virtualRTC, testEpochConversion)
+{
+	// Known epochs, including leap days and the end of a century
+	EXPECT_EQ(rtcCalendar::toEpochSeconds({0, 0, 0, 1, 1, 1970}), 0u);
+	EXPECT_EQ(rtcCalendar::toEpochSeconds({0, 0, 0, 29, 2, 2000}), 951782400u);
+	EXPECT_EQ(rtcCalendar::toEpochSeconds({23, 59, 59, 31, 12, 2099}), 4102444799u);
+	EXPECT_EQ(rtcCalendar::toEpochMs({12, 34, 56, 18, 4, 2025}), 1744979696000ull);
+
+	// Round trip one instant per day and hour up to 2100
+	for (uint32_t epochSeconds = 0; epochSeconds < 4102444800u; epochSeconds += 3599u * 24u + 1u)
+	{
+		rtcDateTime dateTime = rtcCalendar::fromEpochSeconds(epochSeconds);
+
+		ASSERT_EQ(rtcCalendar::toEpochSeconds(dateTime), epochSeconds);
+		ASSERT_GE(dateTime.day, 1);
+		ASSERT_LE(dateTime.day, rtcCalendar::daysInMonth(dateTime.month, dateTime.year));
+	}
+
+	rtcDateTime leapDay = rtcCalendar::fromEpochMs(1709208000123ull);
+	EXPECT_EQ(leapDay.day, 29);
+	EXPECT_EQ(leapDay.month, 2);
+	EXPECT_EQ(leapDay.year, 2024);
+	EXPECT_EQ(leapDay.hour, 12);
+
+	// Text only at the edges
+	std::array<char, 32> buff;
+	recordWriter(buff).appendTimestamp(1744979696789ull).finish();
+	EXPECT_STREQ(buff.data(), "12:34:56.789-18/04/2025");
+	recordWriter(buff).appendIsoTimestamp(1744979696789ull).finish();
+	EXPECT_STREQ(buff.data(), "2025-04-18T12:34:56.789");
+	recordWriter(buff).appendUnsigned64(1744979696789ull).finish();
+	EXPECT_STREQ(buff.data(), "1744979696789");
+
+	// The cached epoch agrees with the cached date and time
+	virtualRTC	rtc;
+	rtcDateTime dateTime;
+	uint64_t	epochMs = rtc.getEpochMs();
+	rtc.getDateTime(dateTime);
+	EXPECT_LE(rtcCalendar::toEpochMs(dateTime) - (epochMs - epochMs % 1000), 1000u);
+}
+
+TEST(virtualRTC, testClockDiscipline)
+{
+	rtcDiscipline clock;
+	uint64_t	  rtcEpochMs = 1744979696000ull;
+
+	EXPECT_EQ(clock.getEpochMs(0), 0u);
+
+	// The RTC runs 200 ppm faster than systick, it is read once a minute
+	clock.sync(1000, rtcEpochMs);
+	EXPECT_EQ(clock.getEpochMs(1500), rtcEpochMs + 500);
+
+	for (uint64_t ticks = 1000 + RTC_RESYNC_PERIOD_MS; ticks <= 1000 + 10 * RTC_RESYNC_PERIOD_MS; ticks += RTC_RESYNC_PERIOD_MS)
+	{
+		clock.sync(ticks, rtcEpochMs + (ticks - 1000) + (ticks - 1000) / 5000);
+	}
+
+	EXPECT_EQ(clock.getDriftPpm(), 200);
+
+	// Interpolation follows the RTC rate, half a period later the RTC moved 6 ms more than systick
+	uint64_t anchorTicks = 1000 + 10 * RTC_RESYNC_PERIOD_MS;
+	uint64_t anchorEpoch = rtcEpochMs + 10 * RTC_RESYNC_PERIOD_MS + 10 * RTC_RESYNC_PERIOD_MS / 5000;
+	EXPECT_EQ(clock.getEpochMs(anchorTicks + 30000), anchorEpoch + 30006);
+
+	// An RTC behind the interpolated clock does not make time go backwards
+	uint64_t last = clock.getEpochMs(anchorTicks + 59999);
+	clock.sync(anchorTicks + 60000, last - 50);
+	EXPECT_EQ(clock.getEpochMs(anchorTicks + 60000), last);
+	EXPECT_EQ(clock.getEpochMs(anchorTicks + 60100), last + 50);
+
+	// A stepped RTC is not taken as drift
+	int32_t driftPpm = clock.getDriftPpm();
+	clock.sync(anchorTicks + 120000, last + 3600000);
+	EXPECT_EQ(clock.getDriftPpm(), driftPpm);
+
+	// After a reset the clock follows the RTC even backwards
+	clock.reset();
+	clock.sync(anchorTicks + 130000, rtcEpochMs);
+	EXPECT_EQ(clock.getEpochMs(anchorTicks + 130000), rtcEpochMs);
+
+	// Timestamps of the virtual RTC never decrease
+	virtualRTC rtc;
+	uint64_t   previous = rtc.getEpochMs();
+	for (uint8_t i = 0; i < 100; i++)
+	{
+		uint64_t current = rtc.getEpochMs();
+		ASSERT_GE(current, previous);
+		previous = current;
+	}
+}
+
+TEST(utilities, benchmarkRecordWriter)
+{
+	constexpr uint32_t iterations = 100000;
+
+	std::array<char, MSRD_DATA_BUFF_SIZE> buff;
+	const char*							  timestamp = "12:34:56-01/02/2025";
+	volatile size_t						  sink		= 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		float	temperature = 20.0f + static_cast<float>(i % 1000) * 0.01f;
+		uint8_t humidity	= static_cast<uint8_t>(i % 100);
+
+		sink = sink + static_cast<size_t>(snprintf(buff.data(), buff.size(), "%s;%.2f;%d\n", timestamp, static_cast<double>(temperature), humidity));
+	}
+	auto snprintfTime = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		float	temperature = 20.0f + static_cast<float>(i % 1000) * 0.01f;
+		uint8_t humidity	= static_cast<uint8_t>(i % 100);
+
+		recordWriter writer(buff);
+		writer.appendString(timestamp).appendChar(';').appendFixed(temperature, 2).appendChar(';').appendUnsigned(humidity).appendChar('\n');
+		sink = sink + writer.finish();
+	}
+	auto writerTime = std::chrono::steady_clock::now() - start;
+
+	printf("snprintf: %lld ns/record | recordWriter: %lld ns/record\n",
+		   static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(snprintfTime).count() / iterations),
+		   static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(writerTime).count() / iterations));
+
+	EXPECT_GT(sink, 0u);
+}
+
 TEST(terminalStateMachine, testChangesInSMState)
 {
 	virtualRTC				   rtc;
 	ADC::ADS1115			   loggerADC;
 	sensor::thermometer::AHT21 loggerThermometerHygrometer;
-	sensorService			   loggerSensorService(loggerADC, loggerThermometerHygrometer, loggerThermometerHygrometer);
+	processingManager		   myProcessingManager(rtc, loggerThermometerHygrometer);
+	sensorService			   loggerSensorService(loggerADC, myProcessingManager);
 	terminalStateMachine	   terminalOutput(rtc, loggerSensorService);
 	internalStorageComponent   storage;
 	configManager			   loggerConfig(terminalOutput, storage);
@@ -109,10 +367,11 @@ TEST(terminalStateMachine, testChangeToDeviceConfigState)
 {
 	loggerMetadata* pLoggerMetadata;
 
+	virtualRTC				   rtc;
 	ADC::ADS1115			   loggerADC;
 	sensor::thermometer::AHT21 loggerThermometerHygrometer;
-	sensorService			   loggerSensorService(loggerADC, loggerThermometerHygrometer, loggerThermometerHygrometer);
-	virtualRTC				   rtc;
+	processingManager		   myProcessingManager(rtc, loggerThermometerHygrometer);
+	sensorService			   loggerSensorService(loggerADC, myProcessingManager);
 	terminalStateMachine	   terminalOutput(rtc, loggerSensorService);
 	internalStorageComponent   storage;
 	configManager			   loggerConfig(terminalOutput, storage);
@@ -137,6 +396,48 @@ TEST(terminalStateMachine, testChangeToDeviceConfigState)
 	EXPECT_STREQ(pLoggerMetadata->loggerName, "station1") << "Failed to set loggerName";
 }
 
+TEST(terminalStateMachine, testStoreWidestMetadata)
+{
+	virtualRTC				   rtc;
+	ADC::ADS1115			   loggerADC;
+	sensor::thermometer::AHT21 loggerThermometerHygrometer;
+	processingManager		   myProcessingManager(rtc, loggerThermometerHygrometer);
+	sensorService			   loggerSensorService(loggerADC, myProcessingManager);
+	terminalStateMachine	   terminalOutput(rtc, loggerSensorService);
+	internalStorageComponent   storage;
+	configManager			   loggerConfig(terminalOutput, storage);
+	loggerMetadata*			   pLoggerMetadata = getLoggerMetadata();
+	loggerMetadata			   savedMetadata   = *pLoggerMetadata;
+
+	ASSERT_TRUE(storage.initFS());
+
+	// Every field at its widest still fits the stored line
+	std::memset(pLoggerMetadata->loggerName, 'n', sizeof(pLoggerMetadata->loggerName) - 1);
+	pLoggerMetadata->loggerName[sizeof(pLoggerMetadata->loggerName) - 1] = '\0';
+	pLoggerMetadata->fileTransmissionPeriod								 = UINT16_MAX;
+	pLoggerMetadata->generalMeasurementPeriod							 = UINT16_MAX;
+	pLoggerMetadata->restRequestPeriod									 = UINT16_MAX;
+	std::fill(std::begin(pLoggerMetadata->channelSamplingPeriods), std::end(pLoggerMetadata->channelSamplingPeriods), UINT16_MAX);
+	std::fill(std::begin(pLoggerMetadata->channelFastestPeriods), std::end(pLoggerMetadata->channelFastestPeriods), UINT16_MAX - 1);
+
+	terminalOutput.init(terminalState::initState);
+	terminalOutput.handler(terminalSignal::pressedKey_C, nullptr);
+	terminalOutput.handler(terminalSignal::pressedKey_S, nullptr);
+
+	loggerMetadata widestMetadata = *pLoggerMetadata;
+	*pLoggerMetadata			  = loggerMetadata{};
+
+	ASSERT_TRUE(storage.retrieveMetadata());
+	EXPECT_STREQ(pLoggerMetadata->loggerName, widestMetadata.loggerName);
+	EXPECT_EQ(pLoggerMetadata->restRequestPeriod, UINT16_MAX);
+	EXPECT_EQ(pLoggerMetadata->channelSamplingPeriods[MAX_SAMPLED_CHANNELS - 1], UINT16_MAX);
+	EXPECT_EQ(pLoggerMetadata->channelFastestPeriods[MAX_SAMPLED_CHANNELS - 1], UINT16_MAX - 1);
+
+	// Leave the previous configuration stored
+	*pLoggerMetadata = savedMetadata;
+	terminalOutput.handler(terminalSignal::pressedKey_S, nullptr);
+}
+
 TEST(httpClient, testHTTPClient)
 {
 	// 1. Server Setup
@@ -171,11 +472,7 @@ TEST(httpClient, testHTTPClient)
 	sensor::windVaneDavis<ADC::ADS1115> loggerWindVane(loggerADC);
 	sensor::thermometer::AHT21			loggerThermometerHygrometer;
 
-	// clang-format off
-	processingManager myProcessingManager(rtc, 
-								   	      loggerThermometerHygrometer, 
-								          loggerThermometerHygrometer);
-	// clang-format on
+	processingManager myProcessingManager(rtc, loggerThermometerHygrometer);
 
 	network::networkManager myNetwork("127.0.0.1", "255.255.255.0", "127.0.0.1");
 	myNetwork.init();
@@ -190,7 +487,7 @@ TEST(httpClient, testHTTPClient)
 	myProcessingManager.formatData();
 	myProcessingManager.notifyObservers();
 
-	myHttpClient.setMailBox(myProcessingManager.getSensorInfoBuff());
+	myHttpClient.setMailBox(myProcessingManager.getSensorJsonBuff());
 	myHttpClient.setURL("127.0.0.1:8081");
 	// 5. Execute network task logic, simulating what the main loop would do
 	ASSERT_TRUE(myHttpClient.runTaskFlag()) << "httpClient was not notified by processingManager";
@@ -206,49 +503,1651 @@ TEST(httpClient, testHTTPClient)
 	EXPECT_TRUE(retVal.value()) << "HTTP POST failed.";
 }
 
-TEST(loggerSubsystem, testWritingExternal)
+TEST(processingSubsystem, testVariadicSensorSet)
 {
-	std::string							fileName;
-	std::string							lastLine;
-	fileSysWrapper						fileSystem(0); // Use the non-microcontroller implementation
-	loggerMetadata*						pLoggerMetadata;
 	virtualRTC							rtc;
 	ADC::ADS1115						loggerADC;
 	sensor::davisPluviometer			loggerPluviometer;
 	sensor::anemometerDavis				loggerAnemometer;
 	sensor::windVaneDavis<ADC::ADS1115> loggerWindVane(loggerADC);
 	sensor::thermometer::AHT21			loggerThermometerHygrometer;
-	// clang-format off
-	processingManager myProcessingManager(rtc, 
-								   	      loggerThermometerHygrometer, 
-								          loggerThermometerHygrometer);
-	// clang-format on
+	processingManager myProcessingManager(rtc, loggerThermometerHygrometer, loggerPluviometer, loggerAnemometer, loggerWindVane);
 
-	loggerManager myLoggerManager;
-	const char*	  testBuff = "123,125y3,23534if";
-	char		  timeStamp[20];
-	char		  finalTestBuff[100];
-	char		  storedData[56] = {0};
+	// Channels are known at compile time, in constructor order
+	static_assert(8 == decltype(myProcessingManager)::NUM_CHANNELS);
+	static_assert(2 == processingManager<sensor::thermometer::AHT21>::NUM_CHANNELS);
 
-	pLoggerMetadata						= getLoggerMetadata();
-	pLoggerMetadata->fileCreationPeriod = loggerMetadataConstants::CREATE_ONLY_ONE_FILE;
+	const auto& channels = decltype(myProcessingManager)::channels;
+	EXPECT_STREQ(channels[0].name, "temperature");
+	EXPECT_STREQ(channels[1].name, "humidity");
+	EXPECT_STREQ(channels[2].name, "rain");
+	EXPECT_STREQ(channels[3].name, "rainRate");
+	EXPECT_STREQ(channels[4].name, "windSpeed");
+	EXPECT_STREQ(channels[5].name, "windGust");
+	EXPECT_STREQ(channels[6].name, "windDirection");
+	EXPECT_STREQ(channels[7].name, "windGustDirection");
 
-	// Set observer and simulate processing of sensor data
-	myProcessingManager.setObserver(&myLoggerManager);
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.formatData();
+
+	// One field per channel after the timestamp
+	std::string record = myProcessingManager.getSensorInfoBuff();
+	EXPECT_EQ(std::count(record.begin(), record.end(), ';'), 8);
+	EXPECT_EQ(record.back(), '\n');
+
+	const auto& measurements = myProcessingManager.getRecord();
+	for (size_t index = 0; index < channels.size(); index++)
+	{
+		EXPECT_GE(measurements.captureMs[index], measurements.timestampMs);
+		EXPECT_NE(std::strstr(myProcessingManager.getSensorJsonBuff(), channels[index].name), nullptr);
+	}
+
+	EXPECT_EQ(myProcessingManager.getSensorJsonBuff()[0], '{');
+}
+
+namespace
+{
+/**
+ * @brief Sensor with a fast and a slow channel, counts its reads and returns the read number
+ */
+struct countingSensor
+{
+	static constexpr std::array<sensor::channelInfo, 2> channels = {{
+		{"fast", "u", 1, sensor::fieldType::INT16},
+		{"slow", "u", 1, sensor::fieldType::INT16},
+	}};
+
+	std::array<int, 2> reads{};
+
+	void init() {}
+
+	template<size_t channel>
+	float readChannel()
+	{
+		return static_cast<float>(++reads[channel]);
+	}
+};
+
+/**
+ * @brief Sensor reading the values set by the test
+ */
+struct settableSensor
+{
+	static constexpr std::array<sensor::channelInfo, 2> channels = {{
+		{"door", "u", 1, sensor::fieldType::INT16},
+		{"band", "u", 1, sensor::fieldType::INT16},
+	}};
+
+	std::array<float, 2> values{};
+
+	void init() {}
+
+	template<size_t channel>
+	float readChannel()
+	{
+		return values[channel];
+	}
+};
+
+/**
+ * @brief Device with two quantities from one conversion, counts its conversions
+ */
+struct countingMultiSensor : public sensor::IMultiQuantity<countingMultiSensor, 2>
+{
+	static constexpr std::array<sensor::channelInfo, 2> channels = {{
+		{"first", "u", 1, sensor::fieldType::INT16},
+		{"second", "u", 1, sensor::fieldType::INT16},
+	}};
+
+	int	 conversions = 0;
+	bool failing	 = false; /// Conversions fail while set
+
+	void init() {}
+
+	bool sampleImpl(std::array<float, 2>& quantities)
+	{
+		conversions++;
+		quantities = {static_cast<float>(conversions), static_cast<float>(-conversions)};
+
+		return (false == failing);
+	}
+
+	template<size_t channel>
+	std::optional<float> readChannel()
+	{
+		return getSample<channel>();
+	}
+};
+
+/**
+ * @brief Sensor with a blocking read of SLOW_SENSOR_READ_MS
+ */
+constexpr uint32_t SLOW_SENSOR_READ_MS = 50;
+
+struct slowSensor
+{
+	static constexpr std::array<sensor::channelInfo, 1> channels = {{{"slow", "u", 1, sensor::fieldType::INT16}}};
+
+	void init() {}
+
+	template<size_t channel>
+	float readChannel()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(SLOW_SENSOR_READ_MS));
+
+		return 1.0f;
+	}
+};
+} // namespace
+
+TEST(processingSubsystem, testMultiRateSampling)
+{
+	samplingScheduler<3> scheduler;
+	scheduler.setPeriod(0, 1000);
+	scheduler.setPeriod(1, 60000);
+
+	// Every scheduled channel is due on the first poll, unscheduled ones never
+	EXPECT_EQ(scheduler.getDueChannels(0), 0b011u);
+	EXPECT_EQ(scheduler.getScheduledChannels(), 0b011u);
+
+	// Late polls keep the cadence, missed periods are not sampled in a burst
+	EXPECT_EQ(scheduler.getDueChannels(999), 0u);
+	EXPECT_EQ(scheduler.getDueChannels(1010), 0b001u);
+	EXPECT_EQ(scheduler.getDueChannels(2000), 0b001u);
+	EXPECT_EQ(scheduler.getDueChannels(10500), 0b001u);
+	EXPECT_EQ(scheduler.getDueChannels(11000), 0u);
+	EXPECT_EQ(scheduler.getDueChannels(11500), 0b001u);
+
+	virtualRTC		  rtc;
+	countingSensor	  loggerSensor;
+	processingManager myProcessingManager(rtc, loggerSensor);
+
+	// Fast channel at 1 s, slow channel once per record, polled every 100 ms over one minute
+	myProcessingManager.setChannelPeriod(0, 1000);
+	for (uint64_t now = 0; now < 60000; now += 100)
+	{
+		myProcessingManager.sampleHandler(now);
+	}
+	myProcessingManager.takeMeasurements();
+
+	EXPECT_EQ(loggerSensor.reads[0], 60);
+	EXPECT_EQ(loggerSensor.reads[1], 1);
+
+	// The record holds the mean of the samples, 1 to 60
+	const auto& measurements = myProcessingManager.getRecord();
+	EXPECT_FLOAT_EQ(measurements.values[0], 30.5f);
+	EXPECT_FLOAT_EQ(measurements.values[1], 1.0f);
+
+	// A channel slower than the records keeps its last value
+	myProcessingManager.setChannelPeriod(1, 120000);
+	myProcessingManager.sampleHandler(60000);
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.sampleHandler(61000);
+	myProcessingManager.takeMeasurements();
+
+	EXPECT_EQ(loggerSensor.reads[1], 2);
+	EXPECT_FLOAT_EQ(myProcessingManager.getRecord().values[1], 2.0f);
+	EXPECT_FLOAT_EQ(myProcessingManager.getRecord().values[0], 62.0f);
+}
+
+TEST(processingSubsystem, testAdaptiveSampling)
+{
+	samplingScheduler<1> scheduler;
+	scheduler.setPeriod(0, 60000);
+	scheduler.setAdaptive(0, 5000, 0.5f);
+	EXPECT_EQ(scheduler.getAdaptiveChannels(), 0b1u);
+
+	// Two quiet hours with a front in the middle, 5 degC in ten minutes, polled every second
+	constexpr uint64_t frontStartMs = 60 * 60 * 1000;
+	constexpr uint64_t frontEndMs	= frontStartMs + 10 * 60 * 1000;
+	std::vector<uint64_t> sampleTimes;
+
+	for (uint64_t now = 0; now < 2 * frontStartMs; now += 1000)
+	{
+		if (0 == scheduler.getDueChannels(now))
+		{
+			continue;
+		}
+
+		float ramp = static_cast<float>(std::clamp(now, frontStartMs, frontEndMs) - frontStartMs) / static_cast<float>(frontEndMs - frontStartMs);
+		scheduler.addSample(0, 20.0f + 5.0f * ramp, now);
+		sampleTimes.push_back(now);
+
+		EXPECT_GE(scheduler.getEffectivePeriod(0), 5000u);
+		EXPECT_LE(scheduler.getEffectivePeriod(0), 60000u);
+	}
+
+	auto samplesBetween = [&](uint64_t startMs, uint64_t endMs)
+	{ return std::count_if(sampleTimes.begin(), sampleTimes.end(), [&](uint64_t time) { return time >= startMs && time < endMs; }); };
+
+	// Slow while quiet, fast during the front, back to the slowest period after it
+	EXPECT_EQ(samplesBetween(0, frontStartMs), 60);
+	EXPECT_GE(samplesBetween(frontStartMs, frontEndMs), 60);
+	EXPECT_LE(samplesBetween(frontEndMs + 30 * 60 * 1000, 2 * frontStartMs), 31);
+	EXPECT_EQ(scheduler.getEffectivePeriod(0), 60000u);
+
+	// Fewer samples than sampling at the fastest period all the time
+	EXPECT_LT(sampleTimes.size(), 2 * frontStartMs / 5000 / 4);
+
+	// A fixed period ends the adaptation
+	scheduler.setPeriod(0, 60000);
+	EXPECT_EQ(scheduler.getAdaptiveChannels(), 0u);
+	scheduler.addSample(0, 100.0f, 2 * frontStartMs);
+	EXPECT_EQ(scheduler.getEffectivePeriod(0), 60000u);
+
+	// Through the processing manager, the default threshold is 10 steps of the last decimal, 1.0 here
+	virtualRTC		  rtc;
+	countingSensor	  loggerSensor;
+	processingManager myProcessingManager(rtc, loggerSensor);
+
+	myProcessingManager.setChannelPeriod(0, 1000);
+	myProcessingManager.setAdaptivePeriod(0, 100);
+
+	// The reading counts up by one per sample, its spread soon exceeds the threshold
+	for (uint64_t now = 0; now < 10000; now += 100)
+	{
+		myProcessingManager.sampleHandler(now);
+	}
+
+	EXPECT_EQ(myProcessingManager.getChannelPeriod(0), 1000u);
+	EXPECT_EQ(myProcessingManager.getEffectivePeriod(0), 100u);
+	EXPECT_GT(loggerSensor.reads[0], 10);
+	EXPECT_EQ(myProcessingManager.getEffectivePeriod(1), 0u);
+}
+
+TEST(processingSubsystem, testSampleCache)
+{
+	virtualRTC		  rtc;
+	countingSensor	  loggerSensor;
+	processingManager myProcessingManager(rtc, loggerSensor);
+
+	static_assert(0 == decltype(myProcessingManager)::findChannel("fast"));
+	static_assert(-1 == decltype(myProcessingManager)::findChannel("missing"));
+
+	// Requests within the TTL share one read
+	EXPECT_FLOAT_EQ(myProcessingManager.getLatestSample(0, 0).value_or(0.0f), 1.0f);
+	EXPECT_FLOAT_EQ(myProcessingManager.getLatestSample(0, 500).value_or(0.0f), 1.0f);
+	EXPECT_FLOAT_EQ(myProcessingManager.getLatestSample(0, SAMPLE_CACHE_TTL_MS - 1).value_or(0.0f), 1.0f);
+	EXPECT_EQ(loggerSensor.reads[0], 1);
+
+	// A stale sample is read again
+	EXPECT_FLOAT_EQ(myProcessingManager.getLatestSample(0, SAMPLE_CACHE_TTL_MS).value_or(0.0f), 2.0f);
+	EXPECT_EQ(loggerSensor.reads[0], 2);
+	EXPECT_EQ(myProcessingManager.getCache().getHits(), 2u);
+	EXPECT_EQ(myProcessingManager.getCache().getMisses(), 2u);
+
+	// A measurement cycle reuses the fresh channel and reads the other one
+	myProcessingManager.startMeasurements(SAMPLE_CACHE_TTL_MS + 10);
+	EXPECT_TRUE(myProcessingManager.measurementsReady(SAMPLE_CACHE_TTL_MS + 10));
+	EXPECT_EQ(loggerSensor.reads[0], 2);
+	EXPECT_EQ(loggerSensor.reads[1], 1);
+	EXPECT_FLOAT_EQ(myProcessingManager.getRecord().values[0], 1.5f);
 
+	// A sample stamped after now is stale, it was stored with another clock
+	EXPECT_FALSE(myProcessingManager.getCache().getFreshChannels(0) & 0x2u);
+	myProcessingManager.getLatestSample(1, 0);
+	EXPECT_EQ(loggerSensor.reads[1], 2);
+
+	// Without a TTL every request reads the sensor
+	myProcessingManager.setCacheTtl(0);
+	myProcessingManager.getLatestSample(1, SAMPLE_CACHE_TTL_MS + 10);
+	EXPECT_EQ(loggerSensor.reads[1], 3);
+	EXPECT_FALSE(myProcessingManager.getLatestSample(2, 0).has_value());
+}
+
+TEST(processingSubsystem, testRecordCompression)
+{
+	using record_t = measurementRecord<2>;
+
+	// A day of one minute records, a slow temperature and an integer humidity
+	constexpr uint64_t	  periodMs = 60 * 1000;
+	constexpr float		  twoPi	   = 6.28318531f;
+	std::vector<record_t> records;
+
+	for (uint64_t timeMs = 0; timeMs < SIGNAL_DAY_MS; timeMs += periodMs)
+	{
+		float phase = twoPi * static_cast<float>(timeMs) / static_cast<float>(SIGNAL_DAY_MS);
+		records.push_back({timeMs, {20.0f + 5.0f * std::cos(phase), std::round(60.0f + 10.0f * std::sin(phase))}, {}});
+	}
+
+	// Step of the temperature in the afternoon
+	for (size_t index = 900; index < records.size(); index++)
+	{
+		records[index].values[0] += 3.0f;
+	}
+
+	compression::recordFilter<2> filter;
+	filter.configure(0, compression::filterMode::SWINGING_DOOR, 0.1f);
+	filter.configure(1, compression::filterMode::DEAD_BAND, 1.0f);
+	filter.setMaxInterval(30 * 60 * 1000);
+
+	std::vector<record_t> stored;
+	for (const record_t& record : records)
+	{
+		record_t held;
+		uint8_t	 emitted = filter.filter(record, held);
+
+		if (0 != (emitted & compression::EMIT_HELD))
+		{
+			stored.push_back(held);
+		}
+
+		if (0 != (emitted & compression::EMIT_CURRENT))
+		{
+			stored.push_back(record);
+		}
+	}
+
+	EXPECT_EQ(filter.getOffered(), records.size());
+	EXPECT_EQ(filter.getStored(), stored.size());
+	EXPECT_GT(filter.getSuppressionRatio(), 0.8f);
+
+	// The first record and the step are stored, and a record at least every max interval
+	ASSERT_GE(stored.size(), 2u);
+	EXPECT_EQ(stored.front().timestampMs, 0u);
+	EXPECT_NE(std::find_if(stored.begin(), stored.end(), [&](const record_t& record) { return record.timestampMs == records[900].timestampMs; }), stored.end());
+
+	for (size_t index = 1; index < stored.size(); index++)
+	{
+		EXPECT_GT(stored[index].timestampMs, stored[index - 1].timestampMs);
+		EXPECT_LE(stored[index].timestampMs - stored[index - 1].timestampMs, 30u * 60u * 1000u);
+	}
+
+	// Every record up to the last one stored is rebuilt within the tolerances
+	size_t segment = 0;
+	for (const record_t& record : records)
+	{
+		if (record.timestampMs > stored.back().timestampMs)
+		{
+			break;
+		}
+
+		while (segment + 2 < stored.size() && stored[segment + 1].timestampMs <= record.timestampMs)
+		{
+			segment++;
+		}
+
+		const record_t& start = stored[segment];
+		const record_t& end	  = (record.timestampMs <= start.timestampMs) ? start : stored[segment + 1];
+		float			ratio = (end.timestampMs == start.timestampMs) ? 0.0f : static_cast<float>(record.timestampMs - start.timestampMs) / static_cast<float>(end.timestampMs - start.timestampMs);
+		float			step  = (end.timestampMs == record.timestampMs) ? end.values[1] : start.values[1];
+
+		EXPECT_LE(std::fabs(start.values[0] + ratio * (end.values[0] - start.values[0]) - record.values[0]), 0.1f + 1e-4f) << record.timestampMs;
+		EXPECT_LE(std::fabs(step - record.values[1]), 1.0f) << record.timestampMs;
+	}
+
+	// Through the processing manager, repeated readings are not notified
+	struct countingObserver : public observerInterface
+	{
+		int notifications = 0;
+
+		void update() override
+		{
+			notifications++;
+		}
+	};
+
+	virtualRTC		  rtc;
+	countingSensor	  loggerSensor;
+	countingObserver  observer;
+	processingManager myProcessingManager(rtc, loggerSensor);
+	myProcessingManager.setObserver(&observer);
+	myProcessingManager.setCacheTtl(0);
+
+	// Without compression every record is notified
 	myProcessingManager.takeMeasurements();
 	myProcessingManager.formatData();
 	myProcessingManager.notifyObservers();
+	EXPECT_EQ(observer.notifications, 1);
 
-	// loggerManager handler
-	myLoggerManager.init();
-	myLoggerManager.setMailBox(myProcessingManager.getSensorInfoBuff());
-	myLoggerManager.handler();
+	// Readings count up by one per record, a band of 2.5 stores one record in three
+	myProcessingManager.setCompression(0, compression::filterMode::DEAD_BAND, 2.5f);
+	myProcessingManager.setCompression(1, compression::filterMode::DEAD_BAND, 2.5f);
 
-	// Read simulated file in "external device"
-	fileName = utilities::getPathMetadata(pLoggerMetadata->loggerName);
-	lastLine = utilities::getLastLine(fileName);
+	for (int cycle = 0; cycle < 9; cycle++)
+	{
+		myProcessingManager.takeMeasurements();
+		myProcessingManager.formatData();
+		myProcessingManager.notifyObservers();
+	}
 
-	EXPECT_STREQ(myProcessingManager.getSensorInfoBuff(), lastLine.c_str());
-	EXPECT_TRUE(true);
-}
\ No newline at end of file
+	EXPECT_EQ(observer.notifications, 1 + 3);
+	EXPECT_EQ(myProcessingManager.getCompression().getOffered(), 9u);
+	EXPECT_NEAR(myProcessingManager.getCompression().getSuppressionRatio(), 6.0f / 9.0f, 1e-6f);
+
+	myProcessingManager.disableCompression();
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.formatData();
+	myProcessingManager.notifyObservers();
+	EXPECT_EQ(observer.notifications, 1 + 3 + 1);
+
+	// A held record released with the current one reaches every output, held first
+	settableSensor	  doorSensor;
+	processingManager doorProcessingManager(rtc, doorSensor);
+	doorProcessingManager.setCacheTtl(0);
+	doorProcessingManager.setCompression(0, compression::filterMode::SWINGING_DOOR, 0.5f);
+	doorProcessingManager.setCompression(1, compression::filterMode::DEAD_BAND, 0.5f);
+
+	auto measure = [&](float door, float band)
+	{
+		doorSensor.values = {door, band};
+		doorProcessingManager.takeMeasurements();
+		doorProcessingManager.formatData();
+		doorProcessingManager.notifyObservers();
+	};
+
+	measure(0.0f, 0.0f);
+	measure(1.0f, 0.0f); // Held, on the line
+	measure(5.0f, 5.0f); // Off the door and out of the band
+
+	std::string csv	 = doorProcessingManager.getSensorInfoBuff();
+	std::string json = doorProcessingManager.getSensorJsonBuff();
+
+	EXPECT_EQ(doorProcessingManager.getCompression().getStored(), 3u);
+	EXPECT_NE(csv.find(";1.0;0.0\n"), std::string::npos);
+	EXPECT_LT(csv.find(";1.0;0.0\n"), csv.find(";5.0;5.0\n"));
+	ASSERT_EQ(json.front(), '[');
+	EXPECT_EQ(json.back(), ']');
+	EXPECT_NE(json.find("\"door\":1.0,"), std::string::npos);
+	EXPECT_LT(json.find("\"door\":1.0,"), json.find("\"door\":5.0,"));
+	EXPECT_NE(json.find("},{\"schema\":"), std::string::npos);
+}
+
+TEST(processingSubsystem, testWindowStatistics)
+{
+	// Pressure like channel, large offset and small spread, spanning several blocks
+	constexpr size_t						  numSamples = 3 * STATS_BLOCK_SIZE + 5;
+	statistics::windowStatistics<2>			  window;
+	std::array<float, numSamples>			  samples;
+	double									  sum = 0.0;
+
+	for (size_t index = 0; index < numSamples; index++)
+	{
+		samples[index] = 1013.25f + static_cast<float>(index % 7) * 0.1f;
+		sum			  += static_cast<double>(samples[index]);
+		window.add(0, samples[index]);
+	}
+
+	double mean		= sum / numSamples;
+	double variance = 0.0;
+	for (float sample : samples)
+	{
+		variance += (static_cast<double>(sample) - mean) * (static_cast<double>(sample) - mean);
+	}
+
+	EXPECT_EQ(window.getCount(0), numSamples);
+	EXPECT_EQ(window.getCount(1), 0u);
+
+	statistics::summary result = window.close(0);
+	EXPECT_EQ(result.count, numSamples);
+	EXPECT_NEAR(result.mean, mean, 1e-4);
+	EXPECT_NEAR(result.stddev, std::sqrt(variance / numSamples), 1e-3);
+	EXPECT_FLOAT_EQ(result.min, 1013.25f);
+	EXPECT_FLOAT_EQ(result.max, 1013.85f);
+	EXPECT_FLOAT_EQ(result.last, samples[numSamples - 1]);
+	EXPECT_EQ(window.getCount(0), 0u);
+	EXPECT_EQ(window.close(1).count, 0u);
+
+	// The vector kernel matches the scalar one, tails included
+	for (size_t count = 0; count <= 19; count++)
+	{
+		statistics::moments scalar = statistics::reduceScalar(samples.data(), count, samples[0]);
+		statistics::moments vector = statistics::reduce(samples.data(), count, samples[0]);
+
+		EXPECT_EQ(vector.count, scalar.count);
+		EXPECT_NEAR(vector.sum, scalar.sum, 1e-3f);
+		EXPECT_NEAR(vector.sumSquares, scalar.sumSquares, 1e-3f);
+		EXPECT_FLOAT_EQ(vector.min, scalar.min);
+		EXPECT_FLOAT_EQ(vector.max, scalar.max);
+	}
+
+	// Records carry the mean, the rest of the window is kept alongside
+	virtualRTC		  rtc;
+	countingSensor	  loggerSensor;
+	processingManager myProcessingManager(rtc, loggerSensor);
+
+	myProcessingManager.setChannelPeriod(0, 1000);
+	for (uint64_t now = 0; now < 60000; now += 1000)
+	{
+		myProcessingManager.sampleHandler(now);
+	}
+	myProcessingManager.takeMeasurements();
+
+	const statistics::summary& channel = myProcessingManager.getChannelStatistics(0);
+	EXPECT_EQ(channel.count, 60u);
+	EXPECT_FLOAT_EQ(channel.mean, 30.5f);
+	EXPECT_FLOAT_EQ(channel.min, 1.0f);
+	EXPECT_FLOAT_EQ(channel.max, 60.0f);
+	EXPECT_FLOAT_EQ(channel.last, 60.0f);
+	EXPECT_NEAR(channel.stddev, std::sqrt((60.0f * 60.0f - 1.0f) / 12.0f), 1e-3f);
+	EXPECT_EQ(myProcessingManager.getChannelStatistics(1).count, 1u);
+}
+
+TEST(processingSubsystem, benchmarkStatisticsKernels)
+{
+	constexpr uint32_t iterations = 20000;
+
+	std::array<float, 1024> samples;
+	for (size_t index = 0; index < samples.size(); index++)
+	{
+		samples[index] = 20.0f + static_cast<float>(index % 100) * 0.01f;
+	}
+
+	volatile float sink = 0.0f;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		sink = sink + statistics::reduceScalar(samples.data(), samples.size(), samples[0]).sum;
+	}
+	auto scalarTime = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		sink = sink + statistics::reduce(samples.data(), samples.size(), samples[0]).sum;
+	}
+	auto vectorTime = std::chrono::steady_clock::now() - start;
+
+	auto samplesPerUs = [&](auto elapsed)
+	{
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		return static_cast<long long>(iterations) * static_cast<long long>(samples.size()) * 1000 / ((ns > 0) ? ns : 1);
+	};
+
+	RecordProperty("scalarSamplesPerUs", static_cast<int>(samplesPerUs(scalarTime)));
+	RecordProperty("vectorSamplesPerUs", static_cast<int>(samplesPerUs(vectorTime)));
+
+	EXPECT_NE(sink, 0.0f);
+}
+
+TEST(processingSubsystem, testSharedConversion)
+{
+	virtualRTC			rtc;
+	countingMultiSensor multiSensor;
+	processingManager	myProcessingManager(rtc, multiSensor);
+
+	// The RTC does not run in tests, cached samples would never get stale
+	myProcessingManager.setCacheTtl(0);
+
+	EXPECT_FALSE(multiSensor.getSample<0>().has_value());
+
+	// Both channels come from a single conversion and share its capture time
+	myProcessingManager.takeMeasurements();
+
+	const auto& measurements = myProcessingManager.getRecord();
+	EXPECT_EQ(multiSensor.conversions, 1);
+	EXPECT_FLOAT_EQ(measurements.values[0], 1.0f);
+	EXPECT_FLOAT_EQ(measurements.values[1], -1.0f);
+	EXPECT_EQ(measurements.captureMs[0], measurements.captureMs[1]);
+
+	// A scheduled channel converts once per period, the other channel is not sampled with it
+	myProcessingManager.setChannelPeriod(0, 1000);
+	for (uint64_t now = 0; now < 10000; now += 500)
+	{
+		myProcessingManager.sampleHandler(now);
+	}
+	myProcessingManager.takeMeasurements();
+
+	EXPECT_EQ(multiSensor.conversions, 12);
+	EXPECT_FLOAT_EQ(measurements.values[0], 6.5f);
+	EXPECT_FLOAT_EQ(measurements.values[1], -12.0f);
+
+	// Failed conversions are not samples, the statistics only see real values
+	myProcessingManager.setChannelPeriod(0, 0);
+	myProcessingManager.takeMeasurements();
+	multiSensor.failing = true;
+	myProcessingManager.takeMeasurements();
+
+	EXPECT_EQ(multiSensor.conversions, 14);
+	EXPECT_EQ(myProcessingManager.getChannelStatistics(0).count, 1u);
+	EXPECT_FLOAT_EQ(myProcessingManager.getChannelStatistics(0).mean, 13.0f);
+
+	// The channels of a failed read are missing from the record, not repeated
+	EXPECT_TRUE(std::isnan(measurements.values[0]));
+	EXPECT_TRUE(std::isnan(measurements.values[1]));
+
+	myProcessingManager.formatData();
+	std::string csvLine = myProcessingManager.getSensorInfoBuff();
+	std::string json	= myProcessingManager.getSensorJsonBuff();
+	EXPECT_EQ(csvLine.substr(csvLine.find(';')), ";;\n");
+	EXPECT_NE(json.find("\"first\":null,"), std::string::npos);
+	EXPECT_NE(json.find("\"second\":null,"), std::string::npos);
+
+	// The next good read clears the marker
+	multiSensor.failing = false;
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.formatData();
+	csvLine = myProcessingManager.getSensorInfoBuff();
+
+	EXPECT_FLOAT_EQ(measurements.values[0], 15.0f);
+	EXPECT_EQ(csvLine.substr(csvLine.find(';')), ";15.0;-15.0\n");
+
+	// The AHT21 channels also share one conversion
+	sensor::thermometer::AHT21 loggerThermometerHygrometer;
+	EXPECT_TRUE(loggerThermometerHygrometer.sample());
+	EXPECT_FLOAT_EQ(loggerThermometerHygrometer.readChannel<0>().value_or(0.0f), 25.5f);
+	EXPECT_FLOAT_EQ(loggerThermometerHygrometer.readChannel<1>().value_or(0.0f), 70.0f);
+}
+
+TEST(sensors, benchmarkAsyncAcquisition)
+{
+	using namespace std::chrono;
+
+	sensor::thermometer::AHT21 loggerThermometerHygrometer;
+
+	// Blocking reads stall the caller for a conversion each
+	auto start = steady_clock::now();
+	loggerThermometerHygrometer.readTemperature();
+	loggerThermometerHygrometer.readHumidity();
+	auto blockingTime = steady_clock::now() - start;
+
+	// Non blocking: the caller keeps running between polls
+	EXPECT_FALSE(loggerThermometerHygrometer.collectTemperature().has_value());
+
+	// The conversion is timed on the mock conversion clock, host timings are only reported
+	uint64_t conversionStartMs = sensorSimulator::getReplayTimeMs();
+	start					   = steady_clock::now();
+	EXPECT_TRUE(loggerThermometerHygrometer.startTemperature());
+	auto startTime = steady_clock::now() - start;
+
+	steady_clock::duration longestPoll{};
+	uint32_t			   polls = 0;
+	sensor::conversionStatus status;
+	do
+	{
+		auto pollStart = steady_clock::now();
+		status		   = loggerThermometerHygrometer.pollTemperature();
+		longestPoll	   = std::max(longestPoll, steady_clock::now() - pollStart);
+		polls++;
+		std::this_thread::sleep_for(milliseconds(1));
+	} while (sensor::conversionStatus::BUSY == status);
+	uint64_t conversionTimeMs = sensorSimulator::getReplayTimeMs() - conversionStartMs;
+
+	EXPECT_EQ(status, sensor::conversionStatus::READY);
+	EXPECT_EQ(loggerThermometerHygrometer.pollHumidity(), sensor::conversionStatus::READY);
+	EXPECT_FLOAT_EQ(loggerThermometerHygrometer.collectTemperature().value_or(0.0f), 25.5f);
+	EXPECT_EQ(loggerThermometerHygrometer.collectHumidity().value_or(0), 70);
+	EXPECT_GE(conversionTimeMs, AHT21_CONVERSION_TIME_MS);
+	EXPECT_GT(polls, 1u); // Polls return while the conversion runs
+
+	RecordProperty("blockingMs", static_cast<int>(duration_cast<milliseconds>(blockingTime).count()));
+	RecordProperty("startUs", static_cast<int>(duration_cast<microseconds>(startTime).count()));
+	RecordProperty("longestPollUs", static_cast<int>(duration_cast<microseconds>(longestPoll).count()));
+	RecordProperty("polls", static_cast<int>(polls));
+	RecordProperty("conversionMs", static_cast<int>(conversionTimeMs));
+
+	// A conversion that never completes times out
+	aht21Mock::setConversionTime(10 * AHT21_CONVERSION_TIMEOUT_MS);
+	EXPECT_TRUE(loggerThermometerHygrometer.startHumidity());
+	while (sensor::conversionStatus::BUSY == (status = loggerThermometerHygrometer.pollHumidity()))
+	{
+		std::this_thread::sleep_for(milliseconds(1));
+	}
+	aht21Mock::setConversionTime(AHT21_CONVERSION_TIME_MS);
+
+	EXPECT_EQ(status, sensor::conversionStatus::FAILED);
+	EXPECT_FALSE(loggerThermometerHygrometer.collectHumidity().has_value());
+}
+
+TEST(processingSubsystem, testPipelinedAcquisition)
+{
+	virtualRTC				   rtc;
+	sensor::thermometer::AHT21 loggerThermometerHygrometer;
+	slowSensor				   loggerSlowSensor;
+	processingManager		   myProcessingManager(rtc, loggerThermometerHygrometer, loggerSlowSensor);
+
+	// Same clock as the AHT21 mock conversion, two clocks truncated apart can disagree by 1 ms
+	auto nowMs = []
+	{
+		return sensorSimulator::getReplayTimeMs();
+	};
+
+	// The AHT21 converts while the slow sensor is read, the cycle is not done when start returns
+	myProcessingManager.startMeasurements(nowMs());
+	EXPECT_FALSE(myProcessingManager.measurementsReady(nowMs()));
+
+	while (false == myProcessingManager.measurementsReady(nowMs()))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const auto& measurements = myProcessingManager.getRecord();
+	EXPECT_FLOAT_EQ(measurements.values[0], 25.5f);
+	EXPECT_FLOAT_EQ(measurements.values[1], 70.0f);
+	EXPECT_FLOAT_EQ(measurements.values[2], 1.0f);
+
+	// Both channels of the AHT21 share the conversion time, inside the cycle
+	EXPECT_EQ(measurements.captureMs[0], measurements.captureMs[1]);
+	EXPECT_GE(measurements.captureMs[0], measurements.timestampMs);
+
+	// Cycle time follows the slowest sensor, not the sum of both
+	uint32_t latency = myProcessingManager.getCycleLatencyMs();
+	RecordProperty("cycleLatencyMs", static_cast<int>(latency));
+	EXPECT_GE(latency, AHT21_CONVERSION_TIME_MS);
+	EXPECT_LT(latency, AHT21_CONVERSION_TIME_MS + SLOW_SENSOR_READ_MS);
+
+	// One record per cycle
+	EXPECT_FALSE(myProcessingManager.measurementsReady(nowMs()));
+}
+
+TEST(sensors, testContinuousScanner)
+{
+	ADC::ADS1115					 loggerADC;
+	constexpr std::array<uint8_t, 3> inputs = {ADS1115_COMP_0_GND, ADS1115_COMP_1_GND, ADS1115_COMP_3_GND};
+
+	ads1115Mock::setInputVoltage(ADS1115_COMP_0_GND, 1.0f);
+	ads1115Mock::setInputVoltage(ADS1115_COMP_1_GND, 2.0f);
+	ads1115Mock::setInputVoltage(ADS1115_COMP_3_GND, 0.5f);
+
+	EXPECT_FALSE(loggerADC.startScan(inputs, ADS1115_RATE_860SPS, 0));
+	EXPECT_FALSE(loggerADC.startScan(inputs, 8, 4));
+	ASSERT_TRUE(loggerADC.startScan(inputs, ADS1115_RATE_860SPS, 4));
+
+	// 860 SPS with 10 % tolerance is a conversion every 2 ms, polls in between do nothing
+	for (uint64_t now = 0; now <= 2 * 5 * 3 * 4; now++)
+	{
+		loggerADC.scanHandler(now);
+	}
+
+	// 4 rounds over 3 inputs, each sample is 1 dropped conversion and 4 averaged
+	std::array<float, ADS1115_SCAN_BUFFER_SIZE> samples;
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_0_GND, samples), 4u);
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_0_GND, samples), 0u);
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_1_GND, std::span<float>(samples).first(3)), 3u);
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_1_GND, samples), 1u);
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_2_GND, samples), 0u);
+
+	// The conversion in progress when switching input is dropped, inputs do not mix
+	EXPECT_FLOAT_EQ(samples[0], 2.0f);
+	EXPECT_FLOAT_EQ(loggerADC.getLastSample(ADS1115_COMP_0_GND).value_or(0.0f), 1.0f);
+	EXPECT_FLOAT_EQ(loggerADC.getLastSample(ADS1115_COMP_3_GND).value_or(0.0f), 0.5f);
+	EXPECT_FALSE(loggerADC.getLastSample(ADS1115_COMP_2_GND).has_value());
+
+	// Reads are served from the scan
+	EXPECT_FLOAT_EQ(loggerADC.readVoltage(ADS1115_COMP_1_GND), 2.0f);
+
+	loggerADC.stopScan();
+	EXPECT_FALSE(loggerADC.isScanning());
+	EXPECT_FLOAT_EQ(loggerADC.readVoltage(ADS1115_COMP_3_GND), 0.5f);
+
+	// ALERT/RDY configured: conversions are read on the edge, without it on the deadline
+	ads1115Mock::setAlertAvailable(true);
+	ASSERT_TRUE(loggerADC.startScan(std::span(inputs).first(1), ADS1115_RATE_860SPS, 1));
+
+	loggerADC.conversionReadyISR();
+	loggerADC.scanHandler(0);
+	loggerADC.conversionReadyISR();
+	loggerADC.scanHandler(1);
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_0_GND, samples), 1u);
+
+	// No edge, the conversion is read once two periods of 2 ms passed
+	loggerADC.scanHandler(4);
+	EXPECT_EQ(loggerADC.getMissedAlerts(), 0u);
+	loggerADC.scanHandler(5);
+	EXPECT_EQ(loggerADC.getMissedAlerts(), 1u);
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_0_GND, samples), 1u);
+	EXPECT_FLOAT_EQ(samples[0], 1.0f);
+
+	for (uint64_t now = 6; now <= 25; now++)
+	{
+		loggerADC.scanHandler(now);
+	}
+
+	EXPECT_EQ(loggerADC.getMissedAlerts(), 6u);
+	EXPECT_EQ(loggerADC.readSamples(ADS1115_COMP_0_GND, samples), 5u);
+
+	loggerADC.stopScan();
+	ads1115Mock::setAlertAvailable(false);
+
+	for (uint8_t input : inputs)
+	{
+		ads1115Mock::setInputVoltage(input, 3.3f);
+	}
+}
+
+TEST(sensors, testWindVectorAveraging)
+{
+	ADC::ADS1115						loggerADC;
+	sensor::windVaneDavis<ADC::ADS1115> loggerWindVane(loggerADC, ADS1115_COMP_1_GND);
+
+	auto setDirection = [](float degrees) { ads1115Mock::setInputVoltage(ADS1115_COMP_1_GND, degrees / 360.0f * WIND_VANE_SUPPLY_V); };
+	auto angleError	  = [](uint16_t measured, int expected)
+	{
+		int error = (static_cast<int>(measured) - expected + 540) % 360 - 180;
+		return (error < 0) ? -error : error;
+	};
+
+	// The lookup table resolves the vane to about 1.4 degrees
+	for (int degrees : {0, 45, 90, 180, 270, 315})
+	{
+		setDirection(static_cast<float>(degrees));
+		EXPECT_LE(angleError(loggerWindVane.getWindDir(), degrees), 1) << degrees;
+	}
+
+	// Averaging across north gives north, not south
+	setDirection(350.0f);
+	loggerWindVane.addSample(2.0f);
+	setDirection(10.0f);
+	loggerWindVane.addSample(2.0f);
+	loggerWindVane.sample();
+
+	EXPECT_LE(angleError(static_cast<uint16_t>(loggerWindVane.readChannel<0>()), 0), 1);
+	EXPECT_GT(loggerWindVane.getWindSummary().steadiness, 0.98f);
+
+	// Speed weighted, a strong east wind pulls the mean away from a light north wind
+	sensor::windVectorAverager averager;
+	averager.add(0, 1.0f);
+	averager.add(90, 3.0f);
+	averager.add(90, 5.0f);
+
+	sensor::windSummary wind = averager.close();
+	EXPECT_EQ(wind.count, 3u);
+	EXPECT_LE(angleError(wind.meanDirection, 83), 1);
+	EXPECT_FLOAT_EQ(wind.scalarSpeed, 3.0f);
+	EXPECT_NEAR(wind.vectorSpeed, std::sqrt(65.0f) / 3.0f, 1e-4f);
+	EXPECT_FLOAT_EQ(wind.gustSpeed, 5.0f);
+	EXPECT_EQ(wind.gustDirection, 90);
+	EXPECT_EQ(averager.getCount(), 0u);
+
+	// Without speed the directions weigh the same
+	averager.add(0, 0.0f);
+	averager.add(90, 0.0f);
+	EXPECT_LE(angleError(averager.close().meanDirection, 45), 1);
+
+	// Records carry the window, an empty window reads the vane once
+	virtualRTC		  rtc;
+	processingManager myProcessingManager(rtc, loggerWindVane);
+	setDirection(200.0f);
+	myProcessingManager.takeMeasurements();
+	EXPECT_LE(angleError(static_cast<uint16_t>(myProcessingManager.getRecord().values[0]), 200), 1);
+
+	ads1115Mock::setInputVoltage(ADS1115_COMP_1_GND, 3.3f);
+}
+
+TEST(sensors, testPulseCounter)
+{
+	sensor::davisPluviometer	   loggerPluviometer;
+	virtualDevice::virtualCounter& counter = loggerPluviometer.getCounter();
+
+	ASSERT_TRUE(loggerPluviometer.init());
+
+	// 100 tips 500 ms apart, each followed by 3 bounce edges
+	counterMock::injectPulseTrain(counter, 1000, 100, 500, 3);
+	EXPECT_EQ(counter.getTotalPulses(), 100u);
+
+	// 0.2 mm per tip, a tip every 500 ms is 7200 tips/h
+	uint32_t lastTipMs = 1000 + 99 * 500;
+	EXPECT_FLOAT_EQ(loggerPluviometer.getRainRate(lastTipMs + 100), 1440.0f);
+	EXPECT_NEAR(loggerPluviometer.getRain(), 20.0f, 1e-4f);
+	EXPECT_FLOAT_EQ(loggerPluviometer.getRain(), 0.0f);
+
+	// The rate decays once the tips stop and drops to 0 after the timeout
+	EXPECT_FLOAT_EQ(loggerPluviometer.getRainRate(lastTipMs + 1000), 720.0f);
+	EXPECT_FLOAT_EQ(loggerPluviometer.getRainRate(lastTipMs + COUNTER_RATE_TIMEOUT_MS), 0.0f);
+
+	// Tips just above the debounce time are all counted while the totals are read concurrently
+	constexpr uint32_t tips = 20000;
+	uint32_t		   read = 0;
+	std::atomic<bool>  done = false;
+
+	auto injectTips = [&]
+	{
+		counterMock::injectPulseTrain(counter, 100000, tips, COUNTER_DEBOUNCE_MS + 1, 2);
+		done = true;
+	};
+	std::thread pulses(injectTips);
+
+	while (false == done)
+	{
+		read += counter.readandResetCounter();
+	}
+	pulses.join();
+	read += counter.readandResetCounter();
+
+	EXPECT_EQ(read, tips);
+	EXPECT_EQ(counter.getTotalPulses(), 100u + tips);
+}
+
+TEST(sensors, testFrequencyCapture)
+{
+	sensor::anemometerDavis loggerAnemometer;
+
+	// Captures are fed in chunks smaller than the DMA ring, as update() would see them
+	auto injectPulses = [&](uint32_t startTicks, uint32_t pulses, uint32_t periodTicks)
+	{
+		for (uint32_t pulse = 0; pulse < pulses; pulse += 100)
+		{
+			uint32_t chunk = (pulses - pulse < 100) ? pulses - pulse : 100;
+			captureMock::injectPulseTrain(startTicks + pulse * periodTicks, chunk, periodTicks);
+			loggerAnemometer.update();
+		}
+	};
+
+	captureMock::setCounter(0);
+	ASSERT_TRUE(loggerAnemometer.init());
+
+	// Steady 10 Hz for one minute
+	injectPulses(100000, 600, 100000);
+	EXPECT_NEAR(loggerAnemometer.getWindSpeed(), 10.0f * ANEMOMETER_MS_PER_HZ, 1e-3f);
+
+	loggerAnemometer.sample();
+	EXPECT_NEAR(loggerAnemometer.readChannel<0>(), 10.0f * ANEMOMETER_MS_PER_HZ, 1e-3f);
+	EXPECT_NEAR(loggerAnemometer.readChannel<1>(), 10.0f * ANEMOMETER_MS_PER_HZ, 1e-3f);
+
+	// A 3 s burst at 50 Hz in a 10 s window is the gust, the mean is 150 pulses in 10 s
+	injectPulses(63000000, 150, 20000);
+	captureMock::setCounter(70000000);
+	loggerAnemometer.update();
+
+	loggerAnemometer.sample();
+	EXPECT_NEAR(loggerAnemometer.readChannel<0>(), 15.0f * ANEMOMETER_MS_PER_HZ, 1e-3f);
+	EXPECT_NEAR(loggerAnemometer.readChannel<1>(), 50.0f * ANEMOMETER_MS_PER_HZ, 1e-3f);
+
+	// The speed drops to 0 when the cups stop
+	captureMock::setCounter(80000000);
+	loggerAnemometer.update();
+	EXPECT_FLOAT_EQ(loggerAnemometer.getWindSpeed(), 0.0f);
+
+	// High pulse rates are resolved exactly, 500 Hz for 10 s
+	loggerAnemometer.sample();
+	injectPulses(80002000, 5000, 2000);
+	EXPECT_NEAR(loggerAnemometer.getWindSpeed(), 500.0f * ANEMOMETER_MS_PER_HZ, 1e-2f);
+
+	loggerAnemometer.sample();
+	EXPECT_NEAR(loggerAnemometer.readChannel<0>(), 500.0f * ANEMOMETER_MS_PER_HZ, 1e-2f);
+	EXPECT_NEAR(loggerAnemometer.readChannel<1>(), 500.0f * ANEMOMETER_MS_PER_HZ, 1e-2f);
+}
+
+TEST(sensors, testSignalReplay)
+{
+	using sensorSimulator::signalSource;
+
+	// A daily cycle peaks at peakMs and bottoms out half a day later
+	sensorSimulator::waveform shape;
+	shape.mean		= 20.0f;
+	shape.amplitude = 5.0f;
+
+	signalSource diurnal;
+	diurnal.setWaveform(shape, 0);
+	EXPECT_NEAR(diurnal.valueAt(SIGNAL_PEAK_MS), 25.0f, 1e-3f);
+	EXPECT_NEAR(diurnal.valueAt(SIGNAL_PEAK_MS + SIGNAL_DAY_MS / 2), 15.0f, 1e-3f);
+	EXPECT_NEAR(diurnal.valueAt(SIGNAL_PEAK_MS + SIGNAL_DAY_MS), 25.0f, 1e-3f);
+
+	// Noise and spikes only depend on the seed and the time, not on the order of the reads
+	shape.noise			   = 0.5f;
+	shape.spikeProbability = 0.01f;
+	shape.spikeAmplitude   = 10.0f;
+
+	signalSource first, second, other;
+	first.setWaveform(shape, 42);
+	second.setWaveform(shape, 42);
+	other.setWaveform(shape, 7);
+
+	constexpr uint32_t numSamples = 10000;
+	std::vector<float> values(numSamples);
+	uint32_t		   mismatches = 0;
+	uint32_t		   equals	  = 0;
+	uint32_t		   spikes	  = 0;
+	double			   sum		  = 0.0;
+	double			   sumSquares = 0.0;
+
+	for (uint32_t sample = 0; sample < numSamples; sample++)
+	{
+		values[sample]	= first.valueAt(SIGNAL_PEAK_MS + sample);
+		equals		   += (values[sample] == other.valueAt(SIGNAL_PEAK_MS + sample)) ? 1 : 0;
+	}
+
+	for (uint32_t sample = numSamples; sample > 0; sample--)
+	{
+		mismatches += (values[sample - 1] != second.valueAt(SIGNAL_PEAK_MS + sample - 1)) ? 1 : 0;
+	}
+
+	for (float value : values)
+	{
+		double residual = static_cast<double>(value) - 25.0;
+
+		if (residual > 5.0)
+		{
+			spikes++;
+			continue;
+		}
+
+		sum		   += residual;
+		sumSquares += residual * residual;
+	}
+
+	double count = numSamples - spikes;
+	EXPECT_EQ(mismatches, 0u);
+	EXPECT_LT(equals, 10u);
+	EXPECT_NEAR(spikes, 100u, 40u);
+	EXPECT_NEAR(sum / count, 0.0, 0.02);
+	EXPECT_NEAR(std::sqrt(sumSquares / count), 0.5, 0.02);
+
+	// Logged CSV files are replayed as they are, each value is held and the trace loops
+	std::string csvPath = utilities::getPathMetadata("replay.csv");
+	std::ofstream(csvPath) << "#schema=00000000\n"
+						   << "time;temperature[degC];humidity[%RH]\n"
+						   << "00:00:00.000-01/01/2025;20.50;60\n"
+						   << "00:01:00.000-01/01/2025;21.00;61\n"
+						   << "00:02:00.000-01/01/2025;21.50;62\n";
+
+	signalSource trace;
+	ASSERT_TRUE(trace.loadCsv(csvPath.c_str(), 0));
+	EXPECT_EQ(trace.getTraceSize(), 3u);
+	EXPECT_FLOAT_EQ(trace.valueAt(0), 20.5f);
+	EXPECT_FLOAT_EQ(trace.valueAt(59999), 20.5f);
+	EXPECT_FLOAT_EQ(trace.valueAt(60000), 21.0f);
+	EXPECT_FLOAT_EQ(trace.valueAt(179999), 21.5f);
+	EXPECT_FLOAT_EQ(trace.valueAt(180000), 20.5f);
+	ASSERT_TRUE(trace.loadCsv(csvPath.c_str(), 1));
+	EXPECT_FLOAT_EQ(trace.valueAt(60000), 61.0f);
+	EXPECT_FALSE(trace.loadCsv(csvPath.c_str(), 2));
+	EXPECT_FALSE(trace.loadCsv("missing.csv", 0));
+	std::remove(csvPath.c_str());
+
+	// Binary files are decoded with the schema they were written with
+	using schema_t = processingManager<sensor::thermometer::AHT21>::schema_t;
+
+	std::string			 binaryPath = utilities::getPathMetadata("replay.bin");
+	std::vector<uint8_t> binary(BINARY_FILE_HEADER_SIZE + 2 * schema_t::BINARY_RECORD_SIZE);
+	schema_t::record_t	 record{};
+
+	schema_t::writeBinaryHeader(binary);
+	record = {1000, {22.25f, 55.0f}, {}};
+	schema_t::encode(record, std::span<uint8_t>(binary).subspan(BINARY_FILE_HEADER_SIZE));
+	record = {3000, {23.5f, 57.0f}, {}};
+	schema_t::encode(record, std::span<uint8_t>(binary).subspan(BINARY_FILE_HEADER_SIZE + schema_t::BINARY_RECORD_SIZE));
+	std::ofstream(binaryPath, std::ios::binary).write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+
+	ASSERT_TRUE(trace.loadBinary<schema_t>(binaryPath.c_str(), 0));
+	EXPECT_FLOAT_EQ(trace.valueAt(1999), 22.25f);
+	EXPECT_FLOAT_EQ(trace.valueAt(2000), 23.5f);
+	ASSERT_TRUE(trace.loadBinary<schema_t>(binaryPath.c_str(), 1));
+	EXPECT_FLOAT_EQ(trace.valueAt(2000), 57.0f);
+	EXPECT_FALSE(trace.loadBinary<processingManager<countingSensor>::schema_t>(binaryPath.c_str(), 0));
+	std::remove(binaryPath.c_str());
+
+	// The replay time runs faster than real time, or is stepped by hand
+	sensorSimulator::setReplaySpeed(3600.0f);
+	uint64_t start = sensorSimulator::getReplayTimeMs();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_GE(sensorSimulator::getReplayTimeMs() - start, 36000u);
+	sensorSimulator::setReplaySpeed(0.0f);
+
+	// The mocks convert their signals at the replay time
+	ADC::ADS1115 loggerADC;
+	signalSource volts;
+	volts.setConstant(1.25f);
+	ads1115Mock::setInputSignal(ADS1115_COMP_0_GND, &volts);
+	EXPECT_FLOAT_EQ(loggerADC.readVoltage(ADS1115_COMP_0_GND), 1.25f);
+	ads1115Mock::setInputSignal(ADS1115_COMP_0_GND, nullptr);
+	EXPECT_FLOAT_EQ(loggerADC.readVoltage(ADS1115_COMP_0_GND), 3.3f);
+
+	// A simulated hour of a daily temperature cycle goes through the processing manager in no time
+	signalSource temperature;
+	signalSource humidity;
+	shape = sensorSimulator::waveform{};
+	shape.mean		= 20.0f;
+	shape.amplitude = 5.0f;
+	temperature.setWaveform(shape, 1);
+	humidity.setConstant(104.0f);
+
+	sensor::thermometer::AHT21 loggerThermometerHygrometer;
+	virtualRTC				   rtc;
+	processingManager		   myProcessingManager(rtc, loggerThermometerHygrometer);
+
+	aht21Mock::setConversionTime(0);
+	aht21Mock::setSignals(&temperature, &humidity);
+	myProcessingManager.setCacheTtl(0);
+	myProcessingManager.setChannelPeriod(0, 1000);
+
+	// Non blocking conversions complete on the replay time too
+	for (uint64_t now = 0; now < 60 * 60 * 1000; now += 1000)
+	{
+		sensorSimulator::setReplayTime(SIGNAL_PEAK_MS - 30 * 60 * 1000 + now);
+		myProcessingManager.sampleHandler(now);
+		sensorSimulator::setReplayTime(SIGNAL_PEAK_MS - 30 * 60 * 1000 + now + AHT21_CONVERSION_TIME_MS);
+		myProcessingManager.sampleHandler(now);
+	}
+
+	myProcessingManager.startMeasurements(60 * 60 * 1000);
+	sensorSimulator::setReplayTime(SIGNAL_PEAK_MS + 30 * 60 * 1000 + AHT21_CONVERSION_TIME_MS);
+	EXPECT_TRUE(myProcessingManager.measurementsReady(60 * 60 * 1000));
+
+	const statistics::summary& channel = myProcessingManager.getChannelStatistics(0);
+	EXPECT_EQ(channel.count, 3600u);
+	EXPECT_NEAR(channel.max, 25.0f, 1e-3f);
+	EXPECT_NEAR(channel.mean, 20.0f + 5.0f * std::sin(3.14159265f / 24.0f) * 24.0f / 3.14159265f, 1e-2f);
+	EXPECT_FLOAT_EQ(myProcessingManager.getRecord().values[1], 100.0f);
+
+	aht21Mock::setSignals(nullptr, nullptr);
+	aht21Mock::setConversionTime(AHT21_CONVERSION_TIME_MS);
+	sensorSimulator::setReplaySpeed(1.0f);
+}
+
+TEST(sensors, testSampleRing)
+{
+	using sensorSimulator::sample;
+	using sensorSimulator::sampleChannel;
+	using sensorSimulator::sampleRing;
+
+	constexpr uint32_t	  capacity = 64;
+	std::vector<uint64_t> region(sampleRing::regionSize(capacity) / sizeof(uint64_t));
+
+	sampleRing producer = sampleRing::create(region.data(), capacity);
+	sampleRing consumer = sampleRing::attach(region.data(), sampleRing::regionSize(capacity));
+	ASSERT_TRUE(consumer.isValid());
+	EXPECT_FALSE(sampleRing::attach(region.data(), sampleRing::regionSize(capacity) - 1).isValid());
+
+	// Every sample is drained once, oldest first
+	std::array<sample, 2 * capacity> samples;
+	producer.push({1000, sampleChannel::RAIN, 1.0f});
+	producer.push({1001, sampleChannel::WIND_SPEED, 3.0f});
+	producer.push({1002, sampleChannel::WIND_DIRECTION, 1.65f});
+
+	ASSERT_EQ(consumer.drain(samples), 3u);
+	EXPECT_EQ(samples[0].timestampMs, 1000u);
+	EXPECT_EQ(samples[1].channel, sampleChannel::WIND_SPEED);
+	EXPECT_FLOAT_EQ(samples[2].value, 1.65f);
+	EXPECT_EQ(consumer.drain(samples), 0u);
+
+	// A burst longer than the ring keeps the newest samples and counts the others
+	for (uint64_t index = 0; index < capacity + 5; index++)
+	{
+		producer.push({index, sampleChannel::RAIN, 1.0f});
+	}
+
+	EXPECT_EQ(consumer.drain(std::span<sample>(samples).first(10)), 10u);
+	EXPECT_EQ(samples[0].timestampMs, 5u);
+	EXPECT_EQ(consumer.drain(samples), capacity - 10);
+	EXPECT_EQ(consumer.getLost(), 5u);
+
+	// A concurrent producer laps the consumer, the samples drained are never torn
+	constexpr uint64_t numSamples = 200000;
+
+	auto produce = [&]()
+	{
+		for (uint64_t index = 0; index < numSamples; index++)
+		{
+			producer.push({index, static_cast<sampleChannel>(index % 3), static_cast<float>(index % 1000)});
+		}
+	};
+
+	std::thread producerThread(produce);
+
+	uint64_t lostBefore = consumer.getLost();
+	uint64_t received	= 0;
+	uint64_t torn		= 0;
+	uint64_t reordered	= 0;
+	uint64_t last		= 0;
+
+	while (received + consumer.getLost() - lostBefore < numSamples)
+	{
+		size_t count = consumer.drain(samples);
+
+		for (size_t index = 0; index < count; index++)
+		{
+			const sample& value = samples[index];
+
+			torn	  += (value.channel != static_cast<sampleChannel>(value.timestampMs % 3) || value.value != static_cast<float>(value.timestampMs % 1000)) ? 1 : 0;
+			reordered += (received > 0 && value.timestampMs <= last) ? 1 : 0;
+			last	   = value.timestampMs;
+			received++;
+		}
+	}
+	producerThread.join();
+
+	EXPECT_EQ(torn, 0u);
+	EXPECT_EQ(reordered, 0u);
+	EXPECT_EQ(received + consumer.getLost() - lostBefore, numSamples);
+	EXPECT_EQ(last, numSamples - 1);
+	RecordProperty("samplesDrained", static_cast<int>(received));
+	RecordProperty("samplesLost", static_cast<int>(consumer.getLost() - lostBefore));
+}
+
+namespace
+{
+// Channel tables declared apart from any sensor, to compare the hashes of their layouts
+constexpr std::array<sensor::channelInfo, 2> thermometerLayout = {{{"temperature", "degC", 2, sensor::fieldType::INT16}, {"humidity", "%RH", 0, sensor::fieldType::UINT8}}};
+constexpr std::array<sensor::channelInfo, 2> swappedLayout	   = {{{"humidity", "%RH", 0, sensor::fieldType::UINT8}, {"temperature", "degC", 2, sensor::fieldType::INT16}}};
+constexpr std::array<sensor::channelInfo, 2> decimalsLayout	   = {{{"temperature", "degC", 1, sensor::fieldType::INT16}, {"humidity", "%RH", 0, sensor::fieldType::UINT8}}};
+constexpr std::array<sensor::channelInfo, 2> typeLayout		   = {{{"temperature", "degC", 2, sensor::fieldType::INT32}, {"humidity", "%RH", 0, sensor::fieldType::UINT8}}};
+constexpr std::array<sensor::channelInfo, 2> unitLayout		   = {{{"temperature", "degF", 2, sensor::fieldType::INT16}, {"humidity", "%RH", 0, sensor::fieldType::UINT8}}};
+} // namespace
+
+TEST(processingSubsystem, testRecordSchema)
+{
+	using schema_t = processingManager<sensor::thermometer::AHT21>::schema_t;
+
+	// Timestamp, temperature as int16 and humidity as uint8
+	static_assert(11 == schema_t::BINARY_RECORD_SIZE);
+	static_assert(8 == schema_t::BINARY_OFFSETS[0] && 10 == schema_t::BINARY_OFFSETS[1]);
+
+	// The hash follows the layout, not the sensor set: an identical table declared elsewhere hashes the same
+	static_assert(schema_t::HASH == schema::recordSchema<thermometerLayout>::HASH);
+
+	// Any change of the layout changes the hash
+	static_assert(schema_t::HASH != schema::recordSchema<swappedLayout>::HASH);
+	static_assert(schema_t::HASH != schema::recordSchema<decimalsLayout>::HASH);
+	static_assert(schema_t::HASH != schema::recordSchema<typeLayout>::HASH);
+	static_assert(schema_t::HASH != schema::recordSchema<unitLayout>::HASH);
+	static_assert(schema_t::HASH != processingManager<sensor::thermometer::AHT21, sensor::davisPluviometer>::schema_t::HASH);
+	static_assert(processingManager<sensor::davisPluviometer>::schema_t::HASH != processingManager<sensor::anemometerDavis>::schema_t::HASH);
+
+	std::array<char, 256> text;
+	char				  hash[9];
+	std::snprintf(hash, sizeof(hash), "%08x", static_cast<unsigned>(schema_t::HASH));
+
+	ASSERT_GT(schema_t::writeCsvHeader(text), 0u);
+	EXPECT_EQ(std::string(text.data()), std::string("#schema=") + hash + "\ntime;temperature[degC];humidity[%RH]\n");
+
+	schema_t::record_t record{1744979696789ull, {-5.256f, 45.0f}, {1744979696800ull, 1744979696900ull}};
+
+	ASSERT_GT(schema_t::writeCsvLine(record, text), 0u);
+	EXPECT_STREQ(text.data(), "12:34:56.789-18/04/2025;-5.26;45\n");
+
+	ASSERT_GT(schema_t::writeJson(record, text), 0u);
+	EXPECT_EQ(std::string(text.data()).find(std::string("{\"schema\":\"") + hash + "\""), 0u);
+
+	// Binary round trip, values keep the channel decimals
+	std::array<uint8_t, BINARY_FILE_HEADER_SIZE + schema_t::BINARY_RECORD_SIZE> binary;
+
+	ASSERT_EQ(schema_t::writeBinaryHeader(binary), BINARY_FILE_HEADER_SIZE);
+	EXPECT_TRUE(schema_t::checkBinaryHeader(binary));
+	EXPECT_FALSE(processingManager<sensor::davisPluviometer>::schema_t::checkBinaryHeader(binary));
+
+	std::span<uint8_t> payload = std::span(binary).subspan(BINARY_FILE_HEADER_SIZE);
+	ASSERT_EQ(schema_t::encode(record, payload), schema_t::BINARY_RECORD_SIZE);
+	EXPECT_EQ(payload[8], 0xF2); // -526 little endian
+	EXPECT_EQ(payload[9], 0xFD);
+	EXPECT_EQ(payload[10], 45);
+
+	schema_t::record_t decoded{};
+	ASSERT_TRUE(schema_t::decode(payload, decoded));
+	EXPECT_EQ(decoded.timestampMs, record.timestampMs);
+	EXPECT_FLOAT_EQ(decoded.values[0], -5.26f);
+	EXPECT_FLOAT_EQ(decoded.values[1], 45.0f);
+	EXPECT_FALSE(schema_t::decode(payload.first(schema_t::BINARY_RECORD_SIZE - 1), decoded));
+
+	// Out of range values saturate, a failed humidity read stays 255
+	record.values = {500.0f, 300.0f};
+	schema_t::encode(record, payload);
+	schema_t::decode(payload, decoded);
+	EXPECT_FLOAT_EQ(decoded.values[0], 327.67f);
+	EXPECT_FLOAT_EQ(decoded.values[1], 255.0f);
+
+	// A new log file starts with the header
+	virtualRTC				   rtc;
+	sensor::thermometer::AHT21 loggerThermometerHygrometer;
+	processingManager		   myProcessingManager(rtc, loggerThermometerHygrometer);
+	loggerManager			   myLoggerManager;
+	loggerMetadata*			   pLoggerMetadata = getLoggerMetadata();
+	std::string				   loggerName	   = pLoggerMetadata->loggerName;
+
+	pLoggerMetadata->fileCreationPeriod = loggerMetadataConstants::CREATE_ONLY_ONE_FILE;
+	std::snprintf(pLoggerMetadata->loggerName, sizeof(pLoggerMetadata->loggerName), "schemaTest");
+	std::string fileName = utilities::getPathMetadata(pLoggerMetadata->loggerName);
+	std::remove(fileName.c_str());
+
+	myProcessingManager.setObserver(&myLoggerManager);
+	ASSERT_TRUE(myLoggerManager.init());
+	myLoggerManager.setMailBox(myProcessingManager.getSensorInfoBuff());
+	myLoggerManager.setHeader(myProcessingManager.getCsvHeader());
+
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.formatData();
+	myProcessingManager.notifyObservers();
+	myLoggerManager.handler();
+	myLoggerManager.init();
+
+	std::ifstream logFile(fileName);
+	std::string	  contents((std::istreambuf_iterator<char>(logFile)), std::istreambuf_iterator<char>());
+
+	EXPECT_EQ(contents, std::string(myProcessingManager.getCsvHeader()) + myProcessingManager.getSensorInfoBuff());
+
+	std::remove(fileName.c_str());
+	std::snprintf(pLoggerMetadata->loggerName, sizeof(pLoggerMetadata->loggerName), "%s", loggerName.c_str());
+}
+
+TEST(loggerSubsystem, testWritingExternal)
+{
+	std::string							fileName;
+	std::string							lastLine;
+	fileSysWrapper						fileSystem(0, ioTag_t::LOGGER); // Use the non-microcontroller implementation
+	loggerMetadata*						pLoggerMetadata;
+	virtualRTC							rtc;
+	ADC::ADS1115						loggerADC;
+	sensor::davisPluviometer			loggerPluviometer;
+	sensor::anemometerDavis				loggerAnemometer;
+	sensor::windVaneDavis<ADC::ADS1115> loggerWindVane(loggerADC);
+	sensor::thermometer::AHT21			loggerThermometerHygrometer;
+	processingManager myProcessingManager(rtc, loggerThermometerHygrometer);
+
+	loggerManager myLoggerManager;
+	const char*	  testBuff = "123,125y3,23534if";
+	char		  timeStamp[20];
+	char		  finalTestBuff[100];
+	char		  storedData[56] = {0};
+
+	pLoggerMetadata						= getLoggerMetadata();
+	pLoggerMetadata->fileCreationPeriod = loggerMetadataConstants::CREATE_ONLY_ONE_FILE;
+
+	// Set observer and simulate processing of sensor data
+	myProcessingManager.setObserver(&myLoggerManager);
+
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.formatData();
+	myProcessingManager.notifyObservers();
+
+	// loggerManager handler
+	myLoggerManager.init();
+	myLoggerManager.setMailBox(myProcessingManager.getSensorInfoBuff());
+	myLoggerManager.handler();
+	myLoggerManager.flush();
+
+	// Read simulated file in "external device"
+	fileName = utilities::getPathMetadata(pLoggerMetadata->loggerName);
+	lastLine = utilities::getLastLine(fileName);
+
+	EXPECT_STREQ(myProcessingManager.getSensorInfoBuff(), lastLine.c_str());
+	EXPECT_TRUE(true);
+}
+
+TEST(loggerSubsystem, testMirroredReplication)
+{
+	std::string							fileName;
+	std::string							lastLine;
+	loggerMetadata*						pLoggerMetadata;
+	virtualRTC							rtc;
+	sensor::thermometer::AHT21			loggerThermometerHygrometer;
+	processingManager myProcessingManager(rtc, loggerThermometerHygrometer);
+
+	loggerManager myLoggerManager;
+
+	pLoggerMetadata						= getLoggerMetadata();
+	pLoggerMetadata->fileCreationPeriod = loggerMetadataConstants::CREATE_ONLY_ONE_FILE;
+
+	myProcessingManager.setObserver(&myLoggerManager);
+	myLoggerManager.setStorageMode(storageMode_t::MIRRORED);
+	ASSERT_TRUE(myLoggerManager.init());
+	myLoggerManager.setMailBox(myProcessingManager.getSensorInfoBuff());
+
+	// Records are only committed to the journal
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.formatData();
+	myProcessingManager.notifyObservers();
+	myLoggerManager.handler();
+
+	EXPECT_GE(myLoggerManager.getPendingReplicationBytes(), std::strlen(myProcessingManager.getSensorInfoBuff()));
+
+	// A partial batch waits for the flush period
+	EXPECT_TRUE(myLoggerManager.replicationHandler());
+	EXPECT_GT(myLoggerManager.getPendingReplicationBytes(), 0u);
+
+	EXPECT_TRUE(myLoggerManager.replicationHandler(true));
+	EXPECT_EQ(myLoggerManager.getPendingReplicationBytes(), 0u);
+
+	fileName = utilities::getPathMetadata(pLoggerMetadata->loggerName);
+	lastLine = utilities::getLastLine(fileName);
+
+	EXPECT_STREQ(myProcessingManager.getSensorInfoBuff(), lastLine.c_str());
+
+	// The persisted cursor is restored, nothing is replicated twice
+	ASSERT_TRUE(myLoggerManager.init());
+	EXPECT_EQ(myLoggerManager.getPendingReplicationBytes(), 0u);
+
+	myLoggerManager.setStorageMode(storageMode_t::EXTERNAL_ONLY);
+}
+
+TEST(loggerSubsystem, testJournalCap)
+{
+	fileSysWrapper internalFs(0, ioTag_t::LOGGER);
+	fileSysWrapper externalFs(0, ioTag_t::LOGGER);
+	storageMirror  mirror(internalFs, externalFs);
+	std::string	   journalPath	   = utilities::getPathMetadata("journalCap.jnl");
+	std::string	   cursorPath	   = utilities::getPathMetadata("journalCap.cur");
+	std::string	   externalPath	   = utilities::getPathMetadata("journalCap.csv");
+	std::string	   calibrationPath = utilities::getPathMetadata("chunk.cal");
+	std::string	   scratchPath	   = utilities::getPathMetadata("chunk.tmp");
+	std::string	   record(4000, 'x');
+
+	std::remove(journalPath.c_str());
+	std::remove(cursorPath.c_str());
+	std::remove(externalPath.c_str());
+	mirror.calibrate(calibrationPath.c_str(), scratchPath.c_str());
+	ASSERT_TRUE(mirror.init(journalPath.c_str(), cursorPath.c_str(), externalPath.c_str()));
+
+	// Without replication the journal fills up to the cap, then new records are dropped
+	uint32_t committed = 0;
+
+	while (true == mirror.commit(record.c_str(), record.size()))
+	{
+		committed++;
+	}
+
+	EXPECT_EQ(committed, MIRROR_JOURNAL_MAX_SIZE / record.size());
+	EXPECT_LE(mirror.getPendingBytes(), MIRROR_JOURNAL_MAX_SIZE);
+	EXPECT_FALSE(mirror.commit(record.c_str(), record.size()));
+	EXPECT_EQ(mirror.getDroppedRecords(), 2u);
+
+	// The oldest records are the ones replicated, then the compacted journal accepts records again
+	EXPECT_TRUE(mirror.replicate(true));
+	EXPECT_EQ(mirror.getPendingBytes(), 0u);
+	EXPECT_TRUE(mirror.commit(record.c_str(), record.size()));
+	EXPECT_EQ(mirror.getPendingBytes(), record.size());
+
+	std::remove(journalPath.c_str());
+	std::remove(cursorPath.c_str());
+	std::remove(externalPath.c_str());
+}
+
+TEST(platform, testIoAccounting)
+{
+	loggerMetadata*			   pLoggerMetadata;
+	virtualRTC				   rtc;
+	sensor::thermometer::AHT21 loggerThermometerHygrometer;
+	processingManager myProcessingManager(rtc, loggerThermometerHygrometer);
+
+	loggerManager myLoggerManager;
+	char		  readBuff[16];
+
+	pLoggerMetadata						= getLoggerMetadata();
+	pLoggerMetadata->fileCreationPeriod = loggerMetadataConstants::CREATE_ONLY_ONE_FILE;
+
+	myProcessingManager.setObserver(&myLoggerManager);
+	ASSERT_TRUE(myLoggerManager.init());
+	myLoggerManager.setMailBox(myProcessingManager.getSensorInfoBuff());
+
+	ioAccounting::reset();
+
+	// Logger writes are accounted to the logger tag only
+	myProcessingManager.takeMeasurements();
+	myProcessingManager.formatData();
+	myProcessingManager.notifyObservers();
+	myLoggerManager.handler();
+	myLoggerManager.flush();
+
+	const ioCounters_t& loggerCounters = ioAccounting::getCounters(ioTag_t::LOGGER);
+
+	EXPECT_GE(loggerCounters.opens, 1u);
+	EXPECT_GE(loggerCounters.writes, 1u);
+	EXPECT_GE(loggerCounters.syncs, 1u);
+	EXPECT_EQ(loggerCounters.bytesWritten, std::strlen(myProcessingManager.getSensorInfoBuff()));
+	EXPECT_EQ(loggerCounters.errors, 0u);
+	EXPECT_EQ(ioAccounting::getCounters(ioTag_t::METADATA).writes, 0u);
+
+	// Reads through another wrapper are accounted to its own tag
+	fileSysWrapper metadataFs(0, ioTag_t::METADATA);
+	std::string	   fileName = utilities::getPathMetadata(pLoggerMetadata->loggerName);
+
+	ASSERT_TRUE(metadataFs.mount());
+	ASSERT_TRUE(metadataFs.open(fileName.c_str(), 0));
+	EXPECT_TRUE(metadataFs.seek(0));
+	int bytesRead = metadataFs.read(readBuff, sizeof(readBuff));
+	metadataFs.close();
+
+	const ioCounters_t& metadataCounters = ioAccounting::getCounters(ioTag_t::METADATA);
+
+	EXPECT_EQ(metadataCounters.mounts, 1u);
+	EXPECT_EQ(metadataCounters.opens, 1u);
+	EXPECT_EQ(metadataCounters.seeks, 1u);
+	EXPECT_EQ(metadataCounters.closes, 1u);
+	EXPECT_EQ(metadataCounters.reads, 1u);
+	EXPECT_EQ(metadataCounters.bytesRead, static_cast<uint64_t>(bytesRead));
+
+	// A failed open is an error, not an open
+	EXPECT_FALSE(metadataFs.open("", 0));
+	EXPECT_EQ(metadataCounters.opens, 1u);
+	EXPECT_EQ(metadataCounters.errors, 1u);
+
+	ioAccounting::reset();
+	EXPECT_EQ(loggerCounters.bytesWritten, 0u);
+}
+
+TEST(platform, testOpenModes)
+{
+	const char*	   fileName = "openModes.tmp";
+	fileSysWrapper fileSystem(0, ioTag_t::LOGGER);
+	char		   readBuff[16] = {0};
+
+	std::remove(fileName);
+	EXPECT_FALSE(fileSystem.exists(fileName));
+
+	// Creating a new file fails once it exists, appending then keeps its content
+	ASSERT_TRUE(fileSystem.open(fileName, 3));
+	EXPECT_EQ(fileSystem.write("ab", 2), 2);
+	fileSystem.close();
+
+	EXPECT_TRUE(fileSystem.exists(fileName));
+	EXPECT_FALSE(fileSystem.open(fileName, 3));
+	ASSERT_TRUE(fileSystem.open(fileName, 2));
+	EXPECT_EQ(fileSystem.write("cd", 2), 2);
+	fileSystem.close();
+
+	ASSERT_TRUE(fileSystem.open(fileName, 0));
+	EXPECT_EQ(fileSystem.read(readBuff, sizeof(readBuff) - 1), 4);
+	fileSystem.close();
+	EXPECT_STREQ(readBuff, "abcd");
+
+	// Creating always truncates the existing file
+	ASSERT_TRUE(fileSystem.open(fileName, 4));
+	EXPECT_EQ(fileSystem.write("e", 1), 1);
+	fileSystem.close();
+
+	ASSERT_TRUE(fileSystem.open(fileName, 0));
+	EXPECT_EQ(fileSystem.read(readBuff, sizeof(readBuff) - 1), 1);
+	fileSystem.close();
+	EXPECT_EQ(readBuff[0], 'e');
+
+	std::remove(fileName);
+}
+
+TEST(loggerSubsystem, testWriteChunkCalibration)
+{
+	loggerManager myLoggerManager;
+	std::string	  calibrationPath = utilities::getPathMetadata("chunk.cal");
+
+	std::remove(calibrationPath.c_str());
+
+	// No calibration file, the external storage is benchmarked and the result stored, also without the mirror
+	ASSERT_TRUE(myLoggerManager.init());
+
+	uint16_t chunkSize = myLoggerManager.getWriteChunkSize();
+	EXPECT_NE(std::find(MIRROR_CHUNK_CANDIDATES.begin(), MIRROR_CHUNK_CANDIDATES.end(), chunkSize), MIRROR_CHUNK_CANDIDATES.end());
+	EXPECT_EQ(std::stoi(utilities::getLastLine(calibrationPath)), chunkSize);
+
+	// A stored result skips the benchmark
+	std::ofstream(calibrationPath) << "1024\n";
+	ioAccounting::reset();
+	ASSERT_TRUE(myLoggerManager.init());
+	EXPECT_EQ(myLoggerManager.getWriteChunkSize(), 1024u);
+	EXPECT_LT(ioAccounting::getCounters(ioTag_t::LOGGER).bytesWritten, MIRROR_CALIBRATION_BYTES);
+	EXPECT_EQ(ioAccounting::getWriteChunkSize(ioTag_t::LOGGER), 1024u);
+
+	// An invalid result is calibrated again
+	std::ofstream(calibrationPath) << "77\n";
+	ASSERT_TRUE(myLoggerManager.init());
+	EXPECT_NE(myLoggerManager.getWriteChunkSize(), 77u);
+	EXPECT_EQ(std::stoi(utilities::getLastLine(calibrationPath)), myLoggerManager.getWriteChunkSize());
+
+	// A second calibration on the same filesystem rewrites the scratch file left by the first
+	std::string	   scratchPath = utilities::getPathMetadata("chunk.tmp");
+	fileSysWrapper externalFs(0, ioTag_t::LOGGER);
+
+	ASSERT_TRUE(externalFs.exists(scratchPath.c_str()));
+	std::remove(calibrationPath.c_str());
+	ASSERT_TRUE(myLoggerManager.init());
+	EXPECT_EQ(std::stoi(utilities::getLastLine(calibrationPath)), myLoggerManager.getWriteChunkSize());
+
+	ASSERT_TRUE(externalFs.open(scratchPath.c_str(), 0));
+	EXPECT_EQ(externalFs.size(), 0);
+	externalFs.close();
+
+	// The mirror replicates with the same chunk
+	std::ofstream(calibrationPath) << "512\n";
+	myLoggerManager.setStorageMode(storageMode_t::MIRRORED);
+	ASSERT_TRUE(myLoggerManager.init());
+	EXPECT_EQ(myLoggerManager.getWriteChunkSize(), 512u);
+
+	myLoggerManager.setStorageMode(storageMode_t::EXTERNAL_ONLY);
+}
+
+TEST(loggerSubsystem, testChunkedWriting)
+{
+	loggerManager	myLoggerManager;
+	loggerMetadata* pLoggerMetadata = getLoggerMetadata();
+	std::string		loggerName		= pLoggerMetadata->loggerName;
+	std::string		calibrationPath = utilities::getPathMetadata("chunk.cal");
+	std::string		record			= std::string(99, 'x') + "\n";
+
+	pLoggerMetadata->fileCreationPeriod = loggerMetadataConstants::CREATE_ONLY_ONE_FILE;
+	std::snprintf(pLoggerMetadata->loggerName, sizeof(pLoggerMetadata->loggerName), "chunkTest");
+	std::string fileName = utilities::getPathMetadata(pLoggerMetadata->loggerName);
+	std::remove(fileName.c_str());
+
+	std::ofstream(calibrationPath) << "512\n";
+	ASSERT_TRUE(myLoggerManager.init());
+	ASSERT_EQ(myLoggerManager.getWriteChunkSize(), 512u);
+	myLoggerManager.setMailBox(record.c_str());
+
+	ioAccounting::reset();
+	const ioCounters_t& loggerCounters = ioAccounting::getCounters(ioTag_t::LOGGER);
+
+	// Records wait in memory until a full chunk can be written
+	for (int index = 0; index < 5; index++)
+	{
+		myLoggerManager.handler();
+	}
+
+	EXPECT_EQ(loggerCounters.writes, 0u);
+	EXPECT_EQ(myLoggerManager.getPendingReplicationBytes(), 500u);
+
+	// The record completing the chunk writes exactly one chunk, its remainder waits for the next
+	myLoggerManager.handler();
+
+	EXPECT_EQ(loggerCounters.writes, 1u);
+	EXPECT_EQ(loggerCounters.syncs, 1u);
+	EXPECT_EQ(loggerCounters.bytesWritten, 512u);
+	EXPECT_EQ(myLoggerManager.getPendingReplicationBytes(), 88u);
+
+	// A partial chunk waits for the flush period unless forced
+	EXPECT_TRUE(myLoggerManager.replicationHandler());
+	EXPECT_EQ(myLoggerManager.getPendingReplicationBytes(), 88u);
+	EXPECT_TRUE(myLoggerManager.replicationHandler(true));
+	EXPECT_EQ(myLoggerManager.getPendingReplicationBytes(), 0u);
+
+	std::ifstream logFile(fileName);
+	std::string	  contents((std::istreambuf_iterator<char>(logFile)), std::istreambuf_iterator<char>());
+	std::string	  expected;
+
+	for (int index = 0; index < 6; index++)
+	{
+		expected += record;
+	}
+
+	EXPECT_EQ(contents, expected);
+
+	std::remove(fileName.c_str());
+	std::snprintf(pLoggerMetadata->loggerName, sizeof(pLoggerMetadata->loggerName), "%s", loggerName.c_str());
+}